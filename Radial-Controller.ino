@@ -10,7 +10,9 @@
 #endif
 
 #include "src/CdcRadial/USBCDC.h"
+#include "src/CdcRadial/USBFrame.h"
 #include "src/CdcRadial/USBRadial.h"
+#include "src/CdcRadial/USBVendor.h"
 #include "src/Common.h"
 #include "src/Drivers/EC11.h"
 #include "src/Drivers/EEPROM.h"
@@ -23,6 +25,13 @@
 #define CMD_CONFIG_RESET_SETTINGS "reset_settings"
 #define CMD_CONFIG_HEARTBEAT "heartbeat"
 #define CMD_CONFIG_SAVE_SETTINGS_PREFIX CMD_CONFIG_SAVE_SETTINGS "="
+#define CMD_CONFIG_SAVE_SETTINGS_PAYLOAD 30 // 跳过 version 和 revision
+#define CMD_CONFIG_SET_PREFIX "set_" // set_<参数名>=<十进制数值>
+#define CMD_CONFIG_GET_PREFIX "get_" // get_<参数名>
+#define CMD_CONFIG_PREVIEW "preview"
+#define CMD_CONFIG_COMMIT "commit"
+#define CMD_CONFIG_REVERT "revert"
+#define CMD_CONFIG_BYTES_WRITTEN "bytes_written" // commit 之后的写入字节数应答
 #define CMD_SUCCESS_SUFFIX "_success"
 #define CMD_FAILED_SUFFIX "_failed"
 
@@ -30,37 +39,250 @@
 #define CMD_TEST_CLICK "click"
 #define CMD_TEST_ROTATE_LEFT "rotate_left"
 #define CMD_TEST_ROTATE_RIGHT "rotate_right"
+#define CMD_TEST_LATENCY "latency"
+#define CMD_TEST_POLL_STATS "poll_stats"
+#define CMD_TEST_EC11_STATS "ec11_stats"
 
-#define HEARTBEAT_TIMEOUT 4000 // 心跳超时时间
+#define HEARTBEAT_TIMEOUT 4000 // 心跳超时时间，仅用于未设置 DTR 的主机
+
+// 每次循环执行串口命令的时间预算（微秒），超出后剩余命令留到下一次循环，
+// 避免连续的命令推迟编码器与灯效处理。至少执行一条命令，可在编译选项中覆盖
+#ifndef COMMAND_TIME_BUDGET
+#define COMMAND_TIME_BUDGET 2000
+#endif
+
+// 单项参数修改后无新修改的时长达到该值才写入 EEPROM，连续调节只写一次
+#define SETTINGS_SAVE_DELAY 2000
+// 延迟写入还需等待编码器空闲该时长（毫秒），避免旋转过程中写入 DataFlash
+#define INPUT_IDLE_TIME 300
+
+#define TEST_SHOW_MENU_HOLD_TIME 500 // 模拟长按的按下保持时长
+#define TEST_CLICK_HOLD_TIME 50      // 模拟点击的按下保持时长
 
 void update_config();
+void apply_leds();
+void apply_brightness();
+void apply_rotate_interval();
+void apply_fade_duration();
+void apply_step_per_teeth();
+void apply_phase();
+void apply_hid_poll_interval();
 void process_ec11_operation();
+eeprom_status_t save_config();
 void process_heartbeat();
+void process_test_release();
+void process_vendor_config();
+void process_pending_settings();
 void process_serial_data();
 void process_commands(uint8_t *command);
+void process_frame(uint8_t *frame, uint8_t len);
+
+void enter_config_mode();
+void exit_config_mode();
+bool save_settings(const uint8_t *data);
+void reset_settings();
+void load_settings();
+void commit_settings();
+bool preview_settings(const uint8_t *data);
+bool enter_preview();
+bool commit_preview();
+void revert_settings();
+
+void cmd_config_mode_enabled(const uint8_t *arg);
+void cmd_heartbeat(const uint8_t *arg);
+void cmd_load_settings(const uint8_t *arg);
+void cmd_save_settings(const uint8_t *arg);
+void cmd_reset_settings(const uint8_t *arg);
+void cmd_set_parameter(const uint8_t *arg);
+void cmd_get_parameter(const uint8_t *arg);
+void cmd_preview(const uint8_t *arg);
+void cmd_commit(const uint8_t *arg);
+void cmd_revert(const uint8_t *arg);
+void cmd_test_show_menu(const uint8_t *arg);
+void cmd_test_click(const uint8_t *arg);
+void cmd_test_rotate_left(const uint8_t *arg);
+void cmd_test_rotate_right(const uint8_t *arg);
+void cmd_test_latency(const uint8_t *arg);
+void cmd_test_poll_stats(const uint8_t *arg);
+void cmd_test_ec11_stats(const uint8_t *arg);
+
+/**
+ * @brief 命令表条目
+ */
+typedef struct {
+    const char *name; // 命令名称
+    uint8_t length;   // 命令名称长度
+    uint8_t payload;  // "=" 之后的二进制数据长度，0 表示以换行符结束的文本命令
+    void (*handler)(const uint8_t *arg); // 处理函数，arg 指向 "=" 之后的数据
+} command_entry_t;
+
+// payload 取该值表示按名称前缀匹配的文本命令，handler 的 arg 指向前缀之后
+#define COMMAND_PREFIX 0xFF
+
+#define COMMAND_ENTRY(name, payload, handler)                                  \
+    { name, sizeof(name) - 1, payload, handler }
+
+// 命令表，以名称长度和首字符定位条目，命中后仅需一次 strcmp 确认
+__code command_entry_t command_table[] = {
+    COMMAND_ENTRY(CMD_CONFIG_MODE_ENABLED, 0, cmd_config_mode_enabled),
+    COMMAND_ENTRY(CMD_CONFIG_HEARTBEAT, 0, cmd_heartbeat),
+    COMMAND_ENTRY(CMD_CONFIG_LOAD_SETTINGS, 0, cmd_load_settings),
+    COMMAND_ENTRY(CMD_CONFIG_SAVE_SETTINGS, CMD_CONFIG_SAVE_SETTINGS_PAYLOAD,
+                  cmd_save_settings),
+    COMMAND_ENTRY(CMD_CONFIG_RESET_SETTINGS, 0, cmd_reset_settings),
+    COMMAND_ENTRY(CMD_CONFIG_SET_PREFIX, COMMAND_PREFIX, cmd_set_parameter),
+    COMMAND_ENTRY(CMD_CONFIG_GET_PREFIX, COMMAND_PREFIX, cmd_get_parameter),
+    COMMAND_ENTRY(CMD_CONFIG_PREVIEW, 0, cmd_preview),
+    COMMAND_ENTRY(CMD_CONFIG_COMMIT, 0, cmd_commit),
+    COMMAND_ENTRY(CMD_CONFIG_REVERT, 0, cmd_revert),
+
+    /* 以下为测试用命令 */
+    COMMAND_ENTRY(CMD_TEST_SHOW_MENU, 0, cmd_test_show_menu),
+    COMMAND_ENTRY(CMD_TEST_CLICK, 0, cmd_test_click),
+    COMMAND_ENTRY(CMD_TEST_ROTATE_LEFT, 0, cmd_test_rotate_left),
+    COMMAND_ENTRY(CMD_TEST_ROTATE_RIGHT, 0, cmd_test_rotate_right),
+    COMMAND_ENTRY(CMD_TEST_LATENCY, 0, cmd_test_latency),
+    COMMAND_ENTRY(CMD_TEST_POLL_STATS, 0, cmd_test_poll_stats),
+    COMMAND_ENTRY(CMD_TEST_EC11_STATS, 0, cmd_test_ec11_stats),
+};
+
+#define COMMAND_COUNT (sizeof(command_table) / sizeof(command_table[0]))
+
+/**
+ * @brief 单项配置参数表条目
+ */
+typedef struct {
+    const char *name;                      // 参数名称
+    uint8_t length;                        // 参数名称长度
+    int16_t (*get)();                      // 读取内存中的参数值
+    eeprom_status_t (*set)(int16_t value); // 校验并写入内存中的参数值
+    void (*apply)(); // 应用到受影响的模块，NULL 表示使用时直接读取配置
+} param_entry_t;
+
+// 生成参数的读写函数，数值无法无损转换为参数类型时拒绝，
+// 取值范围由 EEPROM_Set* 校验
+#define PARAM_ACCESSORS(field, type, getter, setter)                           \
+    static int16_t param_get_##field() { return (int16_t)getter(); }           \
+    static eeprom_status_t param_set_##field(int16_t value) {                  \
+        if ((int16_t)(type)value != value) {                                   \
+            return EEPROM_STATUS_INVALID_PARAM;                                \
+        }                                                                      \
+        return setter((type)value);                                            \
+    }
+
+#define PARAM_ENTRY(field, apply)                                              \
+    { #field, sizeof(#field) - 1, param_get_##field, param_set_##field, apply }
+
+PARAM_ACCESSORS(led_count, uint8_t, EEPROM_GetLedCount, EEPROM_SetLedCount)
+PARAM_ACCESSORS(color_order, uint8_t, EEPROM_GetColorOrder,
+                EEPROM_SetColorOrder)
+PARAM_ACCESSORS(brightness, uint8_t, EEPROM_GetBrightness,
+                EEPROM_SetBrightness)
+PARAM_ACCESSORS(effect_mode, uint8_t, EEPROM_GetEffectMode,
+                EEPROM_SetEffectMode)
+PARAM_ACCESSORS(rotate_interval, uint16_t, EEPROM_GetRotateEffectInterval,
+                EEPROM_SetRotateEffectInterval)
+PARAM_ACCESSORS(fade_duration, uint16_t, EEPROM_GetFadeEffectDuration,
+                EEPROM_SetFadeEffectDuration)
+PARAM_ACCESSORS(rotate_cw, int16_t, EEPROM_GetRotateCW, EEPROM_SetRotateCW)
+PARAM_ACCESSORS(rotate_ccw, int16_t, EEPROM_GetRotateCCW, EEPROM_SetRotateCCW)
+PARAM_ACCESSORS(step_per_teeth, uint8_t, EEPROM_GetStepPerTeeth,
+                EEPROM_SetStepPerTeeth)
+PARAM_ACCESSORS(phase, uint8_t, EEPROM_GetPhase, EEPROM_SetPhase)
+PARAM_ACCESSORS(hid_poll_interval, uint8_t, EEPROM_GetHidPollInterval,
+                EEPROM_SetHidPollInterval)
+
+// 参数表，名称与配置工具中的参数键名一致，以名称长度筛选条目
+__code param_entry_t param_table[] = {
+    PARAM_ENTRY(led_count, apply_leds),
+    PARAM_ENTRY(color_order, apply_leds),
+    PARAM_ENTRY(brightness, apply_brightness),
+    PARAM_ENTRY(effect_mode, NULL),
+    PARAM_ENTRY(rotate_interval, apply_rotate_interval),
+    PARAM_ENTRY(fade_duration, apply_fade_duration),
+    PARAM_ENTRY(rotate_cw, NULL),
+    PARAM_ENTRY(rotate_ccw, NULL),
+    PARAM_ENTRY(step_per_teeth, apply_step_per_teeth),
+    PARAM_ENTRY(phase, apply_phase),
+    PARAM_ENTRY(hid_poll_interval, apply_hid_poll_interval),
+};
+
+#define PARAM_COUNT (sizeof(param_table) / sizeof(param_table[0]))
+
+// 命令接收状态
+#define RECEIVE_STATE_NAME 0    // 接收命令名称，遇到换行符结束
+#define RECEIVE_STATE_PAYLOAD 1 // 接收定长二进制数据，之后的 1 字节为结束符
+#define RECEIVE_STATE_DISCARD 2 // 命令过长，丢弃至换行符
+#define RECEIVE_STATE_FRAME 3   // 接收 COBS 编码的二进制帧，遇到 0x00 结束
 
 // 接收缓冲区，用于存储从串口接收的命令
 uint8_t receive_buf[50];
 uint8_t receive_ptr = 0;
-bool data_received = false;
+uint8_t receive_state = RECEIVE_STATE_NAME;
+uint8_t receive_remaining = 0; // 剩余待接收的二进制数据长度
+__code command_entry_t *receive_command = NULL; // 已接收命令对应的命令表条目
+bool receive_framed = false;   // 已接收的是二进制帧而非 ASCII 命令
+bool receive_overflow = false; // 二进制帧过长，丢弃至分隔符
+
+// 二进制帧应答缓冲区
+__xdata uint8_t frame_response[FRAME_DECODED_MAX];
 
 // 上一次编码器旋转方向
 ec11_direction_t last_direction = EC11_DIR_CW;
 
+// 最后一次报告编码器旋转或按键的时间戳
+uint32_t input_last_time = 0;
+
 // 是否为配置模式
 bool is_config_mode = false;
 
-// 心跳检测相关变量
+// 主机在线检测相关变量
+bool config_by_dtr = false; // 进入配置模式时 DTR 有效，以 DTR 判断主机在线
 uint32_t heartbeat_last_received = 0; // 最后一次收到心跳的时间戳
 
-void setup() {
-    USBInit();
+// 单项参数修改后的延迟保存
+bool settings_dirty = false;        // 内存中的配置有尚未写入 EEPROM 的修改
+uint32_t settings_changed_time = 0; // 最后一次修改的时间戳
+
+// 预览模式：配置只应用到内存和驱动，commit 时才写入 EEPROM
+bool is_preview_mode = false;
+uint16_t session_bytes_start = 0; // 本次调节开始时的 EEPROM 写入字节数
+__xdata uint8_t preview_backup[CMD_CONFIG_SAVE_SETTINGS_PAYLOAD]; // 无效时恢复
+__xdata int16_t preview_values[PARAM_COUNT]; // 用于找出发生变化的参数
+
+// 测试命令模拟按钮按下后的定时释放
+bool test_release_pending = false; // 是否等待释放按钮
+uint32_t test_press_time = 0;      // 模拟按下的时间戳
+uint16_t test_hold_time = 0;       // 模拟按下的保持时长
 
+#if EC11_SAMPLE_MODE != EC11_SAMPLE_POLLING
+/**
+ * @brief 定时器 2 中断服务函数，推进 EC11 旋转事件时钟，定时器采样方式下
+ *        同时以固定频率采样编码器
+ * @note SDCC 要求中断服务函数在 main 所在的编译单元可见，因此定义在此处
+ */
+void Timer2Interrupt(void) __interrupt(INT_NO_TMR2) { EC11_TimerInterrupt(); }
+#endif
+
+#if EC11_SAMPLE_MODE == EC11_SAMPLE_INTERRUPT
+/**
+ * @brief GPIO 中断服务函数，在 EC11 编码器 B 相下降沿解码旋转
+ * @note A 相使用的外部中断由 attachInterrupt 注册，GPIO 中断需定义在此处
+ */
+void GpioInterrupt(void) __interrupt(INT_NO_GPIO) { EC11_GpioInterrupt(); }
+#endif
+
+void setup() {
     // 从 EEPROM 读取配置参数
     EEPROM_LoadConfig();
 
+    // 枚举前确定 HID 端点轮询间隔
+    Radial_SetPollInterval(EEPROM_GetHidPollInterval());
+
+    USBInit();
+
     // 初始化 EC11 编码器
-    EC11_Init(EC11_PIN_A, EC11_PIN_B, EC11_PIN_K);
+    EC11_Init();
 
     // 执行配置初始化
     update_config();
@@ -69,16 +291,15 @@ void setup() {
 void loop() {
     process_serial_data();
 
-    if (data_received) {
-        process_commands(receive_buf);
+    process_vendor_config();
 
-        receive_ptr = 0;
-        data_received = false;
-    }
+    process_pending_settings();
 
+    process_test_release();
+
+    // 配置模式不独占主循环，编码器与灯效照常处理
     if (is_config_mode) {
         process_heartbeat();
-        return;
     }
 
     process_ec11_operation();
@@ -99,25 +320,64 @@ void loop() {
  * @brief 配置更新后执行的初始化操作
  */
 void update_config() {
-    // 设置 EC11 编码器转动一齿触发次数
-    EC11_SetStepPerTeeth(EEPROM_GetStepPerTeeth());
+    apply_step_per_teeth();
+    apply_phase();
+
+    // 设置 EC11 编码器旋转加速度曲线
+    EC11_SetAccelCurve(EEPROM_GetAccelCurve());
 
-    // 设置 EC11 编码器相位
-    EC11_SetPhase(EEPROM_GetPhase());
+    apply_hid_poll_interval();
+    apply_leds();
+}
 
-    // 重新初始化 WS2812 LED
+/**
+ * @brief 重新初始化 WS2812 LED 并应用全部灯效参数
+ * @note WS2812_Init 会将亮度和灯效参数恢复为默认值，因此需一并重新设置
+ */
+void apply_leds() {
     WS2812_Init(WS2812_PIN, EEPROM_GetLedCount(), EEPROM_GetColorOrder());
 
-    // 设置 WS2812 LED 亮度
-    WS2812_SetBrightness(EEPROM_GetBrightness());
+    apply_brightness();
+    apply_rotate_interval();
+    apply_fade_duration();
+}
+
+/**
+ * @brief 设置 WS2812 LED 亮度
+ */
+void apply_brightness() { WS2812_SetBrightness(EEPROM_GetBrightness()); }
 
-    // 设置 LED 流动灯效触发间隔
+/**
+ * @brief 设置 LED 流动灯效触发间隔
+ */
+void apply_rotate_interval() {
     WS2812_SetRotateEffectInterval(EEPROM_GetRotateEffectInterval());
+}
 
-    // 设置 LED 渐变灯效持续时长
+/**
+ * @brief 设置 LED 渐变灯效持续时长
+ */
+void apply_fade_duration() {
     WS2812_SetFadeEffectDuration(EEPROM_GetFadeEffectDuration());
 }
 
+/**
+ * @brief 设置 EC11 编码器转动一齿触发次数
+ */
+void apply_step_per_teeth() { EC11_SetStepPerTeeth(EEPROM_GetStepPerTeeth()); }
+
+/**
+ * @brief 设置 EC11 编码器相位
+ */
+void apply_phase() { EC11_SetPhase(EEPROM_GetPhase()); }
+
+/**
+ * @brief 设置 HID 端点轮询间隔，重新连接设备后生效
+ */
+void apply_hid_poll_interval() {
+    Radial_SetPollInterval(EEPROM_GetHidPollInterval());
+}
+
 /**
  * @brief 处理 EC11 编码器操作
  */
@@ -125,44 +385,110 @@ void process_ec11_operation() {
     // 更新 EC11 编码器状态
     EC11_UpdateStatus();
 
-    // 处理编码器旋转
-    ec11_direction_t direction = EC11_GetDirection();
+    // 处理编码器旋转，依次取出缓冲区中积压的全部旋转事件并按旋钮累加角度
+    ec11_direction_t direction;
+    uint8_t index;
+    int16_t degrees[EC11_COUNT] = {0};
+    uint16_t input_time[EC11_COUNT]; // 累计角度中最早一次旋转事件的时间戳
 
-    // 更新方向状态
-    if (direction != EC11_DIR_NONE && direction != last_direction) {
+    while ((direction = EC11_GetDirection(&index)) != EC11_DIR_NONE) {
+        // 更新方向状态
         last_direction = direction;
-    }
 
-    if (direction == EC11_DIR_CW) {
-        // 顺时针旋转，发送正值，单位：度
-        Radial_SendData(0, EEPROM_GetRotateCW());
-    } else if (direction == EC11_DIR_CCW) {
-        // 逆时针旋转，发送负值，单位：度
-        Radial_SendData(0, EEPROM_GetRotateCCW());
+        if (degrees[index] == 0) {
+            input_time[index] = EC11_GetEventTime(index);
+        }
+
+        // 顺时针旋转为正值，逆时针旋转为负值，单位：度
+        degrees[index] += EC11_ApplyAccel(index, direction == EC11_DIR_CW
+                                                     ? EEPROM_GetRotateCW()
+                                                     : EEPROM_GetRotateCCW());
+
+        // 单次报告最多 360 度，超出部分先行发送
+        while (degrees[index] >= 360 || degrees[index] <= -360) {
+            Radial_SetInputTime(input_time[index]);
+            Radial_SendData(index, 0, degrees[index] > 0 ? 360 : -360);
+            degrees[index] += degrees[index] > 0 ? -360 : 360;
+        }
     }
 
-    // 处理编码器按键
-    if (EC11_IsKeyChanged()) {
-        ec11_key_state_t key_state = EC11_GetKeyState();
+    for (index = 0; index < EC11_COUNT; index++) {
+        if (degrees[index] != 0) {
+            Radial_SetInputTime(input_time[index]);
+            Radial_SendData(index, 0, degrees[index]);
+            input_last_time = millis();
+        }
+
+        // 识别到的按键手势通过端点1 通知主机
+        ec11_key_gesture_t gesture = EC11_GetKeyGesture(index);
+        if (gesture != EC11_GESTURE_NONE) {
+            USBSerial_notify(CDC_EVENT_KEY_GESTURE, (index << 4) | gesture);
+        }
+
+        // 处理编码器按键
+        if (EC11_IsKeyChanged(index)) {
+            input_last_time = millis();
+            Radial_SetInputTime((uint16_t)input_last_time);
 
-        if (key_state == EC11_KEY_PRESSED) {
-            Radial_SendData(1, 0);     // 按键按下
-            WS2812_SetFadeOutEffect(); // 渐暗效果
-        } else {
-            Radial_SendData(0, 0);    // 按键释放
-            WS2812_SetFadeInEffect(); // 渐亮效果
+            if (EC11_GetKeyState(index) == EC11_KEY_PRESSED) {
+                Radial_SendData(index, 1, 0); // 按键按下
+                WS2812_SetFadeOutEffect();    // 渐暗效果
+            } else {
+                Radial_SendData(index, 0, 0); // 按键释放
+                WS2812_SetFadeInEffect();     // 渐亮效果
+            }
         }
     }
 }
 
 /**
- * @brief 处理心跳包命令
+ * @brief 先报告已缓冲的编码器输入，再将配置写入 EEPROM
+ * @details 写入 DataFlash 期间主循环无法处理编码器，先取出积压的旋转与
+ *          按键事件并发送报告，写入完成后的下一次循环继续处理。
+ *          配置无效时直接返回，不处理编码器输入。
+ *          写入结果通过端点1 通知主机
+ * @return 操作状态
+ */
+eeprom_status_t save_config() {
+    uint16_t written = EEPROM_GetBytesWritten();
+    eeprom_status_t status;
+
+    // 配置无效时不处理编码器输入，避免按无效的旋转角度换算积压的旋转事件
+    if (EEPROM_Validate() != EEPROM_STATUS_OK) {
+        USBSerial_notify(CDC_EVENT_ERROR, CDC_ERROR_INVALID_CONFIG);
+        return EEPROM_STATUS_INVALID_PARAM;
+    }
+
+    process_ec11_operation();
+
+    status = EEPROM_SaveConfig();
+    if (status == EEPROM_STATUS_OK) {
+        written = EEPROM_GetBytesWritten() - written;
+        USBSerial_notify(CDC_EVENT_SAVE_COMPLETE,
+                         written > 0xFF ? 0xFF : written);
+    } else if (status == EEPROM_STATUS_INVALID_PARAM) {
+        USBSerial_notify(CDC_EVENT_ERROR, CDC_ERROR_INVALID_CONFIG);
+    } else {
+        USBSerial_notify(CDC_EVENT_ERROR, CDC_ERROR_SAVE_FAILED);
+    }
+
+    return status;
+}
+
+/**
+ * @brief 检测配置模式下主机是否在线
+ * @details 主机关闭串口（DTR 释放）、总线复位或挂起时立即退出配置模式。
+ *          进入配置模式时 DTR 无效的主机改用心跳检测，超时后退出
  */
 void process_heartbeat() {
-    if (millis() - heartbeat_last_received >= HEARTBEAT_TIMEOUT) {
-        // 心跳超时，退出配置模式
-        is_config_mode = false;
-        heartbeat_last_received = 0; // 重置心跳时间戳
+    if (USBSerial_takeHostLost()) {
+        exit_config_mode(); // 串口已关闭，无需应答
+        return;
+    }
+
+    if (!config_by_dtr &&
+        millis() - heartbeat_last_received >= HEARTBEAT_TIMEOUT) {
+        exit_config_mode();
 
         USBSerial_println(CMD_CONFIG_MODE_TIMEOUT);
         USBSerial_flush();
@@ -170,51 +496,258 @@ void process_heartbeat() {
 }
 
 /**
- * @brief 处理串口数据
+ * @brief 到达保持时长后释放测试命令模拟按下的按钮
  */
-void process_serial_data() {
-    bool is_save_command = false;
+void process_test_release() {
+    if (test_release_pending && millis() - test_press_time >= test_hold_time) {
+        test_release_pending = false;
 
-    while (USBSerial_available()) {
-        uint8_t serial_char = USBSerial_read();
+        // 执行按钮释放动作
+        Radial_SendData(0, 0, 0); // dial=0, button=0(释放), degree=0(无旋转)
+    }
+}
 
-        // 针对 save_settings 命令的特殊处理
-        if (receive_ptr >= strlen(CMD_CONFIG_SAVE_SETTINGS_PREFIX)) {
-            is_save_command =
-                (memcmp(receive_buf, CMD_CONFIG_SAVE_SETTINGS_PREFIX,
-                        strlen(CMD_CONFIG_SAVE_SETTINGS_PREFIX)) == 0);
-        }
+/**
+ * @brief 保存主机通过 USB 厂商控制请求写入的配置参数
+ * @note 与 save_settings 命令相同，跳过前 2 字节（version 和 revision）
+ */
+void process_vendor_config() {
+    const __xdata uint8_t *data = Vendor_TakeConfig();
+
+    if (data == NULL) {
+        return;
+    }
+
+    if (save_settings(data + 2)) {
+        Vendor_SetStatus(VENDOR_STATUS_OK);
+    } else {
+        Vendor_SetStatus(VENDOR_STATUS_INVALID);
+    }
+}
+
+/**
+ * @brief 单项参数修改后无新修改的时长达到延迟且编码器空闲时写入 EEPROM
+ */
+void process_pending_settings() {
+    if (settings_dirty &&
+        millis() - settings_changed_time >= SETTINGS_SAVE_DELAY &&
+        millis() - input_last_time >= INPUT_IDLE_TIME) {
+        commit_settings();
+    }
+}
 
-        if (is_save_command) {
-            receive_buf[receive_ptr] = serial_char;
-            receive_ptr++;
+/**
+ * @brief 在命令表中查找接收缓冲区中的命令名称
+ * @details 前缀命令只需接收内容以其名称开头，其余命令需名称完全一致
+ * @param length 命令名称长度
+ * @return 命令表条目，未找到返回 NULL
+ */
+__code command_entry_t *find_command(uint8_t length) {
+    receive_buf[length] = '\0';
+
+    for (uint8_t i = 0; i < COMMAND_COUNT; i++) {
+        __code command_entry_t *entry = &command_table[i];
 
-            // save_settings=命令格式：14字节前缀 + 30字节数据 + 1字节换行符
-            if (receive_ptr >=
-                strlen(CMD_CONFIG_SAVE_SETTINGS_PREFIX) + 30 + 1) {
-                receive_buf[receive_ptr] = '\0';
-                data_received = true;
-                break;
+        if (entry->name[0] != receive_buf[0]) {
+            continue;
+        }
+
+        if (entry->payload == COMMAND_PREFIX) {
+            if (length > entry->length &&
+                memcmp(receive_buf, entry->name, entry->length) == 0) {
+                return entry;
             }
+        } else if (entry->length == length &&
+                   strcmp((const char *)receive_buf, entry->name) == 0) {
+            return entry;
         }
-        // 对于其他命令，使用换行符或回车符作为结束标记
-        else if ((serial_char == '\n') || (serial_char == '\r')) {
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief 在参数表中查找参数名称
+ * @param name 参数名称，无需以 '\0' 结尾
+ * @param length 参数名称长度
+ * @return 参数表条目，未找到返回 NULL
+ */
+__code param_entry_t *find_param(const uint8_t *name, uint8_t length) {
+    for (uint8_t i = 0; i < PARAM_COUNT; i++) {
+        __code param_entry_t *entry = &param_table[i];
+
+        if (entry->length == length &&
+            memcmp(name, entry->name, length) == 0) {
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief 解析以 '\0' 结尾的十进制整数，可带负号
+ * @param text 数值字符串
+ * @param value 解析结果
+ * @return 格式正确且在 int16_t 范围内返回 true
+ */
+bool parse_int16(const uint8_t *text, int16_t *value) {
+    bool negative = (*text == '-');
+    int32_t result = 0;
+
+    if (negative) {
+        text++;
+    }
+
+    if (*text == '\0') {
+        return false;
+    }
+
+    for (; *text != '\0'; text++) {
+        if (*text < '0' || *text > '9') {
+            return false;
+        }
+
+        result = result * 10 + (*text - '0');
+        if (result > 32768) {
+            return false;
+        }
+    }
+
+    if (negative) {
+        result = -result;
+    }
+    if (result > 32767) {
+        return false;
+    }
+
+    *value = (int16_t)result;
+    return true;
+}
+
+/**
+ * @brief 按字节推进命令接收状态机
+ * @param serial_char 接收到的字节
+ * @return 收到完整命令返回 true
+ */
+bool receive_byte(uint8_t serial_char) {
+    switch (receive_state) {
+    case RECEIVE_STATE_PAYLOAD:
+        // 二进制数据之后的 1 字节为结束符，内容不限
+        if (receive_remaining == 0) {
             receive_buf[receive_ptr] = '\0';
+            receive_state = RECEIVE_STATE_NAME;
+            return true;
+        }
 
-            if (receive_ptr > 0) {
-                data_received = true;
-                break;
+        receive_buf[receive_ptr] = serial_char;
+        receive_ptr++;
+        receive_remaining--;
+        return false;
+
+    case RECEIVE_STATE_FRAME:
+        if (serial_char != FRAME_DELIMITER) {
+            if (receive_ptr >= sizeof(receive_buf)) {
+                receive_overflow = true;
+            } else {
+                receive_buf[receive_ptr] = serial_char;
+                receive_ptr++;
             }
-        } else {
-            receive_buf[receive_ptr] = serial_char;
-            receive_ptr++;
+            return false;
+        }
+
+        // 连续的分隔符视为空帧，继续等待帧数据
+        if (receive_ptr == 0) {
+            return false;
+        }
 
-            if (receive_ptr >= sizeof(receive_buf) - 1) {
-                receive_buf[receive_ptr] = '\0';
-                data_received = true;
-                break;
+        receive_state = RECEIVE_STATE_NAME;
+        if (receive_overflow) {
+            receive_overflow = false;
+            receive_ptr = 0;
+            return false;
+        }
+
+        receive_framed = true;
+        return true;
+
+    case RECEIVE_STATE_DISCARD:
+        if ((serial_char == '\n') || (serial_char == '\r')) {
+            receive_ptr = 0;
+            receive_state = RECEIVE_STATE_NAME;
+        }
+        return false;
+
+    default:
+        // 分隔符开始一个二进制帧，丢弃未完成的 ASCII 命令
+        if (serial_char == FRAME_DELIMITER) {
+            receive_ptr = 0;
+            receive_state = RECEIVE_STATE_FRAME;
+            return false;
+        }
+
+        // 使用换行符或回车符作为结束标记
+        if ((serial_char == '\n') || (serial_char == '\r')) {
+            if (receive_ptr == 0) {
+                return false;
+            }
+
+            // 带二进制数据的命令缺少数据时按未知命令处理
+            receive_command = find_command(receive_ptr);
+            if (receive_command != NULL && receive_command->payload != 0 &&
+                receive_command->payload != COMMAND_PREFIX) {
+                receive_command = NULL;
+            }
+            receive_framed = false;
+            return true;
+        }
+
+        // 带二进制数据的命令在 "=" 处切换为定长接收
+        if (serial_char == '=') {
+            __code command_entry_t *entry = find_command(receive_ptr);
+
+            if (entry != NULL && entry->payload > 0 &&
+                entry->payload != COMMAND_PREFIX) {
+                receive_buf[receive_ptr] = serial_char;
+                receive_ptr++;
+                receive_remaining = entry->payload;
+                receive_command = entry;
+                receive_framed = false;
+                receive_state = RECEIVE_STATE_PAYLOAD;
+                return false;
             }
         }
+
+        if (receive_ptr >= sizeof(receive_buf) - 1) {
+            receive_state = RECEIVE_STATE_DISCARD;
+            return false;
+        }
+
+        receive_buf[receive_ptr] = serial_char;
+        receive_ptr++;
+        return false;
+    }
+}
+
+/**
+ * @brief 处理串口数据
+ * @details 依次解析并执行接收缓冲区中的全部完整命令，
+ *          执行时间超过 COMMAND_TIME_BUDGET 后剩余数据留到下一次循环
+ */
+void process_serial_data() {
+    uint32_t start = micros();
+
+    while (USBSerial_available()) {
+        if (!receive_byte(USBSerial_read())) {
+            continue;
+        }
+
+        process_commands(receive_buf);
+        receive_ptr = 0;
+
+        if (micros() - start >= COMMAND_TIME_BUDGET) {
+            break;
+        }
     }
 }
 
@@ -223,99 +756,586 @@ void process_serial_data() {
  * @param command 命令字符串
  */
 void process_commands(uint8_t *command) {
-    if (strcmp((const uint8_t *)command, CMD_CONFIG_MODE_ENABLED) == 0) {
-        is_config_mode = true;
+    if (receive_framed) {
+        process_frame(command, receive_ptr);
+        return;
+    }
 
-        // 初始化心跳检测，设置最后收到心跳时间为当前时间
-        heartbeat_last_received = millis();
+    if (receive_command == NULL) {
+        return; // Unknown command
+    }
 
-        USBSerial_print(CMD_CONFIG_MODE_ENABLED);
-        USBSerial_println(CMD_SUCCESS_SUFFIX);
-        USBSerial_flush();
-    } else if (strcmp((const uint8_t *)command, CMD_CONFIG_HEARTBEAT) == 0) {
-        if (is_config_mode) {
-            heartbeat_last_received = millis(); // 更新最后收到心跳的时间戳
+    // 前缀命令跳过前缀，其余命令跳过命令名称和 "="
+    if (receive_command->payload == COMMAND_PREFIX) {
+        receive_command->handler(command + receive_command->length);
+    } else {
+        receive_command->handler(command + receive_command->length + 1);
+    }
+}
+
+/**
+ * @brief 处理二进制帧请求并发送应答帧
+ * @details 编码或校验错误的帧直接丢弃，由主机超时重发。
+ *          之后没有待处理的请求时才 flush，使连续的应答合并发送
+ * @param frame COBS 编码的帧数据，不含分隔符
+ * @param len 编码数据长度
+ */
+void process_frame(uint8_t *frame, uint8_t len) {
+    len = Frame_Decode(frame, len);
+    if (len == 0) {
+        return;
+    }
+
+    uint8_t opcode = frame[1];
+    const uint8_t *data = frame + FRAME_HEADER_SIZE;
+    uint8_t data_len = len - FRAME_HEADER_SIZE;
+    uint8_t response_len = FRAME_HEADER_SIZE + 1;
+    uint8_t status = FRAME_STATUS_OK;
+
+    switch (opcode) {
+    case FRAME_OP_PING:
+        frame_response[response_len++] = FIRMWARE_VERSION;
+        frame_response[response_len++] = FIRMWARE_REVISION;
+        break;
+    case FRAME_OP_CONFIG_MODE:
+        enter_config_mode();
+        break;
+    case FRAME_OP_HEARTBEAT:
+        cmd_heartbeat(data);
+        break;
+    case FRAME_OP_LOAD_SETTINGS:
+        load_settings();
+        memcpy(frame_response + response_len, EEPROM_GetConfigData(),
+               CONFIG_STRUCT_SIZE);
+        response_len += CONFIG_STRUCT_SIZE;
+        break;
+    case FRAME_OP_SAVE_SETTINGS:
+        if (data_len != CMD_CONFIG_SAVE_SETTINGS_PAYLOAD) {
+            status = FRAME_STATUS_BAD_LENGTH;
+        } else if (!save_settings(data)) {
+            status = FRAME_STATUS_FAILED;
+        }
+        break;
+    case FRAME_OP_RESET_SETTINGS:
+        reset_settings();
+        break;
+    case FRAME_OP_PREVIEW:
+        if (!enter_preview()) {
+            status = FRAME_STATUS_FAILED;
+        }
+        break;
+    case FRAME_OP_COMMIT: {
+        if (!commit_preview()) {
+            status = FRAME_STATUS_FAILED;
         }
-    } else if (strcmp((const uint8_t *)command, CMD_CONFIG_LOAD_SETTINGS) ==
-               0) {
-        // 从 EEPROM 加载配置参数
-        EEPROM_LoadConfig();
 
-        eeprom_config_t *config = EEPROM_GetConfigData();
-        uint8_t *config_bytes = (uint8_t *)config;
+        uint16_t written = EEPROM_GetBytesWritten() - session_bytes_start;
+        frame_response[response_len++] = written & 0xFF;
+        frame_response[response_len++] = written >> 8;
+        session_bytes_start = EEPROM_GetBytesWritten();
+        break;
+    }
+    case FRAME_OP_REVERT:
+        revert_settings();
+        break;
+    default:
+        status = FRAME_STATUS_BAD_OPCODE;
+        break;
+    }
 
-        // 发送配置数据前缀
-        USBSerial_print("config=");
-        // 发送 32 字节配置数据
-        USBSerial_print_n(config_bytes, CONFIG_STRUCT_SIZE);
+    frame_response[0] = frame[0]; // 序号
+    frame_response[1] = opcode | FRAME_OP_RESPONSE;
+    frame_response[2] = status;
+    Frame_Send(frame_response, response_len);
 
-        USBSerial_println();
+    if (!USBSerial_available()) {
         USBSerial_flush();
-    } else if (memcmp((const uint8_t *)command, CMD_CONFIG_SAVE_SETTINGS_PREFIX,
-                      strlen(CMD_CONFIG_SAVE_SETTINGS_PREFIX)) == 0) {
-        eeprom_config_t *config = EEPROM_GetConfigData();
+    }
+}
+
+/**
+ * @brief 进入配置模式并开始主机在线检测
+ */
+void enter_config_mode() {
+    is_config_mode = true;
+
+    // 清除进入配置模式之前的主机离开事件
+    USBSerial_takeHostLost();
+    config_by_dtr = USBSerial_getLineState() & CDC_LINE_STATE_DTR;
 
-        // 跳过"save_settings="前缀（14字节）
-        const uint8_t *data_ptr =
-            (const uint8_t *)(command +
-                              strlen(CMD_CONFIG_SAVE_SETTINGS_PREFIX));
-        uint8_t *config_bytes = (uint8_t *)config;
+    // 初始化心跳检测，设置最后收到心跳时间为当前时间
+    heartbeat_last_received = millis();
+}
+
+/**
+ * @brief 主机离开后退出配置模式
+ */
+void exit_config_mode() {
+    is_config_mode = false;
+    heartbeat_last_received = 0; // 重置心跳时间戳
+
+    // 放弃未保存的预览配置
+    if (is_preview_mode) {
+        revert_settings();
+    }
+}
+
+/**
+ * @brief 保存配置参数并应用
+ * @details 预览模式下只应用不保存，见 preview_settings
+ * @param data 30 字节配置数据，不含 version 和 revision
+ * @return 保存成功返回 true，参数无效时恢复 EEPROM 中的配置并返回 false
+ */
+bool save_settings(const uint8_t *data) {
+    uint8_t *config_bytes = (uint8_t *)EEPROM_GetConfigData();
+    bool result = true;
+
+    // 修改配置前按当前的旋转角度报告积压的编码器输入
+    process_ec11_operation();
+
+    if (is_preview_mode) {
+        result = preview_settings(data);
+    } else {
+        // 先写入尚未保存的单项修改，保存失败时恢复的配置中包含这些修改
+        commit_settings();
 
         // 复制 30 字节配置数据，跳过前 2 字节（version 和 revision）
-        memcpy(config_bytes + 2, data_ptr, 30);
+        memcpy(config_bytes + 2, data, CMD_CONFIG_SAVE_SETTINGS_PAYLOAD);
 
         // 保存配置到EEPROM
-        if (EEPROM_SaveConfig() == EEPROM_STATUS_OK) {
-            USBSerial_print(CMD_CONFIG_SAVE_SETTINGS);
-            USBSerial_println(CMD_SUCCESS_SUFFIX);
-            USBSerial_flush();
-        } else {
+        if (save_config() != EEPROM_STATUS_OK) {
             // 保存失败，从 EEPROM 加载配置参数
             EEPROM_LoadConfig();
-
-            USBSerial_print(CMD_CONFIG_SAVE_SETTINGS);
-            USBSerial_println(CMD_FAILED_SUFFIX);
-            USBSerial_flush();
+            result = false;
         }
 
         // 执行配置更新后的初始化操作
         update_config();
-    } else if (strcmp((const uint8_t *)command, CMD_CONFIG_RESET_SETTINGS) ==
-               0) {
-        EEPROM_Reset();
-        EEPROM_SaveConfig();
+    }
 
-        // 执行配置更新后的初始化操作
-        update_config();
+    if (result) {
+        USBSerial_notify(CDC_EVENT_CONFIG_CHANGED, 0);
+    }
 
-        USBSerial_print(CMD_CONFIG_RESET_SETTINGS);
+    return result;
+}
+
+/**
+ * @brief 恢复默认配置参数并应用
+ */
+void reset_settings() {
+    EEPROM_Reset();
+
+    // 预览模式下只应用默认配置，commit 时才写入
+    if (!is_preview_mode) {
+        save_config();
+        settings_dirty = false;
+    }
+
+    // 执行配置更新后的初始化操作
+    update_config();
+
+    USBSerial_notify(CDC_EVENT_CONFIG_CHANGED, 0);
+}
+
+/**
+ * @brief 读取配置参数前使内存中的配置与 EEPROM 一致
+ * @note 预览模式下保留正在预览的配置，不从 EEPROM 重新读取
+ */
+void load_settings() {
+    if (is_preview_mode) {
+        return;
+    }
+
+    commit_settings();
+    EEPROM_LoadConfig();
+}
+
+/**
+ * @brief 预览配置参数，只应用发生变化的参数，不写入 EEPROM
+ * @param data 30 字节配置数据，不含 version 和 revision
+ * @return 参数有效返回 true，无效时恢复之前预览的配置并返回 false
+ */
+bool preview_settings(const uint8_t *data) {
+    uint8_t *config_bytes = (uint8_t *)EEPROM_GetConfigData();
+    void (*last_apply)() = NULL;
+
+    memcpy(preview_backup, config_bytes + 2, CMD_CONFIG_SAVE_SETTINGS_PAYLOAD);
+    for (uint8_t i = 0; i < PARAM_COUNT; i++) {
+        preview_values[i] = param_table[i].get();
+    }
+
+    memcpy(config_bytes + 2, data, CMD_CONFIG_SAVE_SETTINGS_PAYLOAD);
+    if (EEPROM_Validate() != EEPROM_STATUS_OK) {
+        memcpy(config_bytes + 2, preview_backup,
+               CMD_CONFIG_SAVE_SETTINGS_PAYLOAD);
+        USBSerial_notify(CDC_EVENT_ERROR, CDC_ERROR_INVALID_CONFIG);
+        return false;
+    }
+
+    // 相邻且共用应用函数的参数（led_count 与 color_order）只应用一次
+    for (uint8_t i = 0; i < PARAM_COUNT; i++) {
+        __code param_entry_t *param = &param_table[i];
+
+        if (param->apply != NULL && param->apply != last_apply &&
+            param->get() != preview_values[i]) {
+            param->apply();
+            last_apply = param->apply;
+        }
+    }
+
+    // 加速度曲线不在参数表中，设置开销很小，直接重新设置
+    EC11_SetAccelCurve(EEPROM_GetAccelCurve());
+
+    return true;
+}
+
+/**
+ * @brief 进入预览模式
+ * @details 之前尚未保存的单项修改先写入 EEPROM，revert 以此为准。只能在
+ *          配置模式下进入，主机离开时由退出配置模式放弃预览配置
+ * @return 进入成功返回 true，不在配置模式时返回 false
+ */
+bool enter_preview() {
+    if (!is_config_mode) {
+        return false;
+    }
+
+    commit_settings();
+
+    is_preview_mode = true;
+    session_bytes_start = EEPROM_GetBytesWritten();
+    return true;
+}
+
+/**
+ * @brief 保存当前配置并退出预览模式
+ * @return 保存成功返回 true
+ */
+bool commit_preview() {
+    is_preview_mode = false;
+    settings_dirty = false;
+
+    return save_config() == EEPROM_STATUS_OK;
+}
+
+/**
+ * @brief 放弃未保存的配置，恢复并应用 EEPROM 中的配置，退出预览模式
+ */
+void revert_settings() {
+    is_preview_mode = false;
+    settings_dirty = false;
+
+    EEPROM_LoadConfig();
+    update_config();
+
+    session_bytes_start = EEPROM_GetBytesWritten();
+    USBSerial_notify(CDC_EVENT_CONFIG_CHANGED, 0);
+}
+
+/**
+ * @brief 将尚未保存的单项参数修改写入 EEPROM
+ */
+void commit_settings() {
+    if (!settings_dirty) {
+        return;
+    }
+
+    settings_dirty = false;
+    save_config();
+}
+
+/**
+ * @brief 进入配置模式
+ */
+void cmd_config_mode_enabled(const uint8_t *arg) {
+    enter_config_mode();
+
+    USBSerial_print(CMD_CONFIG_MODE_ENABLED);
+    USBSerial_println(CMD_SUCCESS_SUFFIX);
+    USBSerial_flush();
+}
+
+/**
+ * @brief 配置模式心跳
+ */
+void cmd_heartbeat(const uint8_t *arg) {
+    if (is_config_mode) {
+        heartbeat_last_received = millis(); // 更新最后收到心跳的时间戳
+    }
+}
+
+/**
+ * @brief 读取配置参数
+ */
+void cmd_load_settings(const uint8_t *arg) {
+    // 从 EEPROM 加载配置参数，预览模式下读取正在预览的配置
+    load_settings();
+
+    eeprom_config_t *config = EEPROM_GetConfigData();
+    uint8_t *config_bytes = (uint8_t *)config;
+
+    // 发送配置数据前缀
+    USBSerial_print("config=");
+    // 发送 32 字节配置数据
+    USBSerial_print_n(config_bytes, CONFIG_STRUCT_SIZE);
+
+    USBSerial_println();
+    USBSerial_flush();
+}
+
+/**
+ * @brief 保存配置参数
+ * @param arg 30 字节配置数据，不含 version 和 revision
+ */
+void cmd_save_settings(const uint8_t *arg) {
+    USBSerial_print(CMD_CONFIG_SAVE_SETTINGS);
+
+    if (save_settings(arg)) {
         USBSerial_println(CMD_SUCCESS_SUFFIX);
+    } else {
+        USBSerial_println(CMD_FAILED_SUFFIX);
+    }
+    USBSerial_flush();
+}
+
+/**
+ * @brief 恢复默认配置参数
+ */
+void cmd_reset_settings(const uint8_t *arg) {
+    reset_settings();
+
+    USBSerial_print(CMD_CONFIG_RESET_SETTINGS);
+    USBSerial_println(CMD_SUCCESS_SUFFIX);
+    USBSerial_flush();
+}
+
+/**
+ * @brief 设置单项配置参数
+ * @details 只应用受影响的模块，EEPROM 在无新修改 SETTINGS_SAVE_DELAY 后写入。
+ *          成功回复 "<参数名>=<当前值>"，失败回复 "set_<参数名>_failed"
+ * @param arg "<参数名>=<十进制数值>"
+ */
+void cmd_set_parameter(const uint8_t *arg) {
+    const uint8_t *value = (const uint8_t *)strchr((const char *)arg, '=');
+    uint8_t length =
+        value != NULL ? (uint8_t)(value - arg) : strlen((const char *)arg);
+    __code param_entry_t *param = find_param(arg, length);
+    int16_t number;
+
+    if (param == NULL || value == NULL || !parse_int16(value + 1, &number) ||
+        param->set(number) != EEPROM_STATUS_OK) {
+        USBSerial_notify(CDC_EVENT_ERROR, CDC_ERROR_INVALID_CONFIG);
+
+        USBSerial_print(CMD_CONFIG_SET_PREFIX);
+        USBSerial_print_n((uint8_t *)arg, length);
+        USBSerial_println(CMD_FAILED_SUFFIX);
         USBSerial_flush();
+        return;
+    }
 
-        /* 以下为测试用命令 */
-    } else if (strcmp((const uint8_t *)command, CMD_TEST_SHOW_MENU) == 0) {
-        // 模拟径向控制器按钮按下
-        Radial_SendData(1, 0); // button=1(按下), degree=0(无旋转)
+    if (param->apply != NULL) {
+        param->apply();
+    }
 
-        // 保持按下状态 500 毫秒
-        delay(500);
+    // 预览模式下由 commit 保存
+    if (!is_preview_mode) {
+        settings_dirty = true;
+        settings_changed_time = millis();
+    }
 
-        // 执行按钮释放动作
-        Radial_SendData(0, 0); // button=0(释放), degree=0(无旋转)
-    } else if (strcmp((const uint8_t *)command, CMD_TEST_CLICK) == 0) {
-        // 立即模拟径向控制器按钮按下
-        Radial_SendData(1, 0); // button=1(按下), degree=0(无旋转)
+    USBSerial_notify(CDC_EVENT_CONFIG_CHANGED, 0);
 
-        // 保持按下状态 100 毫秒
-        delay(50);
+    USBSerial_print(param->name);
+    USBSerial_print("=");
+    USBSerial_println(param->get());
+    USBSerial_flush();
+}
 
-        // 执行按钮释放动作
-        Radial_SendData(0, 0); // button=0(释放), degree=0(无旋转)
-    } else if (strcmp((const uint8_t *)command, CMD_TEST_ROTATE_LEFT) == 0) {
-        // 模拟向左旋转（逆时针），单次旋转值为 -10 度
-        Radial_SendData(0, -10); // button=0(释放), degree=-10(向左旋转)
-    } else if (strcmp((const uint8_t *)command, CMD_TEST_ROTATE_RIGHT) == 0) {
-        // 模拟向右旋转（顺时针），单次旋转值为 10 度
-        Radial_SendData(0, 10); // button=0(释放), degree=10(向右旋转)
+/**
+ * @brief 读取单项配置参数
+ * @details 成功回复 "<参数名>=<当前值>"，失败回复 "get_<参数名>_failed"
+ * @param arg 参数名
+ */
+void cmd_get_parameter(const uint8_t *arg) {
+    uint8_t length = strlen((const char *)arg);
+    __code param_entry_t *param = find_param(arg, length);
+
+    if (param == NULL) {
+        USBSerial_print(CMD_CONFIG_GET_PREFIX);
+        USBSerial_print_n((uint8_t *)arg, length);
+        USBSerial_println(CMD_FAILED_SUFFIX);
+    } else {
+        USBSerial_print(param->name);
+        USBSerial_print("=");
+        USBSerial_println(param->get());
+    }
+    USBSerial_flush();
+}
+
+/**
+ * @brief 进入预览模式，之后的配置修改只应用不保存
+ */
+void cmd_preview(const uint8_t *arg) {
+    USBSerial_print(CMD_CONFIG_PREVIEW);
+
+    if (enter_preview()) {
+        USBSerial_println(CMD_SUCCESS_SUFFIX);
+    } else {
+        USBSerial_println(CMD_FAILED_SUFFIX);
+    }
+    USBSerial_flush();
+}
+
+/**
+ * @brief 保存预览配置并退出预览模式
+ * @details 之后回复 "bytes_written=<字节数>"，为本次调节实际写入 EEPROM 的
+ *          字节数，即从上一次 preview、commit 或 revert 起的写入量
+ */
+void cmd_commit(const uint8_t *arg) {
+    USBSerial_print(CMD_CONFIG_COMMIT);
+
+    if (commit_preview()) {
+        USBSerial_println(CMD_SUCCESS_SUFFIX);
+    } else {
+        USBSerial_println(CMD_FAILED_SUFFIX);
+    }
+
+    USBSerial_print(CMD_CONFIG_BYTES_WRITTEN);
+    USBSerial_print("=");
+    USBSerial_println(EEPROM_GetBytesWritten() - session_bytes_start);
+    USBSerial_flush();
+
+    session_bytes_start = EEPROM_GetBytesWritten();
+}
+
+/**
+ * @brief 放弃预览配置，恢复 EEPROM 中的配置
+ */
+void cmd_revert(const uint8_t *arg) {
+    revert_settings();
+
+    USBSerial_print(CMD_CONFIG_REVERT);
+    USBSerial_println(CMD_SUCCESS_SUFFIX);
+    USBSerial_flush();
+}
+
+/**
+ * @brief 测试命令：模拟径向控制器按钮长按
+ */
+void cmd_test_show_menu(const uint8_t *arg) {
+    // 模拟径向控制器按钮按下
+    Radial_SendData(0, 1, 0); // dial=0, button=1(按下), degree=0(无旋转)
+
+    // 保持按下状态 500 毫秒后由主循环释放，不阻塞编码器与灯效处理
+    test_release_pending = true;
+    test_press_time = millis();
+    test_hold_time = TEST_SHOW_MENU_HOLD_TIME;
+}
+
+/**
+ * @brief 测试命令：模拟径向控制器按钮点击
+ */
+void cmd_test_click(const uint8_t *arg) {
+    // 立即模拟径向控制器按钮按下
+    Radial_SendData(0, 1, 0); // dial=0, button=1(按下), degree=0(无旋转)
+
+    // 保持按下状态 50 毫秒后由主循环释放
+    test_release_pending = true;
+    test_press_time = millis();
+    test_hold_time = TEST_CLICK_HOLD_TIME;
+}
+
+/**
+ * @brief 测试命令：模拟向左旋转
+ */
+void cmd_test_rotate_left(const uint8_t *arg) {
+    // 模拟向左旋转（逆时针），单次旋转值为 -10 度
+    Radial_SendData(0, 0, -10); // button=0(释放), degree=-10(向左旋转)
+}
+
+/**
+ * @brief 测试命令：模拟向右旋转
+ */
+void cmd_test_rotate_right(const uint8_t *arg) {
+    // 模拟向右旋转（顺时针），单次旋转值为 10 度
+    Radial_SendData(0, 0, 10); // button=0(释放), degree=10(向右旋转)
+}
+
+/**
+ * @brief 测试命令：输出输入延迟统计
+ */
+void cmd_test_latency(const uint8_t *arg) {
+    // 输出自上次查询以来从输入到主机取走报告的延迟统计，并清零
+    __xdata RadialLatencyStats stats;
+
+    Radial_TakeLatencyStats(&stats);
+
+    // 格式：latency=样本数,最小,平均,最大(毫秒),轮询间隔(毫秒),
+    //       队列深度,队列深度峰值,队列溢出丢弃数
+    USBSerial_print(CMD_TEST_LATENCY);
+    USBSerial_print("=");
+    USBSerial_print(stats.count);
+    USBSerial_print(",");
+    USBSerial_print(stats.min);
+    USBSerial_print(",");
+    USBSerial_print(stats.average);
+    USBSerial_print(",");
+    USBSerial_print(stats.max);
+    USBSerial_print(",");
+    USBSerial_print(Radial_GetPollInterval());
+    USBSerial_print(",");
+    USBSerial_print(Radial_GetQueueDepth());
+    USBSerial_print(",");
+    USBSerial_print(Radial_GetQueueMaxDepth());
+    USBSerial_print(",");
+    USBSerial_println(Radial_GetQueueOverflow());
+    USBSerial_flush();
+}
+
+/**
+ * @brief 测试命令：输出主机轮询相位与报告时效统计
+ */
+void cmd_test_poll_stats(const uint8_t *arg) {
+    // 输出主机轮询相位与报告时效直方图，并清零计数
+    __xdata RadialPollStats stats;
+
+    Radial_TakePollStats(&stats);
+
+    // 格式：poll_stats=周期,相位,命中,未命中,直方图 8 档
+    USBSerial_print(CMD_TEST_POLL_STATS);
+    USBSerial_print("=");
+    USBSerial_print(stats.period);
+    USBSerial_print(",");
+    USBSerial_print(stats.phase);
+    USBSerial_print(",");
+    USBSerial_print(stats.hits);
+    USBSerial_print(",");
+    USBSerial_print(stats.misses);
+
+    for (uint8_t i = 0; i < RADIAL_AGE_BINS; i++) {
+        USBSerial_print(",");
+        USBSerial_print(stats.ageHistogram[i]);
+    }
+
+    USBSerial_println();
+    USBSerial_flush();
+}
+
+/**
+ * @brief 测试命令：输出编码器诊断计数
+ */
+void cmd_test_ec11_stats(const uint8_t *arg) {
+    // 格式：ec11_stats=丢弃事件数,各编码器非法跳变数
+    USBSerial_print(CMD_TEST_EC11_STATS);
+    USBSerial_print("=");
+    USBSerial_print(EC11_GetDroppedEvents());
+
+    for (uint8_t i = 0; i < EC11_COUNT; i++) {
+        USBSerial_print(",");
+        USBSerial_print(EC11_GetInvalidTransitions(i));
     }
+
+    USBSerial_println();
+    USBSerial_flush();
 }
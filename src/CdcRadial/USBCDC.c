@@ -9,10 +9,12 @@
 #include "include/ch5xx_usb.h"
 #include "USBconstant.h"
 #include "USBhandler.h"
+#include "USBCDC.h"
 // clang-format on
 
 // clang-format off
 extern __xdata __at (EP0_ADDR) uint8_t Ep0Buffer[];
+extern __xdata __at (EP1_ADDR) uint8_t Ep1Buffer[];
 extern __xdata __at (EP2_ADDR) uint8_t Ep2Buffer[];
 // clang-format on
 
@@ -22,14 +24,38 @@ __xdata uint8_t LineCoding[LINE_CODEING_SIZE] = {
     0x00, 0x00, 0x08}; // Initialize for baudrate 57600, 1 stopbit, No parity,
                        // eight data bits
 
-volatile __xdata uint8_t USBByteCountEP2 =
-    0; // Bytes of received data on USB endpoint
-volatile __xdata uint8_t USBBufOutPointEP2 = 0; // Data pointer for fetching
+// 接收 FIFO：端点1 OUT 中断移动 rxHead，主循环移动 rxTail
+// 读写指针自由递增，差值即为已缓存字节数，取模后得到下标
+__xdata uint8_t rxFifo[CDC_RX_FIFO_SIZE];
+volatile __xdata uint8_t rxHead = 0;
+volatile __xdata uint8_t rxTail = 0;
+volatile __bit rxPaused = 0; // 剩余空间不足一个数据包，OUT 端点已回复 NAK
 
 volatile __bit UpPoint2BusyFlag = 0; // Flag of whether upload pointer is busy
 volatile __xdata uint8_t controlLineState = 0;
+volatile __bit hostLost = 0; // DTR 被释放、总线复位或挂起，等待主循环取出
 
-__xdata uint8_t usbWritePointer = 0;
+// 发送环形缓冲区：主循环在 txWrite 处写入当前消息，消息完整后提交到 txHead，
+// 端点2 IN 中断只发送已提交的数据并移动 txTail
+__xdata uint8_t txRing[CDC_TX_RING_SIZE];
+volatile __xdata uint8_t txHead = 0;
+volatile __xdata uint8_t txTail = 0;
+volatile __xdata uint8_t txWrite = 0;
+volatile __bit txDropped = 0;            // 当前消息有数据因空间不足被丢弃
+volatile __xdata uint8_t txOverflow = 0; // 因缓冲区已满而丢弃的消息数
+volatile __bit txLastPacketFull = 0;     // 上一个数据包是否为满包
+
+// 端点1 通知队列：主循环移动 notifyHead，端点1 IN 中断移动 notifyTail
+// 读写指针自由递增，差值即为排队的通知数
+__xdata uint8_t notifyEvent[CDC_NOTIFY_QUEUE_SIZE];
+__xdata uint8_t notifyParam[CDC_NOTIFY_QUEUE_SIZE];
+volatile __xdata uint8_t notifyHead = 0;
+volatile __xdata uint8_t notifyTail = 0;
+volatile __bit notifyBusy = 0; // 端点1 IN 正在发送通知
+
+// 端点2 IN 乒乓缓冲：一个缓冲区发送期间，另一个缓冲区预先装入下一个数据包
+volatile __xdata uint8_t txStagedLen = 0; // 预装数据包长度
+volatile __bit txStaged = 0;              // 是否已有预装数据包
 
 void delayMicroseconds(__data uint16_t us);
 
@@ -40,8 +66,26 @@ void USBInit() {
 }
 
 void resetCDCParameters() {
-    USBByteCountEP2 = 0; // Bytes of received data on USB endpoint
+    rxHead = 0; // Drop pending RX data
+    rxTail = 0;
+    rxPaused = 0;
     UpPoint2BusyFlag = 0;
+    txHead = 0; // Drop pending TX data
+    txTail = 0;
+    txWrite = 0;
+    txDropped = 0;
+    txLastPacketFull = 0;
+    txStaged = 0;
+    controlLineState = 0; // Host opens the port again after enumeration
+    notifyHead = 0;       // Drop pending notifications
+    notifyTail = 0;
+    notifyBusy = 0;
+    hostLost = 1;
+}
+
+void suspendCDCHandler() {
+    // Keep controlLineState, the port is still open after a resume
+    hostLost = 1;
 }
 
 void setLineCodingHandler() {
@@ -65,6 +109,11 @@ uint16_t getLineCodingHandler() {
 }
 
 void setControlLineStateHandler() {
+    // DTR dropped: the host closed the port
+    if ((controlLineState & CDC_LINE_STATE_DTR) &&
+        !(Ep0Buffer[2] & CDC_LINE_STATE_DTR)) {
+        hostLost = 1;
+    }
     controlLineState = Ep0Buffer[2];
 
     // We check DTR state to determine if host port is open (bit 0 of
@@ -100,16 +149,175 @@ void setControlLineStateHandler() {
     }
 }
 
-uint8_t USBSerial_wait_UpPoint2BusyFlag_clear() {
-    __data uint16_t waitWriteCount = 0;
-    while (UpPoint2BusyFlag) { // wait for 250ms or give up, on my mac it takes
-                               // about 256us
-        waitWriteCount++;
-        delayMicroseconds(5);
-        if (waitWriteCount >= 50000)
-            return 0;
+#pragma save
+#pragma nooverlay
+/**
+ * @brief 从发送环形缓冲区取出最多一个数据包装入端点2的指定缓冲区
+ * @param offset 缓冲区在 Ep2Buffer 中的偏移（0 或 MAX_PACKET_SIZE）
+ * @return 装入的字节数
+ */
+static uint8_t USBSerial_fill_packet(__data uint8_t offset) {
+    __data uint8_t len = 0;
+
+    while (len < MAX_PACKET_SIZE && txTail != txHead) {
+        Ep2Buffer[offset + len] = txRing[txTail];
+        txTail = (txTail + 1) & (CDC_TX_RING_SIZE - 1);
+        len++;
+    }
+    return len;
+}
+
+/**
+ * @brief 端点2发送期间，将下一个数据包预装入空闲的缓冲区
+ * @note 硬件按 bUEP_T_TOG 选择缓冲区，发送成功后自动翻转，
+ *       因此预装缓冲区正是下一次发送所用的缓冲区
+ */
+static void USBSerial_stage_packet() {
+    if (txStaged || txTail == txHead) {
+        return;
+    }
+
+    // The idle buffer is the one not selected by the current toggle
+    txStagedLen = USBSerial_fill_packet(
+        (UEP2_CTRL & bUEP_T_TOG) ? 0 : MAX_PACKET_SIZE);
+    txStaged = 1;
+}
+
+/**
+ * @brief 启动端点2的下一个数据包发送，并预装随后的数据包
+ * @details 没有待发数据且上一个数据包为满包时发送零长度包，通知主机传输结束
+ * @note 调用前需保证端点2空闲，主循环中调用时需关闭 USB 中断
+ */
+static void USBSerial_send_next_packet() {
+    __data uint8_t len;
+
+    if (txStaged) {
+        len = txStagedLen; // Already in the buffer selected by the toggle
+        txStaged = 0;
+    } else {
+        len = USBSerial_fill_packet((UEP2_CTRL & bUEP_T_TOG) ? MAX_PACKET_SIZE
+                                                             : 0);
+        if (len == 0 && !txLastPacketFull) {
+            return; // Nothing to send
+        }
     }
-    return 1;
+
+    // A full packet does not end the transfer, Windows needs an empty packet
+    txLastPacketFull = (len == MAX_PACKET_SIZE);
+
+    UEP2_T_LEN = len;
+    UEP2_CTRL = (UEP2_CTRL & ~MASK_UEP_T_RES) | UEP_T_RES_ACK; // Respond ACK
+    UpPoint2BusyFlag = 1;
+
+    USBSerial_stage_packet();
+}
+
+/**
+ * @brief 将通知队列中的下一个事件装入端点1 的发送缓冲区并启动发送
+ * @note 调用前需保证端点1 IN 空闲，主循环中调用时需关闭 USB 中断
+ */
+static void USBSerial_send_notification() {
+    __data uint8_t i;
+
+    if (notifyTail == notifyHead) {
+        return;
+    }
+
+    // IN half of Ep1Buffer follows the 64-byte OUT buffer
+    i = notifyTail & (CDC_NOTIFY_QUEUE_SIZE - 1);
+    Ep1Buffer[MAX_PACKET_SIZE + 0] = 0xA1; // Device to host, class, interface
+    Ep1Buffer[MAX_PACKET_SIZE + 1] = CDC_NOTIFY_DEVICE_EVENT;
+    Ep1Buffer[MAX_PACKET_SIZE + 2] = notifyEvent[i]; // wValue
+    Ep1Buffer[MAX_PACKET_SIZE + 3] = notifyParam[i];
+    Ep1Buffer[MAX_PACKET_SIZE + 4] = INTERFACE_ID_CDC_CCI; // wIndex
+    Ep1Buffer[MAX_PACKET_SIZE + 5] = 0;
+    Ep1Buffer[MAX_PACKET_SIZE + 6] = 0; // wLength, no data
+    Ep1Buffer[MAX_PACKET_SIZE + 7] = 0;
+    notifyTail++;
+
+    UEP1_T_LEN = CDC_NOTIFICATION_EPSIZE;
+    UEP1_CTRL = (UEP1_CTRL & ~MASK_UEP_T_RES) | UEP_T_RES_ACK; // Respond ACK
+    notifyBusy = 1;
+}
+#pragma restore
+
+/**
+ * @brief 端点2空闲时启动发送，发送中则预装下一个数据包
+ */
+static void USBSerial_kick() {
+    IE_USB = 0;
+    if (!UpPoint2BusyFlag) {
+        USBSerial_send_next_packet();
+    } else {
+        USBSerial_stage_packet();
+    }
+    IE_USB = 1;
+}
+
+/**
+ * @brief 获取发送环形缓冲区的剩余空间
+ * @return 可写入的字节数
+ */
+uint8_t USBSerial_availableForWrite() {
+    return (CDC_TX_RING_SIZE - 1) -
+           ((txWrite - txTail) & (CDC_TX_RING_SIZE - 1));
+}
+
+bool USBSerial_commit() {
+    if (txDropped) {
+        // Roll back the partial message, the host never sees it
+        txWrite = txHead;
+        txDropped = 0;
+        txOverflow++;
+        return false;
+    }
+
+    txHead = txWrite;
+
+    // Start sending once a full packet is waiting
+    if (((txHead - txTail) & (CDC_TX_RING_SIZE - 1)) >= MAX_PACKET_SIZE) {
+        USBSerial_kick();
+    }
+    return true;
+}
+
+/**
+ * @brief 获取因发送缓冲区已满而丢弃的消息数
+ * @return 丢弃次数
+ */
+uint8_t USBSerial_getTxOverflow() { return txOverflow; }
+
+uint8_t USBSerial_getLineState() { return controlLineState; }
+
+bool USBSerial_notify(uint8_t event, uint8_t param) {
+    __data uint8_t i;
+
+    if (UsbConfig == 0 ||
+        (uint8_t)(notifyHead - notifyTail) >= CDC_NOTIFY_QUEUE_SIZE) {
+        return false;
+    }
+
+    i = notifyHead & (CDC_NOTIFY_QUEUE_SIZE - 1);
+    notifyEvent[i] = event;
+    notifyParam[i] = param;
+
+    IE_USB = 0;
+    notifyHead++;
+    if (!notifyBusy) {
+        USBSerial_send_notification();
+    }
+    IE_USB = 1;
+
+    return true;
+}
+
+bool USBSerial_takeHostLost() {
+    if (!hostLost) {
+        return false;
+    }
+
+    hostLost = 0;
+    return true;
 }
 
 bool USBSerial() {
@@ -121,40 +329,34 @@ bool USBSerial() {
 }
 
 void USBSerial_flush() {
-    if (!UpPoint2BusyFlag && usbWritePointer > 0) {
-        UEP2_T_LEN = usbWritePointer;
-        UEP2_CTRL = UEP2_CTRL & ~MASK_UEP_T_RES | UEP_T_RES_ACK; // Respond ACK
-        UpPoint2BusyFlag = 1;
-
-        if (usbWritePointer ==
-            MAX_PACKET_SIZE) { // write empty packet for end transmission.
-                               // Needed for windows.
-            if (USBSerial_wait_UpPoint2BusyFlag_clear()) {
-                UEP2_T_LEN = 0;
-                UEP2_CTRL =
-                    UEP2_CTRL & ~MASK_UEP_T_RES | UEP_T_RES_ACK; // Respond ACK
-                UpPoint2BusyFlag = 1;
-            }
-        }
-        usbWritePointer = 0;
+    USBSerial_commit();
+
+    // Non-blocking, EP2 IN interrupt drains the rest of the ring
+    if (txHead != txTail) {
+        USBSerial_kick();
     }
 }
 
-uint8_t USBSerial_write(__data char c) { // 3 bytes generic pointer
+uint8_t USBSerial_write(__data char c) {
+    __data uint8_t written = 0;
+
     if (controlLineState > 0) {
-        while (true) {
-            if (USBSerial_wait_UpPoint2BusyFlag_clear() == 0)
-                return 0;
-            if (usbWritePointer < MAX_PACKET_SIZE) {
-                Ep2Buffer[MAX_PACKET_SIZE + usbWritePointer] = c;
-                usbWritePointer++;
-                return 1;
-            } else {
-                USBSerial_flush(); // go back to first while
-            }
+        // Once a byte is dropped the rest of the message is dropped too,
+        // never block the main loop
+        if (txDropped || USBSerial_availableForWrite() == 0) {
+            txDropped = 1;
+        } else {
+            txRing[txWrite] = c;
+            txWrite = (txWrite + 1) & (CDC_TX_RING_SIZE - 1);
+            written = 1;
+        }
+
+        // A line is a complete message
+        if (c == '\n') {
+            USBSerial_commit();
         }
     }
-    return 0;
+    return written;
 }
 
 uint8_t
@@ -162,53 +364,75 @@ USBSerial_print_n(uint8_t *__xdata buf,
                   __xdata int len) { // 3 bytes generic pointer, not using
                                      // USBSerial_write for a bit efficiency
     if (controlLineState > 0) {
+        // The block is part of the current message, drop it as a whole
+        if (txDropped || len > USBSerial_availableForWrite()) {
+            txDropped = 1;
+            return 0;
+        }
+
         while (len > 0) {
-            if (USBSerial_wait_UpPoint2BusyFlag_clear() == 0)
-                return 0;
-            while (len > 0) {
-                if (usbWritePointer < MAX_PACKET_SIZE) {
-                    Ep2Buffer[MAX_PACKET_SIZE + usbWritePointer] = *buf++;
-                    usbWritePointer++;
-                    len--;
-                } else {
-                    USBSerial_flush(); // go back to first while
-                    break;
-                }
-            }
+            txRing[txWrite] = *buf++;
+            txWrite = (txWrite + 1) & (CDC_TX_RING_SIZE - 1);
+            len--;
         }
     }
     return 0;
 }
 
-uint8_t USBSerial_available() { return USBByteCountEP2; }
+uint8_t USBSerial_available() { return (uint8_t)(rxHead - rxTail); }
 
 char USBSerial_read() {
-    if (USBByteCountEP2 == 0)
+    if (rxHead == rxTail)
         return 0;
-    __data char data = Ep2Buffer[USBBufOutPointEP2];
-    USBBufOutPointEP2++;
-    USBByteCountEP2--;
-    if (USBByteCountEP2 == 0) {
-        UEP2_CTRL = UEP2_CTRL & ~MASK_UEP_R_RES | UEP_R_RES_ACK;
+    __data char data = rxFifo[rxTail & (CDC_RX_FIFO_SIZE - 1)];
+    rxTail++;
+
+    // Resume the OUT endpoint as soon as another packet fits
+    if (rxPaused &&
+        (uint8_t)(rxHead - rxTail) <= CDC_RX_FIFO_SIZE - MAX_PACKET_SIZE) {
+        IE_USB = 0;
+        rxPaused = 0;
+        UEP1_CTRL = (UEP1_CTRL & ~MASK_UEP_R_RES) | UEP_R_RES_ACK;
+        IE_USB = 1;
     }
     return data;
 }
 
+void USB_EP1_IN() {
+    UEP1_T_LEN = 0;
+    UEP1_CTRL = (UEP1_CTRL & ~MASK_UEP_T_RES) | UEP_T_RES_NAK; // Default NAK
+    notifyBusy = 0;
+
+    USBSerial_send_notification();
+}
+
 void USB_EP2_IN() {
     UEP2_T_LEN = 0; // No data to send anymore
     UEP2_CTRL =
-        UEP2_CTRL & ~MASK_UEP_T_RES | UEP_T_RES_NAK; // Respond NAK by default
+        (UEP2_CTRL & ~MASK_UEP_T_RES) | UEP_T_RES_NAK; // Respond NAK by default
     UpPoint2BusyFlag = 0;                            // Clear busy flag
+
+    // Send the staged buffer, refill from the TX ring, or end the transfer
+    // with an empty packet
+    USBSerial_send_next_packet();
 }
 
-void USB_EP2_OUT() {
+void USB_EP1_OUT() {
     if (U_TOG_OK) // Discard unsynchronized packets
     {
-        USBByteCountEP2 = USB_RX_LEN;
-        USBBufOutPointEP2 = 0; // Reset Data pointer for fetching
-        if (USBByteCountEP2)
-            UEP2_CTRL = UEP2_CTRL & ~MASK_UEP_R_RES |
-                        UEP_R_RES_NAK; // Respond NAK after a packet. Let main
-                                       // code change response after handling.
+        __data uint8_t len = USB_RX_LEN;
+        __data uint8_t i;
+
+        // The endpoint is only ACKed while a whole packet fits
+        for (i = 0; i < len; i++) {
+            rxFifo[rxHead & (CDC_RX_FIFO_SIZE - 1)] = Ep1Buffer[i];
+            rxHead++;
+        }
+
+        // Keep ACKing while space remains, otherwise let main code resume
+        if ((uint8_t)(rxHead - rxTail) > CDC_RX_FIFO_SIZE - MAX_PACKET_SIZE) {
+            rxPaused = 1;
+            UEP1_CTRL = (UEP1_CTRL & ~MASK_UEP_R_RES) | UEP_R_RES_NAK;
+        }
     }
 }
@@ -3,16 +3,82 @@
 
 // clang-format off
 #include <stdint.h>
+#include <stdbool.h>
 #include "include/ch5xx.h"
 #include "include/ch5xx_usb.h"
 // clang-format on
 
+// 发送环形缓冲区大小，必须为 2 的幂且不超过 256。
+// 写入的数据以消息为单位提交发送：换行符、USBSerial_flush() 或
+// USBSerial_commit() 结束一条消息。缓冲区已满时整条消息丢弃并计数，
+// 主机不会收到截断的行，也不会阻塞；
+// 调用方可先用 USBSerial_availableForWrite() 检查剩余空间实现背压
+#define CDC_TX_RING_SIZE 128
+
+// 接收 FIFO 大小，必须为 2 的幂且不超过 128，至少容纳一个 64 字节数据包。
+// 剩余空间足够容纳下一个数据包时 OUT 端点立即回复 ACK，否则回复 NAK
+// 直到主循环读出数据
+#define CDC_RX_FIFO_SIZE 128
+
+// 端点1 通知队列大小，必须为 2 的幂。队列已满时丢弃新的通知
+#define CDC_NOTIFY_QUEUE_SIZE 4
+
+// 设备事件通知（端点1 IN，8 字节）：bmRequestType 0xA1，bNotification 为
+// 厂商自定义代码，wValue 低字节为事件、高字节为事件参数，wIndex 为 CDC 通信
+// 接口号，wLength 为 0。标准 CDC 驱动会忽略未知的通知
+#define CDC_NOTIFY_DEVICE_EVENT 0xE0
+
+// 设备事件及其参数
+#define CDC_EVENT_CONFIG_CHANGED 0x01 // 配置已应用到运行中的模块，参数为 0
+#define CDC_EVENT_SAVE_COMPLETE 0x02 // 配置已写入 EEPROM，参数为写入字节数
+#define CDC_EVENT_ERROR 0x03         // 发生错误，参数为错误代码
+#define CDC_EVENT_KEY_GESTURE 0x04   // 按键手势，参数为 (索引 << 4) | 手势
+
+// CDC_EVENT_ERROR 的错误代码
+#define CDC_ERROR_INVALID_CONFIG 0x01 // 配置参数无效，未应用
+#define CDC_ERROR_SAVE_FAILED 0x02    // 配置写入 EEPROM 失败
+
+// SET_CONTROL_LINE_STATE 中的控制线状态位
+#define CDC_LINE_STATE_DTR 0x01 // 主机已打开串口
+#define CDC_LINE_STATE_RTS 0x02
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 void USBInit();
 
+uint8_t USBSerial_availableForWrite();
+uint8_t USBSerial_getTxOverflow();
+
+/**
+ * @brief 结束当前消息，完整写入时提交发送，否则丢弃整条消息
+ * @return 提交成功返回 true，消息因缓冲区已满被丢弃返回 false
+ */
+bool USBSerial_commit();
+
+/**
+ * @brief 获取主机设置的控制线状态
+ * @return CDC_LINE_STATE_DTR 与 CDC_LINE_STATE_RTS 的组合
+ */
+uint8_t USBSerial_getLineState();
+
+/**
+ * @brief 取出并清除主机离开事件
+ * @details DTR 由有效变为无效（主机关闭串口）、总线复位或总线挂起时置位
+ * @return 自上次调用以来发生过主机离开事件返回 true
+ */
+bool USBSerial_takeHostLost();
+
+/**
+ * @brief 通过端点1 发送设备事件通知
+ * @details 通知进入队列后由端点1 IN 中断依次发送，不会阻塞
+ * @param event 事件，CDC_EVENT_*
+ * @param param 事件参数
+ * @return 设备未配置或队列已满时返回 false
+ */
+bool USBSerial_notify(uint8_t event, uint8_t param);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
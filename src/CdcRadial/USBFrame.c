@@ -0,0 +1,107 @@
+/*
+  CDC 二进制帧协议源文件
+
+  Copyright © 2026 Walkline Wang (walkline@gmail.com)
+  Github: https://github.com/walklinewang/Radial-Controller
+*/
+// clang-format off
+#include <stdint.h>
+#include <stdbool.h>
+#include "USBCDC.h"
+#include "USBFrame.h"
+// clang-format on
+
+// CDC functions:
+uint8_t USBSerial_print_n(uint8_t *__xdata buf, __xdata int len);
+
+// 编码后的发送帧，含首尾分隔符
+__xdata uint8_t frameBuf[FRAME_ENCODED_MAX + 2];
+
+uint16_t Frame_CRC16(const uint8_t *data, uint8_t len) {
+    uint16_t crc = 0xFFFF;
+
+    while (len--) {
+        crc ^= (uint16_t)*data++ << 8;
+
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+        }
+    }
+
+    return crc;
+}
+
+uint8_t Frame_Decode(uint8_t *buf, uint8_t len) {
+    uint8_t read = 0;
+    uint8_t write = 0;
+
+    // 解码结果不长于编码数据，可以原地写回
+    while (read < len) {
+        uint8_t code = buf[read++];
+
+        if (code == 0 || (uint16_t)read + code - 1 > len) {
+            return 0;
+        }
+
+        for (uint8_t i = 1; i < code; i++) {
+            buf[write++] = buf[read++];
+        }
+
+        // 0xFF 表示 254 字节不含 0x00 的数据块，其后没有隐含的 0x00
+        if (code < 0xFF && read < len) {
+            buf[write++] = 0;
+        }
+    }
+
+    if (write < FRAME_HEADER_SIZE + FRAME_CRC_SIZE) {
+        return 0;
+    }
+
+    write -= FRAME_CRC_SIZE;
+    if (Frame_CRC16(buf, write) !=
+        (buf[write] | ((uint16_t)buf[write + 1] << 8))) {
+        return 0;
+    }
+
+    return write;
+}
+
+bool Frame_Send(uint8_t *data, uint8_t len) {
+    uint16_t crc = Frame_CRC16(data, len);
+    uint8_t code_pos = 1;
+    uint8_t code = 1;
+    uint8_t n = 2;
+
+    data[len++] = crc & 0xFF;
+    data[len++] = crc >> 8;
+
+    frameBuf[0] = FRAME_DELIMITER;
+
+    for (uint8_t i = 0; i < len; i++) {
+        if (data[i] == 0) {
+            frameBuf[code_pos] = code;
+            code_pos = n++;
+            code = 1;
+        } else {
+            frameBuf[n++] = data[i];
+            code++;
+
+            if (code == 0xFF) {
+                frameBuf[code_pos] = code;
+                code_pos = n++;
+                code = 1;
+            }
+        }
+    }
+
+    frameBuf[code_pos] = code;
+    frameBuf[n++] = FRAME_DELIMITER;
+
+    // 整帧写入，空间不足时丢弃，避免主机收到不完整的帧
+    if (n > USBSerial_availableForWrite()) {
+        return false;
+    }
+
+    USBSerial_print_n(frameBuf, n);
+    return USBSerial_commit();
+}
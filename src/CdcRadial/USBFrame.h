@@ -0,0 +1,81 @@
+/*
+  CDC 二进制帧协议头文件
+
+  Copyright © 2026 Walkline Wang (walkline@gmail.com)
+  Github: https://github.com/walklinewang/Radial-Controller
+*/
+#ifndef __USB_FRAME_H__
+#define __USB_FRAME_H__
+
+// clang-format off
+#include <stdint.h>
+#include <stdbool.h>
+// clang-format on
+
+/*
+ * 帧格式（COBS 编码前）：序号(1) + 操作码(1) + 数据(0~32) + CRC-16(2，小端)
+ * CRC-16 为 CCITT-FALSE（多项式 0x1021，初值 0xFFFF），覆盖序号至数据末尾。
+ * 编码后的帧前后各有一个 0x00 分隔符，不含 0x00 的 ASCII 命令不受影响。
+ * 应答帧的序号与请求相同，操作码最高位置 1，数据的第一个字节为状态码
+ */
+#define FRAME_DELIMITER 0x00
+#define FRAME_HEADER_SIZE 2  // 序号 + 操作码
+#define FRAME_CRC_SIZE 2     // CRC-16
+#define FRAME_PAYLOAD_MAX 33 // 状态码 + 32 字节配置数据
+#define FRAME_DECODED_MAX                                                      \
+    (FRAME_HEADER_SIZE + FRAME_PAYLOAD_MAX + FRAME_CRC_SIZE)
+#define FRAME_ENCODED_MAX (FRAME_DECODED_MAX + FRAME_DECODED_MAX / 254 + 1)
+
+// 操作码
+#define FRAME_OP_PING 0x01           // 应答固件版本号和修订号
+#define FRAME_OP_CONFIG_MODE 0x02    // 进入配置模式
+#define FRAME_OP_HEARTBEAT 0x03      // 配置模式心跳
+#define FRAME_OP_LOAD_SETTINGS 0x04  // 读取 32 字节配置数据
+#define FRAME_OP_SAVE_SETTINGS 0x05  // 保存 30 字节配置数据
+#define FRAME_OP_RESET_SETTINGS 0x06 // 恢复默认配置
+#define FRAME_OP_PREVIEW 0x07        // 进入预览模式，配置只应用不保存
+#define FRAME_OP_COMMIT 0x08         // 保存预览配置，应答本次写入字节数
+#define FRAME_OP_REVERT 0x09         // 放弃预览配置，恢复已保存的配置
+#define FRAME_OP_RESPONSE 0x80       // 应答帧操作码标志
+
+// 应答状态码
+#define FRAME_STATUS_OK 0         // 成功
+#define FRAME_STATUS_FAILED 1     // 执行失败
+#define FRAME_STATUS_BAD_OPCODE 2 // 未知操作码
+#define FRAME_STATUS_BAD_LENGTH 3 // 数据长度错误
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 计算 CRC-16/CCITT-FALSE
+ * @param data 数据指针
+ * @param len 数据长度
+ * @return CRC 值
+ */
+uint16_t Frame_CRC16(const uint8_t *data, uint8_t len);
+
+/**
+ * @brief 原地解码 COBS 帧并校验 CRC
+ * @param buf 不含分隔符的编码数据，解码结果写回同一缓冲区
+ * @param len 编码数据长度
+ * @return 去掉 CRC 后的帧长度，编码或校验错误返回 0
+ */
+uint8_t Frame_Decode(uint8_t *buf, uint8_t len);
+
+/**
+ * @brief 追加 CRC 并以 COBS 编码发送一帧
+ * @details 整帧写入 CDC 发送缓冲区，空间不足时整帧丢弃，不会阻塞。
+ *          不主动 flush，连续的应答可以合并到同一次 IN 传输
+ * @param data 帧数据（序号、操作码和数据），末尾需预留 2 字节用于 CRC
+ * @param len 帧数据长度（不含 CRC）
+ * @return 写入成功返回 true
+ */
+bool Frame_Send(uint8_t *data, uint8_t len);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif
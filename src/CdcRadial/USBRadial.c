@@ -16,29 +16,430 @@
 
 // clang-format off
 extern __xdata __at (EP0_ADDR) uint8_t Ep0Buffer[16];
-extern __xdata __at (EP1_ADDR) uint8_t Ep1Buffer[8];
+extern __xdata __at (EP1_ADDR) uint8_t Ep1Buffer[72];
 extern __xdata __at (EP2_ADDR) uint8_t Ep2Buffer[128];
-extern __xdata __at (EP3_ADDR) uint8_t Ep3Buffer[64];
+extern __xdata __at (EP3_ADDR) uint8_t Ep3Buffer[KEYBOARD_EPSIZE];
 // clang-format on
 
 volatile __xdata uint8_t UpPoint3_Busy =
     0; // Flag of whether upload pointer is busy
 
-// 径向控制器报告全局变量
-__xdata RadialReport radialReport = {.reportId = RADIAL_REPORT_ID,
-                                     .buttonDial = 0};
+// 径向控制器报告全局变量，每个旋钮一份
+__xdata RadialReport radialReport[RADIAL_DIAL_COUNT];
+
+// 报告队列，由主循环写入、端点3 IN 中断取出，主循环修改期间关闭 USB 中断
+__xdata RadialQueueEntry reportQueue[RADIAL_QUEUE_SIZE];
+__xdata uint8_t queueHead = 0;     // 队首位置
+__xdata uint8_t queueCount = 0;    // 队列中的报告数量
+__xdata uint8_t queueMaxDepth = 0; // 队列深度峰值
+__xdata uint8_t queueOverflow = 0; // 队列已满且无法合并被丢弃的报告数量
+__xdata uint8_t queuedButton = 0;  // 各旋钮最新入队的按钮状态（按位对应旋钮）
+
+// 报告对应的输入时间戳，由 Radial_SetInputTime 设置，用于统计输入延迟
+__xdata uint16_t inputTime = 0;
+__xdata bool inputTimeValid = false;
+__xdata uint16_t armedInputTime = 0; // 端点3当前报告的输入时间戳
+__xdata bool armedInputTimeValid = false;
+
+// 从输入到主机取走报告的延迟统计（毫秒）
+__xdata uint16_t latencyCount = 0;
+__xdata uint16_t latencyMin = 0xFFFF;
+__xdata uint16_t latencyMax = 0;
+__xdata uint32_t latencySum = 0;
+
+// HID 端点轮询间隔（毫秒），发送配置描述符时使用
+__xdata uint8_t radialPollInterval = HID_POLL_INTERVAL_DEFAULT;
+// 最近一次随配置描述符发送给主机的轮询间隔，主机按此值轮询直到重新枚举
+__xdata uint8_t radialSentInterval = HID_POLL_INTERVAL_DEFAULT;
+
+// SOF 时间基准：按帧计数并跟踪主机轮询端点3所在的帧相位
+__xdata uint8_t sofFrame = 0;     // 软件帧计数，每个 SOF 加 1
+__xdata uint8_t pollPeriod = 8;   // 主机实际轮询周期（帧），为 2 的幂
+__xdata uint8_t pollPhase = 0;    // 主机轮询所在帧相位
+__xdata bool pollPhaseValid = false;
+__xdata uint16_t pollPhaseHits = 0;   // 报告在预期相位被取走的次数
+__xdata uint16_t pollPhaseMisses = 0; // 报告在其他相位被取走的次数
+
+// 报告被主机取走时的数据时效直方图（毫秒）：0,1,2,3,4-7,8-15,16-31,32+
+__xdata uint16_t ageHistogram[RADIAL_AGE_BINS];
+
+// HID 空闲速率（4 毫秒为单位，0 表示仅在数据变化时发送），每个旋钮一份，
+// 由主机通过 SET_IDLE 设置
+__xdata uint8_t idleRate[RADIAL_DIAL_COUNT];
+__xdata uint16_t idleElapsed[RADIAL_DIAL_COUNT]; // 距上次发送报告的毫秒数
 
 // 错误代码全局变量
 __xdata uint8_t lastError = HID_ERR_NONE;
 
 typedef void (*pTaskFn)();
 
-void delayMicroseconds(uint16_t us);
+uint32_t millis();
+
+#pragma save
+#pragma nooverlay
+/**
+ * @brief 判断当前帧是否为主机轮询端点3的前一帧
+ * @details 在轮询前一帧装入报告，既保证赶上主机轮询，又能合并尽可能新的数据。
+ *          尚未测得轮询相位时总是返回 true
+ * @return bool 是否应立即装入报告
+ */
+static bool Radial_IsArmFrame() {
+    if (!pollPhaseValid) {
+        return true;
+    }
+
+    return ((uint8_t)(sofFrame + 1 - pollPhase) & (pollPeriod - 1)) == 0;
+}
+
+/**
+ * @brief 将旋钮报告装入端点3并启动发送
+ * @param dial 旋钮索引
+ */
+static void Radial_ArmReport(__data uint8_t dial) {
+    __xdata uint8_t *reportPtr = (__xdata uint8_t *)&radialReport[dial];
+
+    // 将报告数据加载到发送缓冲区
+    for (__data uint8_t i = 0; i < RADIAL_REPORT_SIZE; i++) {
+        Ep3Buffer[i] = reportPtr[i];
+    }
+
+    // 空闲计时从最近一次发送该旋钮报告开始
+    idleElapsed[dial] = 0;
+
+    // 设置发送长度并启动发送
+    UEP3_T_LEN = RADIAL_REPORT_SIZE;
+    UpPoint3_Busy = 1;
+    UEP3_CTRL = (UEP3_CTRL & ~MASK_UEP_T_RES) | UEP_T_RES_ACK;
+}
+
+/**
+ * @brief 将队首报告装入端点3并启动发送
+ * @details 单个报告的旋转量不超过描述符逻辑范围 ±3600，超出部分留在队首，
+ *          待下一次发送
+ */
+static void Radial_SendQueued() {
+    if (queueCount == 0) {
+        return;
+    }
+
+    __xdata RadialQueueEntry *entry = &reportQueue[queueHead];
+    __xdata RadialReport *report = &radialReport[entry->dial];
+    __data int16_t delta = entry->delta;
+
+    if (delta > RADIAL_DIAL_LOGICAL_MAX) {
+        delta = RADIAL_DIAL_LOGICAL_MAX;
+    } else if (delta < -RADIAL_DIAL_LOGICAL_MAX) {
+        delta = -RADIAL_DIAL_LOGICAL_MAX;
+    }
+
+    report->reportId = RADIAL_REPORT_ID + entry->dial;
+    report->buttonDial = ((uint16_t)delta) & RADIAL_DIAL_MASK;
+    if (entry->button) {
+        report->buttonDial |= RADIAL_BUTTON_MASK;
+    }
+
+    // 输入时间戳只随分段发送的第一个报告统计
+    armedInputTime = entry->inputTime;
+    armedInputTimeValid = entry->timed;
+    entry->timed = false;
+
+    entry->delta -= delta;
+    if (entry->delta == 0) {
+        queueHead = (queueHead + 1) & (RADIAL_QUEUE_SIZE - 1);
+        queueCount--;
+    }
+
+    Radial_ArmReport(entry->dial);
+}
+
+/**
+ * @brief 获取报告队列中第 index 个报告
+ * @param index 相对队首的位置
+ * @return RadialQueueEntry* 报告指针
+ */
+static __xdata RadialQueueEntry *Radial_QueueAt(__data uint8_t index) {
+    return &reportQueue[(queueHead + index) & (RADIAL_QUEUE_SIZE - 1)];
+}
+
+/**
+ * @brief 查找报告队列中位于 index 之前的同一旋钮的报告
+ * @param index 相对队首的位置
+ * @return uint8_t 相对队首的位置，未找到返回 0xFF
+ */
+static uint8_t Radial_QueuePrevious(__data uint8_t index) {
+    __data uint8_t dial = Radial_QueueAt(index)->dial;
+
+    while (index > 0) {
+        index--;
+        if (Radial_QueueAt(index)->dial == dial) {
+            return index;
+        }
+    }
+
+    return 0xFF;
+}
+
+/**
+ * @brief 将报告的旋转量与输入时间戳并入同一旋钮之前的报告
+ * @param to 并入的目标报告
+ * @param from 被并入的报告
+ */
+static void Radial_MergeEntry(__xdata RadialQueueEntry *to,
+                              __xdata RadialQueueEntry *from) {
+    __data int16_t delta = from->delta;
+
+    // 累计值饱和处理，正常使用时远不会达到上限
+    if (delta > 0 && to->delta > RADIAL_PENDING_MAX - delta) {
+        to->delta = RADIAL_PENDING_MAX;
+    } else if (delta < 0 && to->delta < -RADIAL_PENDING_MAX - delta) {
+        to->delta = -RADIAL_PENDING_MAX;
+    } else {
+        to->delta += delta;
+    }
+
+    if (!to->timed && from->timed) {
+        to->inputTime = from->inputTime;
+        to->timed = true;
+    }
+}
+
+/**
+ * @brief 从报告队列中移除第 index 个报告，之后的报告依次前移
+ * @param index 相对队首的位置，不为 0
+ */
+static void Radial_QueueRemove(__data uint8_t index) {
+    for (; index + 1 < queueCount; index++) {
+        *Radial_QueueAt(index) = *Radial_QueueAt(index + 1);
+    }
+
+    queueCount--;
+}
+
+/**
+ * @brief 队列已满时合并已入队的报告，腾出位置
+ * @details 先将不改变按钮状态的旋转报告并入该旋钮之前的报告；
+ *          全部为按钮边沿时，将同一旋钮相邻的一对按下与释放连同旋转量
+ *          并入之前的报告，按钮最终状态不变，旋转量不丢失。
+ *          队首报告可能正在分段发送，不会被移除
+ * @return bool 是否腾出了位置
+ */
+static bool Radial_CompactQueue() {
+    __data uint8_t i;
+    __data uint8_t previous;
+
+    for (i = queueCount - 1; i > 0; i--) {
+        previous = Radial_QueuePrevious(i);
+
+        if (previous != 0xFF &&
+            Radial_QueueAt(previous)->button == Radial_QueueAt(i)->button) {
+            Radial_MergeEntry(Radial_QueueAt(previous), Radial_QueueAt(i));
+            Radial_QueueRemove(i);
+            return true;
+        }
+    }
+
+    for (i = queueCount - 1; i > 0; i--) {
+        previous = Radial_QueuePrevious(i);
+        if (previous == 0xFF || previous == 0) {
+            continue;
+        }
+
+        __data uint8_t first = Radial_QueuePrevious(previous);
+        if (first == 0xFF) {
+            continue;
+        }
+
+        Radial_MergeEntry(Radial_QueueAt(first), Radial_QueueAt(previous));
+        Radial_MergeEntry(Radial_QueueAt(first), Radial_QueueAt(i));
+        Radial_QueueRemove(i);
+        Radial_QueueRemove(previous);
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief 空闲速率到期时重复发送旋钮报告
+ * @details 重复报告保持当前按钮状态，旋转量为 0，避免主机重复累加相对旋转
+ */
+static void Radial_SendIdle() {
+    // 未配置时主机不会轮询端点3，空闲速率保留到重新配置后再生效
+    if (UsbConfig == 0) {
+        return;
+    }
+
+    for (__data uint8_t dial = 0; dial < RADIAL_DIAL_COUNT; dial++) {
+        if (idleRate[dial] == 0 ||
+            idleElapsed[dial] < (uint16_t)idleRate[dial] * 4) {
+            continue;
+        }
+
+        radialReport[dial].reportId = RADIAL_REPORT_ID + dial;
+        radialReport[dial].buttonDial =
+            (queuedButton & (1 << dial)) ? RADIAL_BUTTON_MASK : 0;
+
+        armedInputTimeValid = false;
+        Radial_ArmReport(dial);
+        return;
+    }
+}
+
+/**
+ * @brief USB 总线复位时清除端点3状态和报告队列
+ */
+void resetRadialParameters() {
+    UpPoint3_Busy = 0;
+    armedInputTimeValid = false;
+    pollPhaseValid = false;
+    queueHead = 0;
+    queueCount = 0;
+    queuedButton = 0;
+
+    // 复位后恢复默认空闲速率
+    for (__data uint8_t dial = 0; dial < RADIAL_DIAL_COUNT; dial++) {
+        idleRate[dial] = 0;
+    }
+}
+
+/**
+ * @brief 处理 HID 类 SET_IDLE / GET_IDLE / SET_PROTOCOL / GET_PROTOCOL 请求
+ * @details 报告 ID 为 0 的 SET_IDLE 作用于全部旋钮，GET_IDLE 返回第一个旋钮。
+ *          接口描述符沿用启动键盘子类，但报告只有径向控制器与配置报告，
+ *          无法按启动协议发送键盘报告，因此始终使用报告协议：
+ *          SET_PROTOCOL 切换到启动协议时回复 STALL，GET_PROTOCOL 总是返回
+ *          报告协议
+ * @return 应答数据长度，0xFF 表示不支持的请求
+ */
+uint8_t USB_HIDClassSetup() {
+    __data uint8_t id = UsbSetupBuf->wValueL;
+    __data uint8_t dial = id - RADIAL_REPORT_ID;
+
+    switch (SetupReq) {
+    case HID_SET_IDLE:
+        if (id == 0) {
+            for (dial = 0; dial < RADIAL_DIAL_COUNT; dial++) {
+                idleRate[dial] = UsbSetupBuf->wValueH;
+            }
+        } else if (dial < RADIAL_DIAL_COUNT) {
+            idleRate[dial] = UsbSetupBuf->wValueH;
+        } else {
+            return 0xFF;
+        }
+        return 0;
+
+    case HID_GET_IDLE:
+        if (id == 0) {
+            dial = 0;
+        } else if (dial >= RADIAL_DIAL_COUNT) {
+            return 0xFF;
+        }
+        Ep0Buffer[0] = idleRate[dial];
+        return SetupLen >= 1 ? 1 : 0;
+
+    case HID_SET_PROTOCOL:
+        return UsbSetupBuf->wValueL == HID_PROTOCOL_REPORT ? 0 : 0xFF;
+
+    case HID_GET_PROTOCOL:
+        Ep0Buffer[0] = HID_PROTOCOL_REPORT;
+        return SetupLen >= 1 ? 1 : 0;
+
+    default:
+        return 0xFF;
+    }
+}
+
+/**
+ * @brief USB SOF 中断处理函数，每 1 毫秒帧开始时调用
+ * @details 在主机轮询端点3的前一帧装入队列中的报告，队列为空时按空闲速率
+ *          重复发送报告
+ */
+void USB_SOF() {
+    sofFrame++;
+
+    for (__data uint8_t dial = 0; dial < RADIAL_DIAL_COUNT; dial++) {
+        if (idleElapsed[dial] < 0xFFFF) {
+            idleElapsed[dial]++;
+        }
+    }
+
+    if (!UpPoint3_Busy && Radial_IsArmFrame()) {
+        Radial_SendQueued();
+
+        // 队列为空时按空闲速率重复报告
+        if (!UpPoint3_Busy) {
+            Radial_SendIdle();
+        }
+    }
+}
+
+/**
+ * @brief 统计报告被主机取走时的数据时效
+ * @param age 数据时效（毫秒）
+ */
+static void Radial_RecordAge(__data uint16_t age) {
+    __data uint8_t bin;
+
+    if (age < 4) {
+        bin = age;
+    } else if (age < 8) {
+        bin = 4;
+    } else if (age < 16) {
+        bin = 5;
+    } else if (age < 32) {
+        bin = 6;
+    } else {
+        bin = 7;
+    }
+
+    if (ageHistogram[bin] < 0xFFFF) {
+        ageHistogram[bin]++;
+    }
+}
+#pragma restore
 
 void USB_EP3_IN() {
     UEP3_T_LEN = 0;
-    UEP3_CTRL = UEP3_CTRL & ~MASK_UEP_T_RES | UEP_T_RES_NAK; // Default NAK
+    UEP3_CTRL = (UEP3_CTRL & ~MASK_UEP_T_RES) | UEP_T_RES_NAK; // Default NAK
     UpPoint3_Busy = 0;                                       // Clear busy flag
+
+    // 报告被取走的帧即为主机轮询相位
+    __data uint8_t phase = sofFrame & (pollPeriod - 1);
+
+    if (pollPhaseValid && phase == pollPhase) {
+        pollPhaseHits++;
+    } else {
+        pollPhaseMisses++;
+    }
+
+    pollPhase = phase;
+    pollPhaseValid = true;
+
+    // 统计从输入到主机取走报告的延迟，中断上下文中调用 millis() 的误差可以接受
+    if (armedInputTimeValid) {
+        __data uint16_t latency = (uint16_t)millis() - armedInputTime;
+
+        armedInputTimeValid = false;
+
+        Radial_RecordAge(latency);
+
+        if (latencyCount < 0xFFFF) {
+            latencyCount++;
+            latencySum += latency;
+
+            if (latency < latencyMin) {
+                latencyMin = latency;
+            }
+            if (latency > latencyMax) {
+                latencyMax = latency;
+            }
+        }
+    }
+
+    // 上一个报告已被主机取走，在下一次轮询前一帧装入队列中的下一个报告
+    if (Radial_IsArmFrame()) {
+        Radial_SendQueued();
+    }
 }
 
 /**
@@ -46,12 +447,15 @@ void USB_EP3_IN() {
  */
 void USB_EP3_OUT() {
     if (UEP3_RX_LEN > 0) {
-        // 检查报告 ID
-        if (Ep3Buffer[0] == RADIAL_REPORT_ID) {
+        // 检查报告 ID，并换算为旋钮索引
+        __data uint8_t dial = Ep3Buffer[0] - RADIAL_REPORT_ID;
+
+        if (dial < RADIAL_DIAL_COUNT) {
             // 确保接收到完整的报告数据
             if (UEP3_RX_LEN >= RADIAL_REPORT_SIZE) {
                 // 复制接收到的数据到径向控制器报告结构
-                __xdata uint8_t *reportPtr = (__xdata uint8_t *)&radialReport;
+                __xdata uint8_t *reportPtr =
+                    (__xdata uint8_t *)&radialReport[dial];
                 for (__data uint8_t i = 0; i < RADIAL_REPORT_SIZE; i++) {
                     reportPtr[i] = Ep3Buffer[i];
                 }
@@ -61,13 +465,13 @@ void USB_EP3_OUT() {
 
     // 清空接收长度并设置为 NAK 状态
     UEP3_RX_LEN = 0;
-    UEP3_CTRL = UEP3_CTRL & ~MASK_UEP_R_RES | UEP_R_RES_NAK;
+    UEP3_CTRL = (UEP3_CTRL & ~MASK_UEP_R_RES) | UEP_R_RES_NAK;
 }
 
 /**
  * @brief 发送径向控制器报告
  * @param report 径向控制器报告指针
- * @return bool 发送成功返回 true，失败返回 false
+ * @return bool 发送成功返回 true，发送缓冲区忙碌或失败返回 false
  */
 bool Radial_SendReport(__xdata RadialReport *report) {
     // 参数验证
@@ -82,22 +486,12 @@ bool Radial_SendReport(__xdata RadialReport *report) {
         return false;
     }
 
-    __data uint16_t waitWriteCount = 0;
-
-    // 等待发送缓冲区空闲
-    waitWriteCount = 0;
-    while (UpPoint3_Busy) { // 等待 250ms 或放弃
-        waitWriteCount++;
-        delayMicroseconds(5);
-        if (waitWriteCount >= 50000) {
-            lastError = HID_ERR_BUFFER_BUSY;
-            return false;
-        }
+    // 发送缓冲区忙碌时立即返回，不等待
+    if (UpPoint3_Busy) {
+        lastError = HID_ERR_BUFFER_BUSY;
+        return false;
     }
 
-    // 确保报告 ID 正确
-    report->reportId = RADIAL_REPORT_ID;
-
     // 将报告数据加载到发送缓冲区
     __xdata uint8_t *reportPtr = (__xdata uint8_t *)report;
     for (__data uint8_t i = 0; i < RADIAL_REPORT_SIZE; i++) {
@@ -107,7 +501,7 @@ bool Radial_SendReport(__xdata RadialReport *report) {
     // 设置发送长度并启动发送
     UEP3_T_LEN = RADIAL_REPORT_SIZE;
     UpPoint3_Busy = 1;
-    UEP3_CTRL = UEP3_CTRL & ~MASK_UEP_T_RES | UEP_T_RES_ACK;
+    UEP3_CTRL = (UEP3_CTRL & ~MASK_UEP_T_RES) | UEP_T_RES_ACK;
 
     // 发送成功
     lastError = HID_ERR_NONE;
@@ -116,50 +510,242 @@ bool Radial_SendReport(__xdata RadialReport *report) {
 
 /**
  * @brief 发送径向控制器数据
+ * @details 报告加入发送队列，在主机轮询端点3的前一帧装入端点依次发送，
+ *          函数不会阻塞。按钮状态变化总是单独入队，
+ *          以保证按下、释放与旋转的先后顺序
+ * @param dial 旋钮索引 (0~RADIAL_DIAL_COUNT-1)
  * @param button 按钮状态 (0=释放, 1=按下)
  * @param degree 旋钮角度 (-360~360)
- * @return bool 发送成功返回 true，失败返回 false
+ * @return bool 成功加入队列返回 true，失败返回 false
  */
-bool Radial_SendData(__data uint8_t button, __data int16_t degree) {
-    // 设置按钮状态（bit0）
-    if (button & 0x01) {
-        radialReport.buttonDial |= RADIAL_BUTTON_MASK;
-    } else {
-        radialReport.buttonDial &= ~RADIAL_BUTTON_MASK;
+bool Radial_SendData(__data uint8_t dial, __data uint8_t button,
+                     __data int16_t degree) {
+    if (dial >= RADIAL_DIAL_COUNT) {
+        lastError = HID_ERR_INVALID_PARAM;
+        return false;
+    }
+
+    // 检查USB是否已配置
+    if (UsbConfig == 0) {
+        lastError = HID_ERR_USB_NOT_CONFIGURED;
+        return false;
     }
 
-    // 设置旋钮值（bit1-15）
     if (degree < -360) {
         degree = -360;
     } else if (degree > 360) {
         degree = 360;
     }
 
-    // 首先清除旋钮位
-    radialReport.buttonDial &= RADIAL_BUTTON_MASK;
-    // 然后设置旋钮值（旋钮值从bit1开始）
-    radialReport.buttonDial |= ((uint16_t)(degree * 10)) & RADIAL_DIAL_MASK;
+    // 旋转量换算为 0.1 度
+    __data int16_t delta = degree * 10;
+    __data uint8_t mask = 1 << dial;
+    __data bool merged = false;
+
+    IE_USB = 0;
+
+    // 按钮状态未变化的旋转报告合并到该旋钮最新入队的报告中
+    if (((queuedButton & mask) != 0) == ((button & 0x01) != 0)) {
+        for (__data uint8_t i = queueCount; i > 0; i--) {
+            __xdata RadialQueueEntry *entry =
+                &reportQueue[(queueHead + i - 1) & (RADIAL_QUEUE_SIZE - 1)];
+
+            if (entry->dial != dial) {
+                continue;
+            }
+
+            // 累计值饱和处理，正常使用时远不会达到上限
+            if (delta > 0 && entry->delta > RADIAL_PENDING_MAX - delta) {
+                entry->delta = RADIAL_PENDING_MAX;
+            } else if (delta < 0 &&
+                       entry->delta < -RADIAL_PENDING_MAX - delta) {
+                entry->delta = -RADIAL_PENDING_MAX;
+            } else {
+                entry->delta += delta;
+            }
+
+            // 合并后的报告保留最早的输入时间戳
+            if (!entry->timed && inputTimeValid) {
+                entry->inputTime = inputTime;
+                entry->timed = true;
+            }
+
+            merged = true;
+            break;
+        }
+    }
+
+    if (!merged) {
+        if (queueCount >= RADIAL_QUEUE_SIZE && !Radial_CompactQueue()) {
+            // 无法腾出位置，丢弃报告，该旋钮的入队按钮状态保持不变
+            queueOverflow++;
+            inputTimeValid = false;
+            IE_USB = 1;
+
+            lastError = HID_ERR_BUFFER_BUSY;
+            return false;
+        }
+
+        __xdata RadialQueueEntry *entry =
+            &reportQueue[(queueHead + queueCount) & (RADIAL_QUEUE_SIZE - 1)];
+
+        entry->dial = dial;
+        entry->button = button & 0x01;
+        entry->delta = delta;
+        entry->inputTime = inputTime;
+        entry->timed = inputTimeValid;
+
+        if (entry->button) {
+            queuedButton |= mask;
+        } else {
+            queuedButton &= ~mask;
+        }
+
+        queueCount++;
+        if (queueCount > queueMaxDepth) {
+            queueMaxDepth = queueCount;
+        }
+    }
+
+    inputTimeValid = false;
+
+    // 端点空闲且处于轮询前一帧时立即发送，否则由 SOF 中断在轮询前一帧发送
+    if (!UpPoint3_Busy && Radial_IsArmFrame()) {
+        Radial_SendQueued();
+    }
+
+    IE_USB = 1;
 
-    // 发送报告
-    return Radial_SendReport(&radialReport);
+    lastError = HID_ERR_NONE;
+    return true;
 }
 
 /**
- * @brief 重置径向控制器报告
+ * @brief 重置全部径向控制器报告
  */
 void Radial_ResetReport() {
-    radialReport.reportId = RADIAL_REPORT_ID;
-    radialReport.buttonDial = 0;
+    IE_USB = 0;
+
+    for (__data uint8_t i = 0; i < RADIAL_DIAL_COUNT; i++) {
+        radialReport[i].reportId = RADIAL_REPORT_ID + i;
+        radialReport[i].buttonDial = 0;
+    }
+
+    queueHead = 0;
+    queueCount = 0;
+    queuedButton = 0;
+
+    IE_USB = 1;
 }
 
 /**
  * @brief 获取径向控制器报告指针
+ * @param dial 旋钮索引 (0~RADIAL_DIAL_COUNT-1)
  * @return RadialReport* 径向控制器报告指针
  */
-RadialReport *Radial_GetReport() { return &radialReport; }
+RadialReport *Radial_GetReport(uint8_t dial) { return &radialReport[dial]; }
 
 /**
  * @brief 获取最后一个错误代码
  * @return uint8_t 错误代码
  */
 uint8_t Radial_GetLastError() { return lastError; }
+
+/**
+ * @brief 获取报告队列当前深度
+ * @return uint8_t 队列中等待发送的报告数量
+ */
+uint8_t Radial_GetQueueDepth() { return queueCount; }
+
+/**
+ * @brief 获取报告队列深度峰值
+ * @return uint8_t 队列深度峰值
+ */
+uint8_t Radial_GetQueueMaxDepth() { return queueMaxDepth; }
+
+/**
+ * @brief 获取因报告队列已满且无法合并而丢弃的报告数量
+ * @return uint8_t 丢弃的报告数量
+ */
+uint8_t Radial_GetQueueOverflow() { return queueOverflow; }
+
+/**
+ * @brief 设置下一次 Radial_SendData 对应的输入时间戳，用于统计输入延迟
+ * @param time 输入发生时的 millis() 低 16 位
+ */
+void Radial_SetInputTime(uint16_t time) {
+    inputTime = time;
+    inputTimeValid = true;
+}
+
+/**
+ * @brief 读取并清零输入延迟统计
+ * @param stats 用于返回统计结果
+ */
+void Radial_TakeLatencyStats(__xdata RadialLatencyStats *stats) {
+    IE_USB = 0;
+
+    stats->count = latencyCount;
+    stats->min = latencyCount ? latencyMin : 0;
+    stats->max = latencyMax;
+    stats->average = latencyCount ? (uint16_t)(latencySum / latencyCount) : 0;
+
+    latencyCount = 0;
+    latencyMin = 0xFFFF;
+    latencyMax = 0;
+    latencySum = 0;
+
+    IE_USB = 1;
+}
+
+/**
+ * @brief 主机设置配置时按其读取到的轮询间隔更新轮询周期
+ * @details 由 SET_CONFIGURATION 请求调用，重新测量轮询相位
+ */
+void latchRadialPollInterval() {
+    __data uint8_t period = 1;
+
+    // 全速设备的中断端点实际按不大于 bInterval 的 2 的幂帧轮询
+    while ((uint8_t)(period << 1) <= radialSentInterval) {
+        period <<= 1;
+    }
+
+    pollPeriod = period;
+    pollPhaseValid = false;
+}
+
+/**
+ * @brief 设置 HID 端点轮询间隔，主机下一次读取配置描述符时生效
+ * @details 主机重新枚举前仍按原间隔轮询，轮询周期与相位保持不变
+ * @param interval 轮询间隔（毫秒）
+ */
+void Radial_SetPollInterval(uint8_t interval) { radialPollInterval = interval; }
+
+/**
+ * @brief 获取 HID 端点轮询间隔
+ * @return uint8_t 轮询间隔（毫秒）
+ */
+uint8_t Radial_GetPollInterval() { return radialPollInterval; }
+
+/**
+ * @brief 读取主机轮询相位与报告时效直方图，并清零统计计数
+ * @param stats 用于返回统计结果
+ */
+void Radial_TakePollStats(__xdata RadialPollStats *stats) {
+    IE_USB = 0;
+
+    stats->period = pollPeriod;
+    stats->phase = pollPhaseValid ? pollPhase : 0xFF;
+    stats->hits = pollPhaseHits;
+    stats->misses = pollPhaseMisses;
+
+    for (__data uint8_t i = 0; i < RADIAL_AGE_BINS; i++) {
+        stats->ageHistogram[i] = ageHistogram[i];
+        ageHistogram[i] = 0;
+    }
+
+    pollPhaseHits = 0;
+    pollPhaseMisses = 0;
+
+    IE_USB = 1;
+}
@@ -13,11 +13,23 @@
 #include <stddef.h>
 #include "include/ch5xx.h"
 #include "include/ch5xx_usb.h"
+#include "../Common.h"
 // clang-format on
 
 // 径向控制器报告结构定义
-#define RADIAL_REPORT_ID 0x01
+#define RADIAL_REPORT_ID 0x01 // 第一个旋钮的报告ID，其余旋钮依次递增
+#define RADIAL_DIAL_COUNT EC11_COUNT // 旋钮数量，每个编码器对应一个旋钮
 #define RADIAL_REPORT_SIZE 3 // 报告总大小(字节): reportId(1) + buttonDial(2)
+#define RADIAL_DIAL_LOGICAL_MAX 3600 // 单个报告旋钮值上限(0.1 度)，同报告描述符
+#define RADIAL_PENDING_MAX 32000 // 单个队列报告的累计旋转量上限(0.1 度)
+
+// 报告队列配置，旋转报告合并到同一旋钮最新入队的报告，队列满时合并已入队
+// 的报告腾出位置，旋转量与按钮最终状态不会丢失
+#define RADIAL_QUEUE_SIZE 8 // 报告队列长度，必须为 2 的幂
+
+// HID 协议（SET_PROTOCOL / GET_PROTOCOL）
+#define HID_PROTOCOL_BOOT 0   // 启动协议，不支持
+#define HID_PROTOCOL_REPORT 1 // 报告协议，始终使用
 
 // 错误代码定义
 #define HID_ERR_NONE 0               // 无错误
@@ -28,10 +40,39 @@
 
 // 径向控制器数据结构
 typedef struct {
-    uint8_t reportId;    // 报告ID (固定为1)
+    uint8_t reportId;    // 报告ID (RADIAL_REPORT_ID + 旋钮索引)
     uint16_t buttonDial; // 按钮(bit0)和旋钮(bit1-15)的组合字节
 } RadialReport;
 
+// 报告队列条目
+typedef struct {
+    uint8_t dial;       // 旋钮索引
+    uint8_t button;     // 按钮状态
+    int16_t delta;      // 旋转量（0.1 度）
+    uint16_t inputTime; // 输入时间戳（毫秒）
+    bool timed;         // 是否记录了输入时间戳
+} RadialQueueEntry;
+
+// 输入延迟统计结构（毫秒）
+typedef struct {
+    uint16_t count;   // 样本数量
+    uint16_t min;     // 最小延迟
+    uint16_t average; // 平均延迟
+    uint16_t max;     // 最大延迟
+} RadialLatencyStats;
+
+// 报告时效直方图分档数量
+#define RADIAL_AGE_BINS 8
+
+// 主机轮询相位统计结构
+typedef struct {
+    uint8_t period;  // 主机实际轮询周期（帧）
+    uint8_t phase;   // 主机轮询所在帧相位，未测得时为 0xFF
+    uint16_t hits;   // 报告在预期相位被取走的次数
+    uint16_t misses; // 报告在其他相位被取走的次数
+    uint16_t ageHistogram[RADIAL_AGE_BINS]; // 报告时效直方图
+} RadialPollStats;
+
 // 按钮状态位掩码
 #define RADIAL_BUTTON_MASK 0x0001
 // 旋钮值位掩码
@@ -56,23 +97,26 @@ extern "C" {
 bool Radial_SendReport(__xdata RadialReport *report);
 
 /**
- * @brief 发送径向控制器数据
+ * @brief 发送径向控制器数据，报告加入发送队列，不阻塞
+ * @param dial 旋钮索引 (0~RADIAL_DIAL_COUNT-1)
  * @param button 按钮状态 (0=释放, 1=按下)
  * @param degree 旋钮角度 (-360~360)
- * @return bool 发送成功返回 true，失败返回 false
+ * @return bool 成功加入队列返回 true，失败返回 false
  */
-bool Radial_SendData(__data uint8_t button, __data int16_t degree);
+bool Radial_SendData(__data uint8_t dial, __data uint8_t button,
+                     __data int16_t degree);
 
 /**
- * @brief 重置径向控制器报告
+ * @brief 重置全部径向控制器报告，并清空报告队列
  */
 void Radial_ResetReport();
 
 /**
  * @brief 获取径向控制器报告指针
+ * @param dial 旋钮索引 (0~RADIAL_DIAL_COUNT-1)
  * @return RadialReport* 径向控制器报告指针
  */
-RadialReport *Radial_GetReport();
+RadialReport *Radial_GetReport(uint8_t dial);
 
 /**
  * @brief 获取最后一个错误代码
@@ -80,6 +124,55 @@ RadialReport *Radial_GetReport();
  */
 uint8_t Radial_GetLastError();
 
+/**
+ * @brief 获取报告队列当前深度
+ * @return uint8_t 队列中等待发送的报告数量
+ */
+uint8_t Radial_GetQueueDepth();
+
+/**
+ * @brief 获取报告队列深度峰值
+ * @return uint8_t 队列深度峰值
+ */
+uint8_t Radial_GetQueueMaxDepth();
+
+/**
+ * @brief 获取因报告队列已满且无法合并而丢弃的报告数量
+ * @return uint8_t 丢弃的报告数量
+ */
+uint8_t Radial_GetQueueOverflow();
+
+/**
+ * @brief 设置下一次 Radial_SendData 对应的输入时间戳，用于统计输入延迟
+ * @param time 输入发生时的 millis() 低 16 位
+ */
+void Radial_SetInputTime(uint16_t time);
+
+/**
+ * @brief 读取并清零从输入到主机取走报告的延迟统计
+ * @param stats 用于返回统计结果
+ */
+void Radial_TakeLatencyStats(__xdata RadialLatencyStats *stats);
+
+/**
+ * @brief 设置 HID 端点轮询间隔，主机下一次读取配置描述符时生效
+ * @param interval 轮询间隔（毫秒）
+ */
+void Radial_SetPollInterval(uint8_t interval);
+
+/**
+ * @brief 获取 HID 端点轮询间隔
+ * @return uint8_t 轮询间隔（毫秒）
+ */
+uint8_t Radial_GetPollInterval();
+
+/**
+ * @brief 读取主机轮询相位与报告时效直方图，并清零统计计数
+ * @details 直方图各档依次为 0、1、2、3、4-7、8-15、16-31、32 毫秒以上
+ * @param stats 用于返回统计结果
+ */
+void Radial_TakePollStats(__xdata RadialPollStats *stats);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
@@ -0,0 +1,186 @@
+/*
+  厂商自定义控制请求源文件
+
+  Copyright © 2026 Walkline Wang (walkline@gmail.com)
+  Github: https://github.com/walklinewang/Radial-Controller
+*/
+// clang-format off
+#include <stdint.h>
+#include <stdbool.h>
+#include "include/ch5xx.h"
+#include "include/ch5xx_usb.h"
+#include "USBconstant.h"
+#include "USBhandler.h"
+#include "USBVendor.h"
+#include "../Drivers/EEPROM.h"
+// clang-format on
+
+// 控制传输数据阶段的配置数据源、已传输字节数，以及数据前的报告 ID
+// （0 表示无报告 ID，厂商请求不带报告 ID，HID 特征报告带报告 ID）
+__xdata uint8_t *__xdata pVendor;
+__xdata uint8_t vendorOffset = 0;
+__xdata uint8_t vendorPrefix = 0;
+
+// 主机写入的配置数据，接收完成后由主循环取出并保存
+__xdata uint8_t vendorConfig[CONFIG_STRUCT_SIZE];
+volatile __xdata uint8_t vendorStatus = VENDOR_STATUS_OK;
+volatile __bit vendorReceived = 0; // 配置数据已接收完成，等待主循环取出
+
+#pragma save
+#pragma nooverlay
+/**
+ * @brief 将配置数据的下一个数据包复制到端点0缓冲区
+ * @return 数据包长度
+ */
+static uint8_t Vendor_LoadPacket() {
+    __data uint8_t len =
+        SetupLen >= DEFAULT_ENDP0_SIZE ? DEFAULT_ENDP0_SIZE : SetupLen;
+
+    for (__data uint8_t i = 0; i < len; i++) {
+        __data uint8_t pos = vendorOffset + i;
+
+        if (vendorPrefix) {
+            Ep0Buffer[i] = pos == 0 ? vendorPrefix : pVendor[pos - 1];
+        } else {
+            Ep0Buffer[i] = pVendor[pos];
+        }
+    }
+    vendorOffset += len;
+    SetupLen -= len;
+
+    return len;
+}
+
+/**
+ * @brief 开始读取配置数据的控制传输
+ * @param prefix 数据前的报告 ID，0 表示无
+ * @return 首个数据包长度
+ */
+static uint8_t Vendor_BeginGet(__data uint8_t prefix) {
+    __data uint8_t total = CONFIG_STRUCT_SIZE + (prefix ? 1 : 0);
+
+    pVendor = (__xdata uint8_t *)EEPROM_GetConfigData();
+    vendorPrefix = prefix;
+    vendorOffset = 0;
+    if (SetupLen > total) {
+        SetupLen = total; // Limit length
+    }
+
+    // Feature reports share the vendor data stages in USB_EP0_IN
+    SetupReq = VENDOR_GET_CONFIG;
+    return Vendor_LoadPacket();
+}
+
+/**
+ * @brief 开始写入配置数据的控制传输
+ * @param prefix 数据前的报告 ID，0 表示无
+ * @return 0 表示接收数据，0xFF 表示拒绝请求
+ */
+static uint8_t Vendor_BeginSet(__data uint8_t prefix) {
+    // Only whole structs, and not while the last one is being saved
+    if (SetupLen != CONFIG_STRUCT_SIZE + (prefix ? 1 : 0) ||
+        vendorStatus == VENDOR_STATUS_PENDING) {
+        return 0xFF;
+    }
+
+    vendorPrefix = prefix;
+    vendorOffset = 0;
+
+    // Feature reports share the vendor data stages in USB_EP0_OUT
+    SetupReq = VENDOR_SET_CONFIG;
+    return 0;
+}
+
+/**
+ * @brief 处理厂商请求的 SETUP 阶段
+ * @return 首个数据包长度，0xFF 表示不支持的请求
+ */
+uint8_t USB_VendorSetup() {
+    __data uint8_t isIn = UsbSetupBuf->bRequestType & USB_REQ_TYP_IN;
+
+    switch (SetupReq) {
+    case VENDOR_GET_CONFIG:
+        return isIn ? Vendor_BeginGet(0) : 0xFF;
+
+    case VENDOR_SET_CONFIG:
+        return isIn ? 0xFF : Vendor_BeginSet(0);
+
+    case VENDOR_GET_STATUS:
+        if (!isIn) {
+            return 0xFF;
+        }
+        Ep0Buffer[0] = vendorStatus;
+        return SetupLen >= 1 ? 1 : 0;
+
+    default:
+        return 0xFF; // command not supported
+    }
+}
+
+/**
+ * @brief 处理 HID 类 GET_REPORT / SET_REPORT 请求中的配置特征报告
+ * @return 首个数据包长度，0xFF 表示不支持的报告
+ */
+uint8_t USB_ConfigReportSetup() {
+    // wValue: report type (3 = feature) in the high byte, report ID low
+    if (UsbSetupBuf->wValueH != 3 ||
+        UsbSetupBuf->wValueL != CONFIG_REPORT_ID) {
+        return 0xFF;
+    }
+
+    if (SetupReq == HID_GET_REPORT) {
+        return Vendor_BeginGet(CONFIG_REPORT_ID);
+    }
+    return Vendor_BeginSet(CONFIG_REPORT_ID);
+}
+
+/**
+ * @brief 处理厂商请求的 IN 数据阶段
+ */
+void USB_VendorIn() {
+    UEP0_T_LEN = Vendor_LoadPacket();
+    UEP0_CTRL ^= bUEP_T_TOG; // Switch between DATA0 and DATA1
+}
+
+/**
+ * @brief 处理厂商请求的 OUT 数据阶段
+ */
+void USB_VendorOut() {
+    if (U_TOG_OK) {
+        __data uint8_t total = CONFIG_STRUCT_SIZE + (vendorPrefix ? 1 : 0);
+        __data uint8_t len = USB_RX_LEN;
+
+        if (len > total - vendorOffset) {
+            len = total - vendorOffset;
+        }
+        for (__data uint8_t i = 0; i < len; i++) {
+            __data uint8_t pos = vendorOffset + i;
+
+            if (!vendorPrefix) {
+                vendorConfig[pos] = Ep0Buffer[i];
+            } else if (pos > 0) {
+                vendorConfig[pos - 1] = Ep0Buffer[i]; // Skip the report ID
+            }
+        }
+        vendorOffset += len;
+        UEP0_CTRL ^= bUEP_R_TOG;
+
+        if (vendorOffset == total) {
+            vendorStatus = VENDOR_STATUS_PENDING;
+            vendorReceived = 1;
+        }
+    }
+    UEP0_T_LEN = 0; // Status stage answers with a 0-length packet
+}
+#pragma restore
+
+const __xdata uint8_t *Vendor_TakeConfig() {
+    if (!vendorReceived) {
+        return NULL;
+    }
+
+    vendorReceived = 0;
+    return vendorConfig;
+}
+
+void Vendor_SetStatus(uint8_t status) { vendorStatus = status; }
@@ -0,0 +1,55 @@
+/*
+  厂商自定义控制请求头文件
+
+  Copyright © 2026 Walkline Wang (walkline@gmail.com)
+  Github: https://github.com/walklinewang/Radial-Controller
+*/
+#ifndef __USB_VENDOR_H__
+#define __USB_VENDOR_H__
+
+// clang-format off
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "include/ch5xx.h"
+#include "include/ch5xx_usb.h"
+// clang-format on
+
+// 厂商请求代码（bmRequestType 为厂商类型、接收者为设备），避开标准、CDC 与
+// HID 类请求代码
+#define VENDOR_GET_CONFIG 0x30 // 读取 32 字节配置结构体（设备到主机）
+#define VENDOR_SET_CONFIG 0x31 // 写入 32 字节配置结构体并保存（主机到设备）
+#define VENDOR_GET_STATUS 0x32 // 读取上一次写入配置的结果（1 字节）
+
+// HID 配置特征报告，数据为不含报告 ID 的配置结构体，长度与 eeprom_config_t 一致
+#define CONFIG_REPORT_ID 0x10
+#define CONFIG_REPORT_LENGTH 32
+
+// 写入配置的结果
+#define VENDOR_STATUS_OK 0      // 空闲或已成功保存
+#define VENDOR_STATUS_PENDING 1 // 已接收，等待主循环保存
+#define VENDOR_STATUS_INVALID 2 // 配置参数无效，已恢复原配置
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 取出主机通过 VENDOR_SET_CONFIG 或配置特征报告写入的配置数据
+ * @details 主循环调用。返回数据后状态保持为 VENDOR_STATUS_PENDING，期间新的
+ *          写入请求回复 STALL，直至调用 Vendor_SetStatus 报告保存结果
+ * @return 配置数据指针（CONFIG_STRUCT_SIZE 字节），无新数据时返回 NULL
+ */
+const __xdata uint8_t *Vendor_TakeConfig();
+
+/**
+ * @brief 设置写入配置的结果，供主机通过 VENDOR_GET_STATUS 读取
+ * @param status 写入结果
+ */
+void Vendor_SetStatus(uint8_t status);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif
@@ -3,6 +3,8 @@
  */
 
 #include "USBconstant.h"
+#include "USBVendor.h"
+#include "../Common.h"
 
 // Device descriptor
 __code USB_Descriptor_Device_t DeviceDescriptor = {
@@ -26,6 +28,186 @@ __code USB_Descriptor_Device_t DeviceDescriptor = {
     .NumberOfConfigurations = 1
 };
 
+/* 附加旋钮的径向控制器 TLC，每个旋钮使用独立的报告 ID，格式与第一个旋钮相同 */
+#define RADIAL_CONTROLLER_TLC(report_id)                                       \
+    0x05, 0x01,       /* USAGE_PAGE (Generic Desktop)            */           \
+    0x09, 0x0e,       /* USAGE (System Multi-Axis Controller)    */           \
+    0xa1, 0x01,       /* COLLECTION (Application)                */           \
+    0x85, report_id,  /*   REPORT_ID                             */           \
+    0x05, 0x0d,       /*   USAGE_PAGE (Digitizers)               */           \
+    0x09, 0x21,       /*   USAGE (Puck)                          */           \
+    0xa1, 0x00,       /*   COLLECTION (Physical)                 */           \
+    0x05, 0x09,       /*     USAGE_PAGE (Buttons)                */           \
+    0x09, 0x01,       /*     USAGE (Button 1)                    */           \
+    0x95, 0x01,       /*     REPORT_COUNT (1)                    */           \
+    0x75, 0x01,       /*     REPORT_SIZE (1)                     */           \
+    0x15, 0x00,       /*     LOGICAL_MINIMUM (0)                 */           \
+    0x25, 0x01,       /*     LOGICAL_MAXIMUM (1)                 */           \
+    0x81, 0x02,       /*     INPUT (Data,Var,Abs)                */           \
+    0x05, 0x01,       /*     USAGE_PAGE (Generic Desktop)        */           \
+    0x09, 0x37,       /*     USAGE (Dial)                        */           \
+    0x95, 0x01,       /*     REPORT_COUNT (1)                    */           \
+    0x75, 0x0f,       /*     REPORT_SIZE (15)                    */           \
+    0x55, 0x0f,       /*     UNIT_EXPONENT (-1)                  */           \
+    0x65, 0x14,       /*     UNIT (Degrees, English Rotation)    */           \
+    0x36, 0xf0, 0xf1, /*     PHYSICAL_MINIMUM (-3600)            */           \
+    0x46, 0x10, 0x0e, /*     PHYSICAL_MAXIMUM (3600)             */           \
+    0x16, 0xf0, 0xf1, /*     LOGICAL_MINIMUM (-3600)             */           \
+    0x26, 0x10, 0x0e, /*     LOGICAL_MAXIMUM (3600)              */           \
+    0x81, 0x06,       /*     INPUT (Data,Var,Rel)                */           \
+    0xc0,             /*   END_COLLECTION (Physical)             */           \
+    0xc0              /* END_COLLECTION (Application)            */
+
+// HID 报告描述符。必须定义在配置描述符之前：HIDReportLength 使用
+// sizeof(ReportDescriptor)，对头文件中未指定长度的 extern 数组求 sizeof
+// 不合法，主机测试所用的 gcc 会拒绝编译。描述符内容与定义位置无关
+__code uint8_t ReportDescriptor[] = {
+    // Integrated Radial Controller TLC
+    0x05, 0x01,          // USAGE_PAGE (Generic Desktop)
+    0x09, 0x0e,          // USAGE (System Multi-Axis Controller)
+    0xa1, 0x01,          // COLLECTION (Application)
+    0x85, 0x01,          //   REPORT_ID (Radial Controller)
+    0x05, 0x0d,          //   USAGE_PAGE (Digitizers)
+    0x09, 0x21,          //   USAGE (Puck)
+    0xa1, 0x00,          //   COLLECTION (Physical)
+    0x05, 0x09,          //     USAGE_PAGE (Buttons)
+    0x09, 0x01,          //     USAGE (Button 1)
+    0x95, 0x01,          //     REPORT_COUNT (1)
+    0x75, 0x01,          //     REPORT_SIZE (1)
+    0x15, 0x00,          //     LOGICAL_MINIMUM (0)
+    0x25, 0x01,          //     LOGICAL_MAXIMUM (1)
+    0x81, 0x02,          //     INPUT (Data,Var,Abs)
+    0x05, 0x01,          //     USAGE_PAGE (Generic Desktop)
+    0x09, 0x37,          //     USAGE (Dial)
+    0x95, 0x01,          //     REPORT_COUNT (1)
+    0x75, 0x0f,          //     REPORT_SIZE (15)
+    0x55, 0x0f,          //     UNIT_EXPONENT (-1)
+    0x65, 0x14,          //     UNIT (Degrees, English Rotation)
+    0x36, 0xf0, 0xf1,    //     PHYSICAL_MINIMUM (-3600)
+    0x46, 0x10, 0x0e,    //     PHYSICAL_MAXIMUM (3600)
+    0x16, 0xf0, 0xf1,    //     LOGICAL_MINIMUM (-3600)
+    0x26, 0x10, 0x0e,    //     LOGICAL_MAXIMUM (3600)
+    0x81, 0x06,          //     INPUT (Data,Var,Rel)
+
+    // 0x09, 0x30,          //     USAGE (X)
+    // 0x75, 0x10,          //     REPORT_SIZE (16)
+    // 0x55, 0x0d,          //     UNIT_EXPONENT (-3)
+    // 0x65, 0x13,          //     UNIT (Inch,EngLinear)
+    // 0x35, 0x00,          //     PHYSICAL_MINIMUM (0)
+    // 0x46, 0xc0, 0x5d,    //     PHYSICAL_MAXIMUM (24000)
+    // 0x15, 0x00,          //     LOGICAL_MINIMUM (0)
+    // 0x26, 0xff, 0x7f,    //     LOGICAL_MAXIMUM (32767)
+    // 0x81, 0x02,          //     INPUT (Data,Var,Abs) 
+    // 0x09, 0x31,          //     USAGE (Y)
+    // 0x46, 0xb0, 0x36,    //     PHYSICAL_MAXIMUM (14000)
+    // 0x81, 0x02,          //     INPUT (Data,Var,Abs)
+    // 0x05, 0x0d,          //     USAGE_PAGE (Digitizers)
+    // 0x09, 0x48,          //     USAGE (Width)
+    // 0x36, 0xb8, 0x0b,    //     PHYSICAL_MINIMUM (3000)
+    // 0x46, 0xb8, 0x0b,    //     PHYSICAL_MAXIMUM (3000)
+    // 0x16, 0xb8, 0x0b,    //     LOGICAL_MINIMUM (3000)
+    // 0x26, 0xb8, 0x0b,    //     LOGICAL_MAXIMUM (3000)
+    // 0x81, 0x03,          //     INPUT (Cnst,Var,Abs)
+
+    0xc0,                //   END_COLLECTION (Physical)
+
+    // 0x85, 0x02,          //   REPORT_ID (Haptic Feedback)
+    // 0x05, 0x0e,          //   USAGE_PAGE (Haptics)
+    // 0x09, 0x01,          //   USAGE (Simple Haptic Controller)
+    // 0xa1, 0x02,          //   COLLECTION (Logical)
+    // 0x09, 0x20,          //     USAGE (Auto Trigger)
+    // 0x16, 0x00, 0x10,    //     LOGICAL_MINIMUM (0x1000)
+    // 0x26, 0x04, 0x10,    //     LOGICAL_MAXIMUM (0x1004)
+    // 0x95, 0x01,          //     REPORT_COUNT (1)
+    // 0x75, 0x10,          //     REPORT_SIZE (16)
+    // 0xb1, 0x02,          //     FEATURE (Data,Var,Abs)
+    // 0x09, 0x21,          //     USAGE (Manual Trigger)
+    // 0x91, 0x02,          //     OUTPUT (Data,Var,Abs)
+    // 0x09, 0x22,          //     USAGE (Auto Trigger Associated Control)
+    // 0x17, 0x37,
+    // 0x00, 0x01, 0x00,    //     LOGICAL_MINIMUM (0x00010037)
+    // 0x27, 0x37,
+    // 0x00, 0x01, 0x00,    //     LOGICAL_MAXIMUM (0x00010037)
+    // 0x95, 0x01,          //     REPORT_COUNT (1)
+    // 0x75, 0x20,          //     REPORT_SIZE (32)
+    // 0xb1, 0x03,          //     FEATURE (Cnst,Var,Abs)
+    // 0x09, 0x23,          //     USAGE (Intensity)
+    // 0x15, 0x00,          //     LOGICAL_MINIMUM (0)
+    // 0x25, 0x7f,          //     LOGICAL_MAXIMUM (127)
+    // 0x75, 0x08,          //     REPORT_SIZE (8)
+    // 0x91, 0x02,          //     OUTPUT (Data,Var,Abs)
+    // 0x09, 0x23,          //     USAGE (Intensity)
+    // 0xb1, 0x02,          //     FEATURE (Data,Var,Abs)
+    // 0x09, 0x24,          //     USAGE (Repeat Count)
+    // 0x91, 0x02,          //     OUTPUT (Data,Var,Abs)
+    // 0x09, 0x24,          //     USAGE (Repeat Count)
+    // 0xb1, 0x02,          //     FEATURE (Data,Var,Abs)
+    // 0x09, 0x25,          //     USAGE (Retrigger Period)
+    // 0x91, 0x02,          //     OUTPUT (Data,Var,Abs)
+    // 0x09, 0x25,          //     USAGE (Retrigger Period)
+    // 0xb1, 0x02,          //     FEATURE (Data,Var,Abs)
+    // 0x09, 0x28,          //     USAGE (Waveform Cutoff Time)
+    // 0x26, 0xff, 0x7f,    //     LOGICAL_MAXIMUM (32,767)
+    // 0x75, 0x10,          //     REPORT_SIZE (16)
+    // 0xb1, 0x02,          //     FEATURE (Data,Var,Abs)
+    // 0x05, 0x0e,          //     USAGE_PAGE (Haptics)
+    // 0x09, 0x10,          //     USAGE (Waveform List)
+    // 0xa1, 0x02,          //     COLLECTION (Logical)
+    // 0x05, 0x0A,          //       USAGE_PAGE (Ordinal)
+    // 0x09, 0x03,          //       USAGE (Ordinal 3)
+    // 0x95, 0x01,          //       REPORT_COUNT (1)
+    // 0x75, 0x08,          //       REPORT_SIZE (8)
+    // 0x15, 0x03,          //       LOGICAL_MINIMUM (3)
+    // 0x25, 0x03,          //       LOGICAL_MAXIMUM (3)
+    // 0x36, 0x03, 0x10,    //       PHYSICAL_MINIMUM (0x1003)
+    // 0x46, 0x03, 0x10,    //       PHYSICAL_MAXIMUM (0x1003)
+    // 0xb1, 0x03,          //       FEATURE (Cnst,Var,Abs)
+    // 0x09, 0x04,          //       USAGE (Ordinal 4)
+    // 0x15, 0x04,          //       LOGICAL_MINIMUM (4)
+    // 0x25, 0x04,          //       LOGICAL_MAXIMUM (4)
+    // 0x36, 0x04, 0x10,    //       PHYSICAL_MINIMUM (0x1004)
+    // 0x46, 0x04, 0x10,    //       PHYSICAL_MAXIMUM (0x1004)
+    // 0xb1, 0x03,          //       FEATURE (Cnst,Var,Abs)
+    // 0xc0,                //     END_COLLECTION (Logical)
+    // 0x05, 0x0e,          //     USAGE_PAGE (Haptics)
+    // 0x09, 0x11,          //     USAGE (Duration List)
+    // 0xa1, 0x02,          //     COLLECTION (Logical)
+    // 0x05, 0x0a,          //       USAGE_PAGE (Ordinal)
+    // 0x09, 0x03,          //       USAGE (Ordinal 3)
+    // 0x09, 0x04,          //       USAGE (Ordinal 4)
+    // 0x15, 0x00,          //       LOGICAL_MINIMUM (0)
+    // 0x26, 0xff, 0x0f,    //       LOGICAL_MAXIMUM (4095)
+    // 0x95, 0x02,          //       REPORT_COUNT (2)
+    // 0x75, 0x08,          //       REPORT_SIZE (8)
+    // 0xb1, 0x02,          //       FEATURE (Data,Var,Abs)
+    // 0xc0,                //     END_COLLECTION (Logical)
+    // 0xc0,                //   END_COLLECTION (Logical)
+    0xc0,                // END_COLLECTION (Application)
+
+#if EC11_COUNT >= 2
+    RADIAL_CONTROLLER_TLC(0x02),
+#endif
+#if EC11_COUNT >= 3
+    RADIAL_CONTROLLER_TLC(0x03),
+#endif
+#if EC11_COUNT >= 4
+    RADIAL_CONTROLLER_TLC(0x04),
+#endif
+
+    // Configuration TLC, feature report carrying eeprom_config_t
+    0x06, 0x00, 0xff,    // USAGE_PAGE (Vendor Defined Page 1)
+    0x09, 0x01,          // USAGE (Vendor Usage 1)
+    0xa1, 0x01,          // COLLECTION (Application)
+    0x85, CONFIG_REPORT_ID, //   REPORT_ID (Configuration)
+    0x09, 0x02,          //   USAGE (Vendor Usage 2)
+    0x15, 0x00,          //   LOGICAL_MINIMUM (0)
+    0x26, 0xff, 0x00,    //   LOGICAL_MAXIMUM (255)
+    0x75, 0x08,          //   REPORT_SIZE (8)
+    0x95, CONFIG_REPORT_LENGTH, // REPORT_COUNT (32)
+    0xb1, 0x02,          //   FEATURE (Data,Var,Abs)
+    0xc0,                // END_COLLECTION (Application)
+};
+
 /** Configuration descriptor structure. This descriptor, located in FLASH
  * memory, describes the usage of the device in one of its supported
  * configurations, including information about any device interfaces and
@@ -180,7 +362,8 @@ __code USB_Descriptor_Configuration_t ConfigurationDescriptor = {
                                  (EP_TYPE_INTERRUPT | ENDPOINT_ATTR_NO_SYNC |
                                   ENDPOINT_USAGE_DATA),
                              .EndpointSize = KEYBOARD_EPSIZE,
-                             .PollingIntervalMS = 10}
+                             // 发送描述符时按当前配置修改
+                             .PollingIntervalMS = HID_POLL_INTERVAL_DEFAULT}
 };
 
 // String Descriptors
@@ -213,127 +396,3 @@ __code uint16_t CDCDescriptor[] = {
     'C', 'D', 'C', ' ',
     'S', 'e', 'r', 'i', 'a', 'l',
 };
-
-__code uint8_t ReportDescriptor[] = {
-    // Integrated Radial Controller TLC
-    0x05, 0x01,          // USAGE_PAGE (Generic Desktop)
-    0x09, 0x0e,          // USAGE (System Multi-Axis Controller)
-    0xa1, 0x01,          // COLLECTION (Application)
-    0x85, 0x01,          //   REPORT_ID (Radial Controller)
-    0x05, 0x0d,          //   USAGE_PAGE (Digitizers)
-    0x09, 0x21,          //   USAGE (Puck)
-    0xa1, 0x00,          //   COLLECTION (Physical)
-    0x05, 0x09,          //     USAGE_PAGE (Buttons)
-    0x09, 0x01,          //     USAGE (Button 1)
-    0x95, 0x01,          //     REPORT_COUNT (1)
-    0x75, 0x01,          //     REPORT_SIZE (1)
-    0x15, 0x00,          //     LOGICAL_MINIMUM (0)
-    0x25, 0x01,          //     LOGICAL_MAXIMUM (1)
-    0x81, 0x02,          //     INPUT (Data,Var,Abs)
-    0x05, 0x01,          //     USAGE_PAGE (Generic Desktop)
-    0x09, 0x37,          //     USAGE (Dial)
-    0x95, 0x01,          //     REPORT_COUNT (1)
-    0x75, 0x0f,          //     REPORT_SIZE (15)
-    0x55, 0x0f,          //     UNIT_EXPONENT (-1)
-    0x65, 0x14,          //     UNIT (Degrees, English Rotation)
-    0x36, 0xf0, 0xf1,    //     PHYSICAL_MINIMUM (-3600)
-    0x46, 0x10, 0x0e,    //     PHYSICAL_MAXIMUM (3600)
-    0x16, 0xf0, 0xf1,    //     LOGICAL_MINIMUM (-3600)
-    0x26, 0x10, 0x0e,    //     LOGICAL_MAXIMUM (3600)
-    0x81, 0x06,          //     INPUT (Data,Var,Rel)
-
-    // 0x09, 0x30,          //     USAGE (X)
-    // 0x75, 0x10,          //     REPORT_SIZE (16)
-    // 0x55, 0x0d,          //     UNIT_EXPONENT (-3)
-    // 0x65, 0x13,          //     UNIT (Inch,EngLinear)
-    // 0x35, 0x00,          //     PHYSICAL_MINIMUM (0)
-    // 0x46, 0xc0, 0x5d,    //     PHYSICAL_MAXIMUM (24000)
-    // 0x15, 0x00,          //     LOGICAL_MINIMUM (0)
-    // 0x26, 0xff, 0x7f,    //     LOGICAL_MAXIMUM (32767)
-    // 0x81, 0x02,          //     INPUT (Data,Var,Abs) 
-    // 0x09, 0x31,          //     USAGE (Y)
-    // 0x46, 0xb0, 0x36,    //     PHYSICAL_MAXIMUM (14000)
-    // 0x81, 0x02,          //     INPUT (Data,Var,Abs)
-    // 0x05, 0x0d,          //     USAGE_PAGE (Digitizers)
-    // 0x09, 0x48,          //     USAGE (Width)
-    // 0x36, 0xb8, 0x0b,    //     PHYSICAL_MINIMUM (3000)
-    // 0x46, 0xb8, 0x0b,    //     PHYSICAL_MAXIMUM (3000)
-    // 0x16, 0xb8, 0x0b,    //     LOGICAL_MINIMUM (3000)
-    // 0x26, 0xb8, 0x0b,    //     LOGICAL_MAXIMUM (3000)
-    // 0x81, 0x03,          //     INPUT (Cnst,Var,Abs)
-
-    0xc0,                //   END_COLLECTION (Physical)
-
-    // 0x85, 0x02,          //   REPORT_ID (Haptic Feedback)
-    // 0x05, 0x0e,          //   USAGE_PAGE (Haptics)
-    // 0x09, 0x01,          //   USAGE (Simple Haptic Controller)
-    // 0xa1, 0x02,          //   COLLECTION (Logical)
-    // 0x09, 0x20,          //     USAGE (Auto Trigger)
-    // 0x16, 0x00, 0x10,    //     LOGICAL_MINIMUM (0x1000)
-    // 0x26, 0x04, 0x10,    //     LOGICAL_MAXIMUM (0x1004)
-    // 0x95, 0x01,          //     REPORT_COUNT (1)
-    // 0x75, 0x10,          //     REPORT_SIZE (16)
-    // 0xb1, 0x02,          //     FEATURE (Data,Var,Abs)
-    // 0x09, 0x21,          //     USAGE (Manual Trigger)
-    // 0x91, 0x02,          //     OUTPUT (Data,Var,Abs)
-    // 0x09, 0x22,          //     USAGE (Auto Trigger Associated Control)
-    // 0x17, 0x37,
-    // 0x00, 0x01, 0x00,    //     LOGICAL_MINIMUM (0x00010037)
-    // 0x27, 0x37,
-    // 0x00, 0x01, 0x00,    //     LOGICAL_MAXIMUM (0x00010037)
-    // 0x95, 0x01,          //     REPORT_COUNT (1)
-    // 0x75, 0x20,          //     REPORT_SIZE (32)
-    // 0xb1, 0x03,          //     FEATURE (Cnst,Var,Abs)
-    // 0x09, 0x23,          //     USAGE (Intensity)
-    // 0x15, 0x00,          //     LOGICAL_MINIMUM (0)
-    // 0x25, 0x7f,          //     LOGICAL_MAXIMUM (127)
-    // 0x75, 0x08,          //     REPORT_SIZE (8)
-    // 0x91, 0x02,          //     OUTPUT (Data,Var,Abs)
-    // 0x09, 0x23,          //     USAGE (Intensity)
-    // 0xb1, 0x02,          //     FEATURE (Data,Var,Abs)
-    // 0x09, 0x24,          //     USAGE (Repeat Count)
-    // 0x91, 0x02,          //     OUTPUT (Data,Var,Abs)
-    // 0x09, 0x24,          //     USAGE (Repeat Count)
-    // 0xb1, 0x02,          //     FEATURE (Data,Var,Abs)
-    // 0x09, 0x25,          //     USAGE (Retrigger Period)
-    // 0x91, 0x02,          //     OUTPUT (Data,Var,Abs)
-    // 0x09, 0x25,          //     USAGE (Retrigger Period)
-    // 0xb1, 0x02,          //     FEATURE (Data,Var,Abs)
-    // 0x09, 0x28,          //     USAGE (Waveform Cutoff Time)
-    // 0x26, 0xff, 0x7f,    //     LOGICAL_MAXIMUM (32,767)
-    // 0x75, 0x10,          //     REPORT_SIZE (16)
-    // 0xb1, 0x02,          //     FEATURE (Data,Var,Abs)
-    // 0x05, 0x0e,          //     USAGE_PAGE (Haptics)
-    // 0x09, 0x10,          //     USAGE (Waveform List)
-    // 0xa1, 0x02,          //     COLLECTION (Logical)
-    // 0x05, 0x0A,          //       USAGE_PAGE (Ordinal)
-    // 0x09, 0x03,          //       USAGE (Ordinal 3)
-    // 0x95, 0x01,          //       REPORT_COUNT (1)
-    // 0x75, 0x08,          //       REPORT_SIZE (8)
-    // 0x15, 0x03,          //       LOGICAL_MINIMUM (3)
-    // 0x25, 0x03,          //       LOGICAL_MAXIMUM (3)
-    // 0x36, 0x03, 0x10,    //       PHYSICAL_MINIMUM (0x1003)
-    // 0x46, 0x03, 0x10,    //       PHYSICAL_MAXIMUM (0x1003)
-    // 0xb1, 0x03,          //       FEATURE (Cnst,Var,Abs)
-    // 0x09, 0x04,          //       USAGE (Ordinal 4)
-    // 0x15, 0x04,          //       LOGICAL_MINIMUM (4)
-    // 0x25, 0x04,          //       LOGICAL_MAXIMUM (4)
-    // 0x36, 0x04, 0x10,    //       PHYSICAL_MINIMUM (0x1004)
-    // 0x46, 0x04, 0x10,    //       PHYSICAL_MAXIMUM (0x1004)
-    // 0xb1, 0x03,          //       FEATURE (Cnst,Var,Abs)
-    // 0xc0,                //     END_COLLECTION (Logical)
-    // 0x05, 0x0e,          //     USAGE_PAGE (Haptics)
-    // 0x09, 0x11,          //     USAGE (Duration List)
-    // 0xa1, 0x02,          //     COLLECTION (Logical)
-    // 0x05, 0x0a,          //       USAGE_PAGE (Ordinal)
-    // 0x09, 0x03,          //       USAGE (Ordinal 3)
-    // 0x09, 0x04,          //       USAGE (Ordinal 4)
-    // 0x15, 0x00,          //       LOGICAL_MINIMUM (0)
-    // 0x26, 0xff, 0x0f,    //       LOGICAL_MAXIMUM (4095)
-    // 0x95, 0x02,          //       REPORT_COUNT (2)
-    // 0x75, 0x08,          //       REPORT_SIZE (8)
-    // 0xb1, 0x02,          //       FEATURE (Data,Var,Abs)
-    // 0xc0,                //     END_COLLECTION (Logical)
-    // 0xc0,                //   END_COLLECTION (Logical)
-    0xc0,                // END_COLLECTION (Application)
-};
@@ -10,10 +10,15 @@
 #include "usbCommonDescriptors/HIDClassCommon.h"
 // clang-format on
 
+// 端点1：CDC 数据 OUT（0~63）与 CDC 通知 IN（64~71）
+// 端点2：CDC 数据 IN 乒乓双缓冲（0~63、64~127）
+// 端点3：HID IN，报告不超过 8 字节
+// CDC 数据 OUT 不与 IN 共用端点2：端点2 同时开启收发与双缓冲需要
+// 256 字节，超出 USER_USB_RAM
 #define EP0_ADDR 0
 #define EP1_ADDR 10
-#define EP2_ADDR 20
-#define EP3_ADDR 148
+#define EP2_ADDR 82
+#define EP3_ADDR 210
 
 #define SET_LINE_CODING                                                        \
     0X20 // Configures DTE rate, stop-bits, parity, and number-of-character
@@ -26,7 +31,7 @@
 #define CDC_NOTIFICATION_EPADDR 0x81
 #define CDC_NOTIFICATION_EPSIZE 0x08
 #define CDC_TX_EPADDR 0x82
-#define CDC_RX_EPADDR 0x02
+#define CDC_RX_EPADDR 0x01
 #define CDC_TXRX_EPSIZE 0x40
 
 #define KEYBOARD_EPADDR 0x83
@@ -3,24 +3,41 @@
  */
 #include "USBhandler.h"
 #include "USBconstant.h"
+#include "USBVendor.h"
 
 // CDC functions:
 void resetCDCParameters();
+void suspendCDCHandler();
 void setLineCodingHandler();
 uint16_t getLineCodingHandler();
 void setControlLineStateHandler();
+void USB_EP1_OUT();
+void USB_EP1_IN();
 void USB_EP2_IN();
-void USB_EP2_OUT();
 void USB_EP3_IN();
 
+// Radial functions:
+void resetRadialParameters();
+void latchRadialPollInterval();
+void USB_SOF();
+uint8_t USB_HIDClassSetup();
+extern __xdata uint8_t radialPollInterval;
+extern __xdata uint8_t radialSentInterval;
+
+// Vendor functions:
+uint8_t USB_VendorSetup();
+uint8_t USB_ConfigReportSetup();
+void USB_VendorIn();
+void USB_VendorOut();
+
 // clang-format off
 __xdata __at (EP0_ADDR) uint8_t Ep0Buffer[16];
-__xdata __at (EP1_ADDR) uint8_t Ep1Buffer[8];       //on page 47 of data sheet, the receive buffer need to be min(possible packet size+2,64)
-__xdata __at (EP2_ADDR) uint8_t Ep2Buffer[128];     //IN and OUT buffer, must be even address
-__xdata __at (EP3_ADDR) uint8_t Ep3Buffer[64];     //IN and OUT buffer, must be even address
+__xdata __at (EP1_ADDR) uint8_t Ep1Buffer[72];      //CDC OUT then notification IN, must be even address
+__xdata __at (EP2_ADDR) uint8_t Ep2Buffer[128];     //CDC IN ping-pong buffers, must be even address
+__xdata __at (EP3_ADDR) uint8_t Ep3Buffer[KEYBOARD_EPSIZE]; //HID IN buffer, must be even address
 // clang-format on
 
-#if (EP3_ADDR + 64) > USER_USB_RAM
+#if (EP3_ADDR + KEYBOARD_EPSIZE) > USER_USB_RAM
 #error "This example needs more USB ram. Increase this setting in menu."
 #endif
 
@@ -34,6 +51,26 @@ __code uint8_t *__data pDescr;
 
 inline void NOP_Process() {}
 
+/**
+ * @brief 将当前描述符的下一个数据包复制到端点0缓冲区
+ * @details 配置描述符中 HID 端点的 bInterval 字段按当前轮询间隔替换，
+ *          并记录发送的值，SET_CONFIGURATION 时据此更新轮询周期
+ * @param len 数据包长度
+ */
+static void USB_LoadDescriptorPacket(__data uint8_t len) {
+    __code uint8_t *interval =
+        &ConfigurationDescriptor.HID_ReportINEndpoint.PollingIntervalMS;
+
+    for (__data uint8_t i = 0; i < len; i++) {
+        Ep0Buffer[i] = pDescr[i];
+    }
+
+    if (interval >= pDescr && interval < pDescr + len) {
+        Ep0Buffer[interval - pDescr] = radialPollInterval;
+        radialSentInterval = radialPollInterval;
+    }
+}
+
 void USB_EP0_SETUP() {
     __data uint8_t len = USB_RX_LEN;
     if (len == (sizeof(USB_SETUP_REQ))) {
@@ -50,11 +87,7 @@ void USB_EP0_SETUP() {
 
             switch ((UsbSetupBuf->bRequestType & USB_REQ_TYP_MASK)) {
             case USB_REQ_TYP_VENDOR: {
-                switch (SetupReq) {
-                default:
-                    len = 0xFF; // command not supported
-                    break;
-                }
+                len = USB_VendorSetup(); // Binary config get/set
                 break;
             }
             case USB_REQ_TYP_CLASS: {
@@ -68,19 +101,24 @@ void USB_EP0_SETUP() {
                     break;
                 case SET_LINE_CODING: // 0x20  Configure
                     break;
+                case HID_SET_IDLE:
+                case HID_GET_IDLE:
+                case HID_SET_PROTOCOL:
+                case HID_GET_PROTOCOL:
+                    len = USB_HIDClassSetup();
+                    break;
+                case HID_GET_REPORT:
+                    // 仅支持配置特征报告
+                    len = USB_ConfigReportSetup();
+                    break;
                 case HID_SET_REPORT:
                     // 保存报告类型和ID
                     ReportType = UsbSetupBuf->wValueH;
                     ReportID = UsbSetupBuf->wValueL;
                     // 检查报告类型（wValue高字节）
                     if (ReportType == 3) { // 3=特征报告
-                        // 接收特征报告数据
-                        if (SetupLen > 0) {
-                            // 设置接收数据的缓冲区
-                            pDescr = (__code uint8_t *)Ep0Buffer;
-                            // 设置要接收的长度
-                            len = SetupLen;
-                        }
+                        // 接收配置特征报告数据
+                        len = USB_ConfigReportSetup();
                     } else {
                         // LED status for caps lock, num lock, scroll lock, etc
                     }
@@ -104,13 +142,12 @@ void USB_EP0_SETUP() {
             case USB_GET_DESCRIPTOR:
                 switch (UsbSetupBuf->wValueH) {
                 case 1: // Device Descriptor
-                    pDescr = (__code uint8_t *)
-                        DeviceDescriptor; // Put Device Descriptor into outgoing
-                                          // buffer
+                    // Put Device Descriptor into outgoing buffer
+                    pDescr = (__code uint8_t *)&DeviceDescriptor;
                     len = sizeof(USB_Descriptor_Device_t);
                     break;
                 case 2: // Configure Descriptor
-                    pDescr = (__code uint8_t *)ConfigurationDescriptor;
+                    pDescr = (__code uint8_t *)&ConfigurationDescriptor;
                     len = sizeof(USB_Descriptor_Configuration_t);
                     break;
                 case 3:
@@ -150,9 +187,7 @@ void USB_EP0_SETUP() {
                     len = SetupLen >= DEFAULT_ENDP0_SIZE
                               ? DEFAULT_ENDP0_SIZE
                               : SetupLen; // transmit length for this packet
-                    for (__data uint8_t i = 0; i < len; i++) {
-                        Ep0Buffer[i] = pDescr[i];
-                    }
+                    USB_LoadDescriptorPacket(len);
                     SetupLen -= len;
                     pDescr += len;
                 }
@@ -168,6 +203,7 @@ void USB_EP0_SETUP() {
                 break;
             case USB_SET_CONFIGURATION:
                 UsbConfig = UsbSetupBuf->wValueL;
+                latchRadialPollInterval();
                 break;
             case USB_GET_INTERFACE:
                 break;
@@ -193,36 +229,44 @@ void USB_EP0_SETUP() {
                 {
                     switch (UsbSetupBuf->wIndexL) {
                     case 0x84:
-                        UEP4_CTRL = UEP4_CTRL & ~(bUEP_T_TOG | MASK_UEP_T_RES) |
-                                    UEP_T_RES_NAK;
+                        UEP4_CTRL =
+                            (UEP4_CTRL & ~(bUEP_T_TOG | MASK_UEP_T_RES)) |
+                            UEP_T_RES_NAK;
                         break;
                     case 0x04:
-                        UEP4_CTRL = UEP4_CTRL & ~(bUEP_R_TOG | MASK_UEP_R_RES) |
-                                    UEP_R_RES_ACK;
+                        UEP4_CTRL =
+                            (UEP4_CTRL & ~(bUEP_R_TOG | MASK_UEP_R_RES)) |
+                            UEP_R_RES_ACK;
                         break;
                     case 0x83:
-                        UEP3_CTRL = UEP3_CTRL & ~(bUEP_T_TOG | MASK_UEP_T_RES) |
-                                    UEP_T_RES_NAK;
+                        UEP3_CTRL =
+                            (UEP3_CTRL & ~(bUEP_T_TOG | MASK_UEP_T_RES)) |
+                            UEP_T_RES_NAK;
                         break;
                     case 0x03:
-                        UEP3_CTRL = UEP3_CTRL & ~(bUEP_R_TOG | MASK_UEP_R_RES) |
-                                    UEP_R_RES_ACK;
+                        UEP3_CTRL =
+                            (UEP3_CTRL & ~(bUEP_R_TOG | MASK_UEP_R_RES)) |
+                            UEP_R_RES_ACK;
                         break;
                     case 0x82:
-                        UEP2_CTRL = UEP2_CTRL & ~(bUEP_T_TOG | MASK_UEP_T_RES) |
-                                    UEP_T_RES_NAK;
+                        UEP2_CTRL =
+                            (UEP2_CTRL & ~(bUEP_T_TOG | MASK_UEP_T_RES)) |
+                            UEP_T_RES_NAK;
                         break;
                     case 0x02:
-                        UEP2_CTRL = UEP2_CTRL & ~(bUEP_R_TOG | MASK_UEP_R_RES) |
-                                    UEP_R_RES_ACK;
+                        UEP2_CTRL =
+                            (UEP2_CTRL & ~(bUEP_R_TOG | MASK_UEP_R_RES)) |
+                            UEP_R_RES_ACK;
                         break;
                     case 0x81:
-                        UEP1_CTRL = UEP1_CTRL & ~(bUEP_T_TOG | MASK_UEP_T_RES) |
-                                    UEP_T_RES_NAK;
+                        UEP1_CTRL =
+                            (UEP1_CTRL & ~(bUEP_T_TOG | MASK_UEP_T_RES)) |
+                            UEP_T_RES_NAK;
                         break;
                     case 0x01:
-                        UEP1_CTRL = UEP1_CTRL & ~(bUEP_R_TOG | MASK_UEP_R_RES) |
-                                    UEP_R_RES_ACK;
+                        UEP1_CTRL =
+                            (UEP1_CTRL & ~(bUEP_R_TOG | MASK_UEP_R_RES)) |
+                            UEP_R_RES_ACK;
                         break;
                     default:
                         len = 0xFF; // Unsupported endpoint
@@ -255,43 +299,44 @@ void USB_EP0_SETUP() {
                                 UsbSetupBuf->wIndexL) {
                         case 0x84:
                             UEP4_CTRL =
-                                UEP4_CTRL & (~bUEP_T_TOG) |
+                                (UEP4_CTRL & (~bUEP_T_TOG)) |
                                 UEP_T_RES_STALL; // Set endpoint4 IN STALL
                             break;
                         case 0x04:
                             UEP4_CTRL =
-                                UEP4_CTRL & (~bUEP_R_TOG) |
+                                (UEP4_CTRL & (~bUEP_R_TOG)) |
                                 UEP_R_RES_STALL; // Set endpoint4 OUT Stall
                             break;
                         case 0x83:
                             UEP3_CTRL =
-                                UEP3_CTRL & (~bUEP_T_TOG) |
+                                (UEP3_CTRL & (~bUEP_T_TOG)) |
                                 UEP_T_RES_STALL; // Set endpoint3 IN STALL
                             break;
                         case 0x03:
                             UEP3_CTRL =
-                                UEP3_CTRL & (~bUEP_R_TOG) |
+                                (UEP3_CTRL & (~bUEP_R_TOG)) |
                                 UEP_R_RES_STALL; // Set endpoint3 OUT Stall
                             break;
                         case 0x82:
                             UEP2_CTRL =
-                                UEP2_CTRL & (~bUEP_T_TOG) |
+                                (UEP2_CTRL & (~bUEP_T_TOG)) |
                                 UEP_T_RES_STALL; // Set endpoint2 IN STALL
                             break;
                         case 0x02:
                             UEP2_CTRL =
-                                UEP2_CTRL & (~bUEP_R_TOG) |
+                                (UEP2_CTRL & (~bUEP_R_TOG)) |
                                 UEP_R_RES_STALL; // Set endpoint2 OUT Stall
                             break;
                         case 0x81:
                             UEP1_CTRL =
-                                UEP1_CTRL & (~bUEP_T_TOG) |
+                                (UEP1_CTRL & (~bUEP_T_TOG)) |
                                 UEP_T_RES_STALL; // Set endpoint1 IN STALL
                             break;
                         case 0x01:
                             UEP1_CTRL =
-                                UEP1_CTRL & (~bUEP_R_TOG) |
+                                (UEP1_CTRL & (~bUEP_R_TOG)) |
                                 UEP_R_RES_STALL; // Set endpoint1 OUT Stall
+                            break;
                         default:
                             len = 0xFF; // Failed
                             break;
@@ -343,17 +388,18 @@ void USB_EP0_IN() {
         __data uint8_t len = SetupLen >= DEFAULT_ENDP0_SIZE
                                  ? DEFAULT_ENDP0_SIZE
                                  : SetupLen; // send length
-        for (__data uint8_t i = 0; i < len; i++) {
-            Ep0Buffer[i] = pDescr[i];
-        }
+        USB_LoadDescriptorPacket(len);
         // memcpy( Ep0Buffer, pDescr, len );
         SetupLen -= len;
         pDescr += len;
         UEP0_T_LEN = len;
         UEP0_CTRL ^= bUEP_T_TOG; // Switch between DATA0 and DATA1
     } break;
+    case VENDOR_GET_CONFIG:
+        USB_VendorIn();
+        break;
     case USB_SET_ADDRESS:
-        USB_DEV_AD = USB_DEV_AD & bUDA_GP_BIT | SetupLen;
+        USB_DEV_AD = (USB_DEV_AD & bUDA_GP_BIT) | SetupLen;
         UEP0_CTRL = UEP_R_RES_ACK | UEP_T_RES_NAK;
         break;
     default:
@@ -374,17 +420,14 @@ void USB_EP0_OUT() {
     } else if (SetupReq == HID_SET_REPORT) {
         UEP0_T_LEN = 0;
         UEP0_CTRL ^= bUEP_R_TOG;
+    } else if (SetupReq == VENDOR_SET_CONFIG) {
+        USB_VendorOut();
     } else {
         UEP0_T_LEN = 0;
         UEP0_CTRL |= UEP_R_RES_ACK | UEP_T_RES_NAK; // Respond Nak
     }
 }
 
-void USB_EP1_IN() {
-    UEP1_T_LEN = 0;
-    UEP1_CTRL = UEP1_CTRL & ~MASK_UEP_T_RES | UEP_T_RES_NAK; // Default NAK
-}
-
 #pragma save
 #pragma nooverlay
 void USBInterrupt() { // inline not really working in multiple files in SDCC
@@ -488,13 +531,13 @@ void USBInterrupt() { // inline not really working in multiple files in SDCC
     // Device mode USB bus reset
     if (UIF_BUS_RST) {
         UEP0_CTRL = UEP_R_RES_ACK | UEP_T_RES_NAK;
-        UEP1_CTRL = bUEP_AUTO_TOG |
-                    UEP_T_RES_NAK; // Endpoint 1 automatically flips the sync
-                                   // flag, and IN transaction returns NAK
-        UEP2_CTRL =
+        UEP1_CTRL =
             bUEP_AUTO_TOG | UEP_T_RES_NAK |
-            UEP_R_RES_ACK; // Endpoint 2 automatically flips the sync flag,
+            UEP_R_RES_ACK; // Endpoint 1 automatically flips the sync flag,
                            // IN transaction returns NAK, OUT returns ACK
+        UEP2_CTRL = bUEP_AUTO_TOG |
+                    UEP_T_RES_NAK; // Endpoint 2 automatically flips the sync
+                                   // flag, and IN transaction returns NAK
         // UEP4_CTRL = UEP_T_RES_NAK | UEP_R_RES_ACK;  //bUEP_AUTO_TOG only work
         // for endpoint 1,2,3
 
@@ -506,12 +549,14 @@ void USBInterrupt() { // inline not really working in multiple files in SDCC
         UsbConfig = 0;
 
         resetCDCParameters();
+        resetRadialParameters();
     }
 
     // USB bus suspend / wake up
     if (UIF_SUSPEND) {
         UIF_SUSPEND = 0;
         if (USB_MIS_ST & bUMS_SUSPEND) { // Suspend
+            suspendCDCHandler();
 
             // while ( XBUS_AUX & bUART0_TX );                    // Wait for Tx
             // SAFE_MOD = 0x55;
@@ -553,6 +598,7 @@ void USBDeviceIntCfg() {
     USB_INT_EN |= bUIE_SUSPEND;  // Enable device hang interrupt
     USB_INT_EN |= bUIE_TRANSFER; // Enable USB transfer completion interrupt
     USB_INT_EN |= bUIE_BUS_RST;  // Enable device mode USB bus reset interrupt
+    USB_INT_EN |= bUIE_DEV_SOF;  // Enable SOF interrupt, used as 1ms timebase
     USB_INT_FG |= 0x1F;          // Clear interrupt flag
     IE_USB = 1;                  // Enable USB interrupt
     EA = 1;                      // Enable global interrupts
@@ -574,20 +620,20 @@ void USBDeviceEndPointCfg() {
     UEP3_DMA = (uint16_t)Ep3Buffer; // Endpoint 3 data transfer address
 #endif
 
-    UEP2_3_MOD =
-        bUEP3_TX_EN | bUEP2_RX_EN | bUEP2_TX_EN; // Endpoint2 double buffer
-    UEP1_CTRL = bUEP_AUTO_TOG |
-                UEP_T_RES_NAK; // Endpoint 1 automatically flips the sync
-                               // flag, and IN transaction returns NAK
-    UEP2_CTRL = bUEP_AUTO_TOG | UEP_T_RES_NAK |
-                UEP_R_RES_ACK; // Endpoint 2 automatically flips the sync flag,
+    // Endpoint2 IN ping-pong, buffer selected by bUEP_T_TOG
+    UEP2_3_MOD = bUEP3_TX_EN | bUEP2_TX_EN | bUEP2_BUF_MOD;
+    UEP1_CTRL = bUEP_AUTO_TOG | UEP_T_RES_NAK |
+                UEP_R_RES_ACK; // Endpoint 1 automatically flips the sync flag,
                                // IN transaction returns NAK, OUT returns ACK
+    UEP2_CTRL = bUEP_AUTO_TOG |
+                UEP_T_RES_NAK; // Endpoint 2 automatically flips the sync
+                               // flag, and IN transaction returns NAK
 
     UEP3_CTRL = bUEP_AUTO_TOG | UEP_T_RES_NAK |
                 UEP_R_RES_ACK; // Endpoint 3 automatically flips the sync flag,
                                // IN transaction returns NAK, OUT returns ACK
 
-    UEP4_1_MOD = bUEP1_TX_EN; // endpoint1 TX enable
+    UEP4_1_MOD = bUEP1_RX_EN | bUEP1_TX_EN; // endpoint1 RX and TX enable
     UEP0_CTRL =
         UEP_R_RES_ACK | UEP_T_RES_NAK; // Manual flip, OUT transaction returns
                                        // ACK, IN transaction returns NAK
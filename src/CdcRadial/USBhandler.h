@@ -17,24 +17,24 @@ extern __xdata __at (EP3_ADDR) uint8_t Ep3Buffer[];
 
 extern __data uint16_t SetupLen;
 extern __data uint8_t SetupReq;
-volatile extern __xdata uint8_t UsbConfig;
+extern volatile __xdata uint8_t UsbConfig;
 extern const __code uint8_t *__data pDescr;
 
 #define UsbSetupBuf ((PUSB_SETUP_REQ)Ep0Buffer)
 
 // Out
 #define EP0_OUT_Callback USB_EP0_OUT
-#define EP1_OUT_Callback NOP_Process
-#define EP2_OUT_Callback USB_EP2_OUT
+#define EP1_OUT_Callback USB_EP1_OUT
+#define EP2_OUT_Callback NOP_Process
 #define EP3_OUT_Callback NOP_Process
 #define EP4_OUT_Callback NOP_Process
 
 // SOF
-#define EP0_SOF_Callback NOP_Process
-#define EP1_SOF_Callback NOP_Process
-#define EP2_SOF_Callback NOP_Process
-#define EP3_SOF_Callback NOP_Process
-#define EP4_SOF_Callback NOP_Process
+#define EP0_SOF_Callback USB_SOF
+#define EP1_SOF_Callback USB_SOF
+#define EP2_SOF_Callback USB_SOF
+#define EP3_SOF_Callback USB_SOF
+#define EP4_SOF_Callback USB_SOF
 
 // IN
 #define EP0_IN_Callback USB_EP0_IN
@@ -10,6 +10,40 @@
 #define EC11_PIN_B 31
 #define EC11_PIN_K 32
 
+/* EC11 编码器数量（1~4），每个编码器的 A/B/K 引脚须位于同一端口 */
+#ifndef EC11_COUNT
+#define EC11_COUNT 1
+#endif
+
+/* 第 2~4 个 EC11 编码器引脚定义，P3.6、P3.7 为 USB 引脚，P1.5 为 WS2812 引脚 */
+#define EC11_2_PIN_A 34
+#define EC11_2_PIN_B 35
+#define EC11_2_PIN_K 30
+#define EC11_3_PIN_A 10
+#define EC11_3_PIN_B 11
+#define EC11_3_PIN_K 12
+#define EC11_4_PIN_A 13
+#define EC11_4_PIN_B 14
+#define EC11_4_PIN_K 16
+
+/* EC11 编码器外部中断号（P3.3 对应 INT1，P3.2 对应 INT0） */
+#define EC11_INT_A 1
+#define EC11_INT_K 0
+
+/* EC11 编码器 B 相的 GPIO 中断使能位（P3.1 对应 bIE_P3_1_LO） */
+#define EC11_GPIO_IE_B bIE_P3_1_LO
+
+/* EC11 编码器采样方式 */
+#define EC11_SAMPLE_POLLING 0   // 主循环轮询采样
+#define EC11_SAMPLE_INTERRUPT 1 // 外部中断采样（A/B 相下降沿触发）
+#define EC11_SAMPLE_TIMER 2     // 定时器 2 定频采样
+#ifndef EC11_SAMPLE_MODE // 数量与采样方式均可在编译选项中覆盖
+#define EC11_SAMPLE_MODE EC11_SAMPLE_POLLING
+#endif
+
+/* EC11 编码器定频采样频率（Hz），仅用于定时器采样方式 */
+#define EC11_SAMPLE_RATE_HZ 2000
+
 /* WS2812 引脚定义 */
 #define WS2812_PIN 15
 
@@ -50,9 +84,26 @@
 /* 旋转触发次数配置 */
 #define STEP_PER_TEETH_1X           1 // 转动一齿触发1次
 #define STEP_PER_TEETH_2X           2 // 转动一齿触发2次
+#define STEP_PER_TEETH_4X           4 // 转动一齿触发4次
 #define STEP_PER_TEETH_DEFAULT      2 // 默认触发次数
-#define STEP_PER_TEETH_1X_THRESHOLD 2 // 1 次触发阈值
-#define STEP_PER_TEETH_2X_THRESHOLD 1 // 2 次触发阈值
+#define STEP_PER_TEETH_1X_THRESHOLD 4 // 1 次触发阈值（格雷码状态跳变数）
+#define STEP_PER_TEETH_2X_THRESHOLD 2 // 2 次触发阈值（格雷码状态跳变数）
+#define STEP_PER_TEETH_4X_THRESHOLD 1 // 4 次触发阈值（格雷码状态跳变数）
+
+/* 旋转加速度曲线配置 */
+#define ACCEL_CURVE_POINTS      4 // 加速度曲线节点数量
+#define ACCEL_GAIN_MIN          0 // 最小附加增益（单位 1/4 倍）
+#define ACCEL_GAIN_MAX         60 // 最大附加增益（60 即总倍率 16 倍）
+#define ACCEL_GAIN_DEFAULT      0 // 默认附加增益（不加速）
+#define ACCEL_IDLE_INTERVAL   200 // 加速起始间隔（毫秒），慢于此速度不加速
+
+/* HID 端点轮询间隔配置（毫秒），修改后需重新连接设备生效 */
+#define HID_POLL_INTERVAL_1MS      1
+#define HID_POLL_INTERVAL_2MS      2
+#define HID_POLL_INTERVAL_4MS      4
+#define HID_POLL_INTERVAL_8MS      8
+#define HID_POLL_INTERVAL_10MS    10
+#define HID_POLL_INTERVAL_DEFAULT HID_POLL_INTERVAL_10MS // 编译时默认轮询间隔
 // clang-format on
 
 #endif /* __COMMON_H__ */
@@ -6,36 +6,308 @@
 */
 #include "EC11.h"
 
-static __xdata ec11_t encoder;
+// 每个编码器的 A/B/K 引脚须位于同一端口（P1 或 P3），编译时检查
+#define EC11_PINS_VALID(a, b, k)                                               \
+    ((a) / 10 == (b) / 10 && (a) / 10 == (k) / 10 &&                           \
+     ((a) / 10 == 1 || (a) / 10 == 3))
 
+#if EC11_COUNT < 1 || EC11_COUNT > 4
+#error "EC11_COUNT 仅支持 1~4"
+#endif
+
+#if !EC11_PINS_VALID(EC11_PIN_A, EC11_PIN_B, EC11_PIN_K)
+#error "EC11 编码器引脚必须位于同一端口（P1 或 P3）"
+#endif
+#if EC11_COUNT >= 2 &&                                                         \
+    !EC11_PINS_VALID(EC11_2_PIN_A, EC11_2_PIN_B, EC11_2_PIN_K)
+#error "第 2 个 EC11 编码器引脚必须位于同一端口（P1 或 P3）"
+#endif
+#if EC11_COUNT >= 3 &&                                                         \
+    !EC11_PINS_VALID(EC11_3_PIN_A, EC11_3_PIN_B, EC11_3_PIN_K)
+#error "第 3 个 EC11 编码器引脚必须位于同一端口（P1 或 P3）"
+#endif
+#if EC11_COUNT >= 4 &&                                                         \
+    !EC11_PINS_VALID(EC11_4_PIN_A, EC11_4_PIN_B, EC11_4_PIN_K)
+#error "第 4 个 EC11 编码器引脚必须位于同一端口（P1 或 P3）"
+#endif
+
+#if EC11_SAMPLE_MODE == EC11_SAMPLE_INTERRUPT && EC11_COUNT > 1
+#error "外部中断采样方式仅支持单个编码器"
+#endif
+
+#if EC11_SAMPLE_MODE == EC11_SAMPLE_TIMER &&                                   \
+    (EC11_SAMPLE_RATE_HZ < 1000 || EC11_SAMPLE_RATE_HZ % 1000 != 0)
+#error "定时器采样频率必须为 1000 Hz 的整数倍"
+#endif
+
+// 端口快照索引
+#define EC11_PORT_P1 0
+#define EC11_PORT_P3 1
+
+// 引脚所在端口的快照索引与引脚位掩码
+#define EC11_PORT_OF(pin) (((pin) / 10 == 1) ? EC11_PORT_P1 : EC11_PORT_P3)
+#define EC11_PIN_MASK(pin) (1 << ((pin) % 10))
+
+#if EC11_COUNT == 1
+// 单个编码器时引脚、端口与掩码均为编译时常量，采样时无需读取引脚映射表
+#define EC11_MAP_PIN_A(i) EC11_PIN_A
+#define EC11_MAP_PIN_B(i) EC11_PIN_B
+#define EC11_MAP_PIN_K(i) EC11_PIN_K
+#define EC11_MAP_PORT(i) EC11_PORT_OF(EC11_PIN_A)
+#define EC11_MAP_MASK_A(i) EC11_PIN_MASK(EC11_PIN_A)
+#define EC11_MAP_MASK_B(i) EC11_PIN_MASK(EC11_PIN_B)
+#define EC11_MAP_MASK_K(i) EC11_PIN_MASK(EC11_PIN_K)
+#else
 /**
- * @brief 初始化 EC11 编码器
- * @param pin_a A 相引脚
- * @param pin_b B 相引脚
- * @param pin_key 按键引脚
+ * @brief EC11 编码器引脚映射结构体
  */
-void EC11_Init(uint8_t pin_a, uint8_t pin_b, uint8_t pin_key) {
-    // 设置引脚参数
-    encoder.pin_a = pin_a;
-    encoder.pin_b = pin_b;
-    encoder.pin_key = pin_key;
+typedef struct {
+    uint8_t pin_a;   // A 相引脚
+    uint8_t pin_b;   // B 相引脚
+    uint8_t pin_key; // 按键引脚
+    uint8_t port;    // 所在端口快照索引
+    uint8_t mask_a;  // A 相位掩码
+    uint8_t mask_b;  // B 相位掩码
+    uint8_t mask_k;  // 按键位掩码
+} ec11_pin_map_t;
+
+#define EC11_PIN_MAP(a, b, k)                                                  \
+    {(a),                                                                      \
+     (b),                                                                      \
+     (k),                                                                      \
+     EC11_PORT_OF(a),                                                          \
+     EC11_PIN_MASK(a),                                                         \
+     EC11_PIN_MASK(b),                                                         \
+     EC11_PIN_MASK(k)}
+
+// 引脚映射在编译时由 Common.h 中的引脚号生成，采样时无需查表换算引脚
+static const __code ec11_pin_map_t PIN_MAP[EC11_COUNT] = {
+    EC11_PIN_MAP(EC11_PIN_A, EC11_PIN_B, EC11_PIN_K),
+    EC11_PIN_MAP(EC11_2_PIN_A, EC11_2_PIN_B, EC11_2_PIN_K),
+#if EC11_COUNT >= 3
+    EC11_PIN_MAP(EC11_3_PIN_A, EC11_3_PIN_B, EC11_3_PIN_K),
+#endif
+#if EC11_COUNT >= 4
+    EC11_PIN_MAP(EC11_4_PIN_A, EC11_4_PIN_B, EC11_4_PIN_K),
+#endif
+};
+
+#define EC11_MAP_PIN_A(i) (PIN_MAP[i].pin_a)
+#define EC11_MAP_PIN_B(i) (PIN_MAP[i].pin_b)
+#define EC11_MAP_PIN_K(i) (PIN_MAP[i].pin_key)
+#define EC11_MAP_PORT(i) (PIN_MAP[i].port)
+#define EC11_MAP_MASK_A(i) (PIN_MAP[i].mask_a)
+#define EC11_MAP_MASK_B(i) (PIN_MAP[i].mask_b)
+#define EC11_MAP_MASK_K(i) (PIN_MAP[i].mask_k)
+#endif
+
+// 从端口快照中提取第 i 个编码器的 A/B 相组合状态（bit1:A, bit0:B）
+#define EC11_AB_STATE(ports, i)                                                \
+    ((((ports)[EC11_MAP_PORT(i)] & EC11_MAP_MASK_A(i)) ? 0x02 : 0x00) |        \
+     (((ports)[EC11_MAP_PORT(i)] & EC11_MAP_MASK_B(i)) ? 0x01 : 0x00))
+
+// 从端口快照中判断第 i 个编码器的按键引脚是否为低电平
+#define EC11_KEY_LOW(ports, i)                                                 \
+    (((ports)[EC11_MAP_PORT(i)] & EC11_MAP_MASK_K(i)) == 0)
+
+// 判断是否有编码器使用端口 n（1 或 3），采样时只读取用到的端口
+#define EC11_USES_PORT(n)                                                      \
+    (EC11_PIN_A / 10 == (n) ||                                                 \
+     (EC11_COUNT >= 2 && EC11_2_PIN_A / 10 == (n)) ||                          \
+     (EC11_COUNT >= 3 && EC11_3_PIN_A / 10 == (n)) ||                          \
+     (EC11_COUNT >= 4 && EC11_4_PIN_A / 10 == (n)))
+
+#if EC11_USES_PORT(1)
+#define EC11_READ_P1(ports) ((ports)[EC11_PORT_P1] = P1)
+#else
+#define EC11_READ_P1(ports)
+#endif
+
+#if EC11_USES_PORT(3)
+#define EC11_READ_P3(ports) ((ports)[EC11_PORT_P3] = P3)
+#else
+#define EC11_READ_P3(ports)
+#endif
+
+// 旋转事件编码：高位为编码器索引，低 2 位为旋转方向
+#define EC11_EVENT(index, direction) (((index) << 2) | (direction))
+#define EC11_EVENT_INDEX(event) ((event) >> 2)
+#define EC11_EVENT_DIRECTION(event) ((event) & 0x03)
+
+static __xdata ec11_t encoders[EC11_COUNT];
+
+// 所有编码器共用的配置
+static __xdata uint8_t step_per_teeth = STEP_PER_TEETH_2X;
+static __xdata ec11_phase_t phase = EC11_PHASE_A_LEADS;
+static __xdata uint8_t accel_gain[ACCEL_CURVE_POINTS];
+
+// 加速度曲线节点对应的旋转事件间隔（毫秒），依次对应越来越快的转速
+static const __code uint16_t ACCEL_INTERVALS[ACCEL_CURVE_POINTS] = {100, 50,
+                                                                    25, 12};
+
+// 格雷码状态跳变表，索引为（上一次状态 << 2 | 当前状态），状态为（A << 1 | B）
+// +1: 顺时针跳变（3→1→0→2→3），-1: 逆时针跳变
+// 0: 无变化或 A/B 同时变化的非法跳变
+// clang-format off
+static const __code int8_t TRANSITION_TABLE[16] = {
+     0, -1,  1,  0,
+     1,  0,  0, -1,
+    -1,  0,  0,  1,
+     0,  1, -1,  0
+};
+// clang-format on
+
+// 旋转事件环形缓冲区：单生产者（采样端，可能位于中断上下文）单消费者（主循环）
+// event_head 仅由生产者修改，event_tail 仅由消费者修改，8 位读写为原子操作
+static __xdata uint8_t events[EC11_EVENT_BUFFER_SIZE];
+static __xdata uint16_t event_times[EC11_EVENT_BUFFER_SIZE];
+static volatile __xdata uint8_t event_head = 0;
+static volatile __xdata uint8_t event_tail = 0;
+static volatile __xdata uint8_t event_dropped = 0;
+
+// 旋转事件时间戳时钟（EC11_CLOCK() 低 16 位），由主循环在每次更新状态时同步，
+// 定时器与外部中断采样方式下由定时器 2 中断每毫秒递增，主循环阻塞期间的
+// 事件时间戳仍然准确，中断上下文中也无需调用不可重入的 millis()
+static volatile __xdata uint16_t event_clock = 0;
+
+// 定时器 2 中断频率：定时器采样方式下为采样频率，外部中断采样方式下定时器
+// 只推进时间戳时钟
+#if EC11_SAMPLE_MODE == EC11_SAMPLE_TIMER
+#define EC11_TIMER_RATE_HZ EC11_SAMPLE_RATE_HZ
+#elif EC11_SAMPLE_MODE == EC11_SAMPLE_INTERRUPT
+#define EC11_TIMER_RATE_HZ 1000
+#endif
 
-    // 初始化状态
-    encoder.direction = EC11_DIR_NONE;
-    encoder.key_state = EC11_KEY_RELEASED;
-    encoder.key_changed = false;
-    encoder.step_per_teeth = STEP_PER_TEETH_2X; // 默认转动一齿触发2次
-    encoder.phase = EC11_PHASE_A_LEADS;         // 默认 A 相超前
+#if EC11_SAMPLE_MODE != EC11_SAMPLE_POLLING
+// 定时器中断次数，每满 1 毫秒递增一次 event_clock
+#define EC11_TICKS_PER_MS (EC11_TIMER_RATE_HZ / 1000)
+static __xdata uint8_t sample_ticks = 0;
+#endif
 
-    // 设置引脚模式
-    pinMode(encoder.pin_a, INPUT_PULLUP);
-    pinMode(encoder.pin_b, INPUT_PULLUP);
-    pinMode(encoder.pin_key, INPUT_PULLUP);
+// 写入旋转事件或时间戳时钟的中断使能位，主循环同步时间戳时钟期间暂时屏蔽
+#if EC11_SAMPLE_MODE == EC11_SAMPLE_TIMER
+#define EC11_SET_SAMPLE_IE(enable) (ET2 = (enable))
+#elif EC11_SAMPLE_MODE == EC11_SAMPLE_INTERRUPT && EC11_INT_A == 0
+#define EC11_SET_SAMPLE_IE(enable) (EX0 = IE_GPIO = ET2 = (enable))
+#elif EC11_SAMPLE_MODE == EC11_SAMPLE_INTERRUPT
+#define EC11_SET_SAMPLE_IE(enable) (EX1 = IE_GPIO = ET2 = (enable))
+#endif
+
+/**
+ * @brief 按键手势识别状态
+ */
+enum {
+    GESTURE_STATE_IDLE,           // 空闲
+    GESTURE_STATE_PRESSED,        // 第一次按下
+    GESTURE_STATE_WAIT_SECOND,    // 第一次释放，等待第二次按下
+    GESTURE_STATE_SECOND_PRESSED, // 第二次按下
+    GESTURE_STATE_LONG_HELD       // 已触发长按，等待释放
+};
+
+#if EC11_SAMPLE_MODE == EC11_SAMPLE_INTERRUPT
+// 按键释放后忽略锁存标志的时长（毫秒），用于过滤释放时的触点抖动
+#define EC11_KEY_LATCH_GUARD_MS 20
+
+// 按键按下锁存标志，避免主循环阻塞期间的短按被遗漏
+static volatile __xdata uint8_t key_press_latched = 0;
+static __xdata uint32_t key_release_time = 0;
+#endif
+
+#if EC11_SAMPLE_MODE == EC11_SAMPLE_INTERRUPT
+static void EC11_IsrA();
+static void EC11_IsrKey();
+#endif
+#if EC11_SAMPLE_MODE != EC11_SAMPLE_POLLING
+static void EC11_StartSampleTimer();
+#endif
+
+/**
+ * @brief 读取编码器所在端口的快照
+ * @details 每次采样对用到的端口各只读取一次，所有编码器共用同一份快照
+ * @param ports 端口快照数组
+ */
+#define EC11_READ_PORTS(ports)                                                 \
+    do {                                                                       \
+        EC11_READ_P1(ports);                                                   \
+        EC11_READ_P3(ports);                                                   \
+    } while (0)
+
+#pragma save
+#pragma nooverlay
+/**
+ * @brief 向旋转事件缓冲区写入一个事件
+ * @param event 旋转事件（编码器索引与旋转方向）
+ */
+static void EC11_PushEvent(__data uint8_t event) {
+    __data uint8_t next = (event_head + 1) & (EC11_EVENT_BUFFER_SIZE - 1);
+
+    // 缓冲区已满，丢弃新事件
+    if (next == event_tail) {
+        event_dropped++;
+        return;
+    }
+
+    events[event_head] = event;
+    event_times[event_head] = event_clock;
+    event_head = next;
+}
+#pragma restore
+
+/**
+ * @brief 初始化全部 EC11 编码器
+ * @details 引脚由 Common.h 中的 EC11_PIN_* 与 EC11_n_PIN_* 定义
+ */
+void EC11_Init() {
+    __data uint8_t ports[2];
+    __data uint32_t now = EC11_CLOCK();
+
+    memset(accel_gain, ACCEL_GAIN_DEFAULT, sizeof(accel_gain));
+
+    for (__data uint8_t i = 0; i < EC11_COUNT; i++) {
+        // 设置引脚模式
+        pinMode(EC11_MAP_PIN_A(i), INPUT_PULLUP);
+        pinMode(EC11_MAP_PIN_B(i), INPUT_PULLUP);
+        pinMode(EC11_MAP_PIN_K(i), INPUT_PULLUP);
+    }
 
     // 读取初始状态
-    encoder.last_a_state = digitalRead(encoder.pin_a);
-    encoder.last_b_state = digitalRead(encoder.pin_b);
-    encoder.last_key_state = digitalRead(encoder.pin_key);
+    EC11_READ_PORTS(ports);
+
+    for (__data uint8_t i = 0; i < EC11_COUNT; i++) {
+        __xdata ec11_t *encoder = &encoders[i];
+
+        encoder->last_ab_state = EC11_AB_STATE(ports, i);
+        encoder->step_count = 0;
+        encoder->invalid_count = 0;
+        encoder->last_event_time = 0;
+        encoder->event_interval = 0xFFFF;
+        encoder->key_integrator = 0;
+        encoder->key_sample_time = now;
+        encoder->key_state = EC11_KEY_RELEASED;
+        encoder->key_changed = false;
+        encoder->gesture_state = GESTURE_STATE_IDLE;
+        encoder->gesture_time = 0;
+        encoder->gesture = EC11_GESTURE_NONE;
+    }
+
+    // 清空旋转事件缓冲区
+    event_head = 0;
+    event_tail = 0;
+    event_dropped = 0;
+    event_clock = (uint16_t)now;
+
+#if EC11_SAMPLE_MODE == EC11_SAMPLE_INTERRUPT
+    key_press_latched = 0;
+
+    // A 相与按键使用下降沿触发的外部中断，B 相使用下降沿触发的 GPIO 中断
+    attachInterrupt(EC11_INT_A, EC11_IsrA, FALLING);
+    attachInterrupt(EC11_INT_K, EC11_IsrKey, FALLING);
+    GPIO_IE = bIE_IO_EDGE | EC11_GPIO_IE_B;
+    IE_GPIO = 1;
+#endif
+#if EC11_SAMPLE_MODE != EC11_SAMPLE_POLLING
+    EC11_StartSampleTimer();
+#endif
 }
 
 /**
@@ -46,7 +318,7 @@ void EC11_Init(uint8_t pin_a, uint8_t pin_b, uint8_t pin_key) {
  * @return 转换后的旋转方向
  */
 static ec11_direction_t EC11_ConvertDirection(ec11_direction_t direction) {
-    if (encoder.phase == EC11_PHASE_B_LEADS) {
+    if (phase == EC11_PHASE_B_LEADS) {
         if (direction == EC11_DIR_CW) {
             return EC11_DIR_CCW;
         } else if (direction == EC11_DIR_CCW) {
@@ -57,86 +329,478 @@ static ec11_direction_t EC11_ConvertDirection(ec11_direction_t direction) {
     return direction;
 }
 
+#pragma save
+#pragma nooverlay
+#if EC11_SAMPLE_MODE != EC11_SAMPLE_INTERRUPT
+/**
+ * @brief 采样全部编码器的 A/B 相，通过格雷码状态跳变表解码并写入旋转事件
+ * @param ports 本次采样读取的端口快照
+ */
+static void EC11_SampleRotation(__data uint8_t *ports) {
+    // 根据 step_per_teeth 配置确定触发旋转事件的阈值
+    __data int8_t threshold;
+
+    switch (step_per_teeth) {
+    case STEP_PER_TEETH_1X:
+        threshold = STEP_PER_TEETH_1X_THRESHOLD;
+        break;
+    case STEP_PER_TEETH_4X:
+        threshold = STEP_PER_TEETH_4X_THRESHOLD;
+        break;
+    default:
+        threshold = STEP_PER_TEETH_2X_THRESHOLD;
+        break;
+    }
+
+    for (__data uint8_t i = 0; i < EC11_COUNT; i++) {
+        __xdata ec11_t *encoder = &encoders[i];
+
+        // 提取当前状态
+        __data uint8_t current_ab_state = EC11_AB_STATE(ports, i);
+
+        if (current_ab_state == encoder->last_ab_state) {
+            continue;
+        }
+
+        // A/B 同时变化说明漏采或抖动，无法判断方向，直接丢弃
+        if ((current_ab_state ^ encoder->last_ab_state) == 0x03) {
+            encoder->invalid_count++;
+        } else {
+            encoder->step_count +=
+                TRANSITION_TABLE[(encoder->last_ab_state << 2) |
+                                 current_ab_state];
+        }
+
+        // 更新 A/B 相的上一次状态
+        encoder->last_ab_state = current_ab_state;
+
+        if (encoder->step_count >= threshold) {
+            EC11_PushEvent(EC11_EVENT(i, EC11_DIR_CW)); // 顺时针旋转
+            encoder->step_count = 0;
+        } else if (encoder->step_count <= -threshold) {
+            EC11_PushEvent(EC11_EVENT(i, EC11_DIR_CCW)); // 逆时针旋转
+            encoder->step_count = 0;
+        }
+    }
+}
+
+#else
 /**
- * @brief 更新 EC11 编码器状态
+ * @brief 在 A 相或 B 相的下降沿解码旋转并写入旋转事件
+ * @details 外部中断与 GPIO 中断只能由下降沿触发，看不到上升沿，因此按齿
+ *          解码：离开静止状态（A/B 均为高电平）的下降沿记录方向，顺时针
+ *          为 A 相（3→1），逆时针为 B 相（3→2）；到达中点（A/B 均为低
+ *          电平）的下降沿方向一致时计为一齿，之后回到静止状态的两次上升沿
+ *          由定位弹片保证，按 step_per_teeth 一次写入该齿的全部旋转事件。
+ *          中点处的触点抖动与 A/B 同时下降不会重复计数，计入非法跳变
+ * @param fell 产生下降沿的相（0x02：A 相，0x01：B 相）
+ */
+static void EC11_DecodeEdge(__data uint8_t fell) {
+    __xdata ec11_t *encoder = &encoders[0];
+    __data uint8_t ports[2];
+    __data uint8_t state;
+    __data int8_t direction;
+
+    EC11_READ_PORTS(ports);
+    state = EC11_AB_STATE(ports, 0);
+    encoder->last_ab_state = state;
+
+    // 进入中断时该相已回到高电平，是触点抖动
+    if (state & fell) {
+        encoder->invalid_count++;
+        return;
+    }
+
+    // A 相离开静止状态或 B 相到达中点为顺时针，反之为逆时针
+    direction = ((fell == 0x02) == (state != 0)) ? 1 : -1;
+
+    if (state != 0) {
+        // step_count 记录离开静止状态的方向，到达中点前反转时被覆盖
+        encoder->step_count = direction;
+        return;
+    }
+
+    if (encoder->step_count != direction) {
+        encoder->step_count = 0;
+        encoder->invalid_count++;
+        return;
+    }
+
+    encoder->step_count = 0;
+    for (__data uint8_t n = step_per_teeth; n > 0; n--) {
+        EC11_PushEvent(
+            EC11_EVENT(0, direction > 0 ? EC11_DIR_CW : EC11_DIR_CCW));
+    }
+}
+
+/**
+ * @brief A 相下降沿中断处理函数
+ */
+static void EC11_IsrA() { EC11_DecodeEdge(0x02); }
+
+/**
+ * @brief GPIO 中断处理函数，在 B 相下降沿解码旋转
+ * @note 需在 GPIO 中断服务函数中调用
+ */
+void EC11_GpioInterrupt() { EC11_DecodeEdge(0x01); }
+
+/**
+ * @brief 按键下降沿中断处理函数
+ */
+static void EC11_IsrKey() { key_press_latched = 1; }
+#endif
+#pragma restore
+
+#if EC11_SAMPLE_MODE != EC11_SAMPLE_POLLING
+/**
+ * @brief 启动定时器 2，以 EC11_TIMER_RATE_HZ 的频率产生中断
+ * @details 定时器 2 工作于 16 位自动重装模式，时钟为 Fsys/12
+ */
+static void EC11_StartSampleTimer() {
+    __data uint16_t reload = 65536 - (F_CPU / 12 / EC11_TIMER_RATE_HZ);
+
+    TR2 = 0;
+    T2MOD &= ~(bTMR_CLK | bT2_CLK); // 定时器 2 时钟为 Fsys/12
+    C_T2 = 0;                       // 定时器模式
+    CP_RL2 = 0;                     // 16 位自动重装模式
+
+    RCAP2L = reload & 0xFF;
+    RCAP2H = reload >> 8;
+    TL2 = RCAP2L;
+    TH2 = RCAP2H;
+
+    TF2 = 0;
+    ET2 = 1; // 使能定时器 2 中断
+    TR2 = 1; // 启动定时器 2
+}
+
+#pragma save
+#pragma nooverlay
+/**
+ * @brief 定时器 2 中断处理函数，推进时间戳时钟，定时器采样方式下同时
+ *        以固定频率采样 A/B 相
+ * @note 需在定时器 2 中断服务函数中调用
+ */
+void EC11_TimerInterrupt() {
+    TF2 = 0; // 定时器 2 溢出标志需软件清除
+
+    if (++sample_ticks >= EC11_TICKS_PER_MS) {
+        sample_ticks = 0;
+        event_clock++;
+    }
+
+#if EC11_SAMPLE_MODE == EC11_SAMPLE_TIMER
+    __data uint8_t ports[2];
+
+    EC11_READ_PORTS(ports);
+    EC11_SampleRotation(ports);
+#endif
+}
+#pragma restore
+#endif
+
+/**
+ * @brief 按键积分消抖
+ * @details 引脚为低电平时积分值随经过的时间增加，高电平时减少，
+ *          积分值达到上限才判定为按下，回落到 0 才判定为释放
+ * @param encoder 编码器
+ * @param now 当前时间戳（毫秒）
+ * @param pressed 按键引脚是否为低电平
+ */
+static void EC11_DebounceKey(__xdata ec11_t *encoder, __data uint32_t now,
+                             __data bool pressed) {
+    __data uint32_t elapsed = now - encoder->key_sample_time;
+    __data uint8_t step = (elapsed > EC11_KEY_DEBOUNCE_MS)
+                              ? EC11_KEY_DEBOUNCE_MS
+                              : (uint8_t)elapsed;
+
+    encoder->key_sample_time = now;
+
+    if (pressed) {
+        encoder->key_integrator =
+            (encoder->key_integrator + step > EC11_KEY_DEBOUNCE_MS)
+                ? EC11_KEY_DEBOUNCE_MS
+                : encoder->key_integrator + step;
+    } else {
+        encoder->key_integrator = (encoder->key_integrator > step)
+                                      ? encoder->key_integrator - step
+                                      : 0;
+    }
+
+#if EC11_SAMPLE_MODE == EC11_SAMPLE_INTERRUPT
+    // 按键在两次采样之间已被按下又释放，直接判定为按下，之后按正常积分释放
+    if (key_press_latched) {
+        key_press_latched = 0;
+
+        if (encoder->key_state == EC11_KEY_RELEASED &&
+            now - key_release_time >= EC11_KEY_LATCH_GUARD_MS) {
+            encoder->key_integrator = EC11_KEY_DEBOUNCE_MS;
+        }
+    }
+#endif
+
+    encoder->key_changed = false;
+
+    if (encoder->key_state == EC11_KEY_RELEASED &&
+        encoder->key_integrator >= EC11_KEY_DEBOUNCE_MS) {
+        encoder->key_state = EC11_KEY_PRESSED;
+        encoder->key_changed = true;
+    } else if (encoder->key_state == EC11_KEY_PRESSED &&
+               encoder->key_integrator == 0) {
+        encoder->key_state = EC11_KEY_RELEASED;
+        encoder->key_changed = true;
+
+#if EC11_SAMPLE_MODE == EC11_SAMPLE_INTERRUPT
+        key_release_time = now;
+#endif
+    }
+}
+
+/**
+ * @brief 按键手势识别
+ * @details 根据消抖后的按键边沿和时间戳识别单击、双击与长按，不阻塞主循环
+ * @param encoder 编码器
+ * @param now 当前时间戳（毫秒）
+ */
+static void EC11_RecognizeGesture(__xdata ec11_t *encoder,
+                                  __data uint32_t now) {
+    __data bool pressed =
+        encoder->key_changed && encoder->key_state == EC11_KEY_PRESSED;
+    __data bool released =
+        encoder->key_changed && encoder->key_state == EC11_KEY_RELEASED;
+    __data uint32_t elapsed = now - encoder->gesture_time;
+
+    switch (encoder->gesture_state) {
+    case GESTURE_STATE_IDLE:
+        if (pressed) {
+            encoder->gesture_state = GESTURE_STATE_PRESSED;
+            encoder->gesture_time = now;
+        }
+        break;
+    case GESTURE_STATE_PRESSED:
+        if (released) {
+            encoder->gesture_state = GESTURE_STATE_WAIT_SECOND;
+            encoder->gesture_time = now;
+        } else if (elapsed >= EC11_KEY_LONG_PRESS_MS) {
+            encoder->gesture = EC11_GESTURE_LONG_PRESS;
+            encoder->gesture_state = GESTURE_STATE_LONG_HELD;
+        }
+        break;
+    case GESTURE_STATE_WAIT_SECOND:
+        if (pressed) {
+            encoder->gesture_state = GESTURE_STATE_SECOND_PRESSED;
+            encoder->gesture_time = now;
+        } else if (elapsed >= EC11_KEY_DOUBLE_CLICK_MS) {
+            encoder->gesture = EC11_GESTURE_CLICK;
+            encoder->gesture_state = GESTURE_STATE_IDLE;
+        }
+        break;
+    case GESTURE_STATE_SECOND_PRESSED:
+        if (released) {
+            encoder->gesture = EC11_GESTURE_DOUBLE_CLICK;
+            encoder->gesture_state = GESTURE_STATE_IDLE;
+        } else if (elapsed >= EC11_KEY_LONG_PRESS_MS) {
+            encoder->gesture = EC11_GESTURE_LONG_PRESS;
+            encoder->gesture_state = GESTURE_STATE_LONG_HELD;
+        }
+        break;
+    case GESTURE_STATE_LONG_HELD:
+        if (released) {
+            encoder->gesture_state = GESTURE_STATE_IDLE;
+        }
+        break;
+    default:
+        encoder->gesture_state = GESTURE_STATE_IDLE;
+        break;
+    }
+}
+
+/**
+ * @brief 更新全部 EC11 编码器状态
  */
 void EC11_UpdateStatus() {
-    static __data int8_t count = 0;
+    // 一次读取端口快照，同时得到全部编码器 A/B/K 引脚的状态
+    __data uint8_t ports[2];
+    __data uint32_t now = EC11_CLOCK();
 
-    // 初始化方向为无旋转
-    encoder.direction = EC11_DIR_NONE;
+#if EC11_SAMPLE_MODE == EC11_SAMPLE_POLLING
+    event_clock = (uint16_t)now;
 
-    // 读取当前状态
-    __data uint8_t current_a_state = digitalRead(encoder.pin_a);
-    __data uint8_t current_b_state = digitalRead(encoder.pin_b);
-    __data uint8_t current_key_state = digitalRead(encoder.pin_key);
+    EC11_READ_PORTS(ports);
+    EC11_SampleRotation(ports);
+#else
+    // 16 位时钟的写入不是原子操作，同步期间屏蔽写入旋转事件的中断
+    EC11_SET_SAMPLE_IE(0);
+    event_clock = (uint16_t)now;
+    sample_ticks = 0;
+    EC11_SET_SAMPLE_IE(1);
 
-    // 检测旋转方向（基于 A 相的变化）
-    if (encoder.last_a_state != current_a_state) {
-        count += (current_b_state != current_a_state) ? 1 : -1;
+    // 旋转由中断解码，主循环只读取按键
+    EC11_READ_PORTS(ports);
+#endif
+
+    for (__data uint8_t i = 0; i < EC11_COUNT; i++) {
+        EC11_DebounceKey(&encoders[i], now, EC11_KEY_LOW(ports, i));
+        EC11_RecognizeGesture(&encoders[i], now);
     }
+}
 
-    // 根据 step_per_teeth 配置判断是否触发旋转事件
-    __data int8_t threshold = (encoder.step_per_teeth == STEP_PER_TEETH_1X)
-                                  ? STEP_PER_TEETH_1X_THRESHOLD
-                                  : STEP_PER_TEETH_2X_THRESHOLD;
+/**
+ * @brief 从旋转事件缓冲区取出一个旋转方向
+ * @param index 用于返回产生该事件的编码器索引
+ * @return 旋转方向，缓冲区为空时返回 EC11_DIR_NONE
+ */
+ec11_direction_t EC11_GetDirection(uint8_t *index) {
+    if (event_tail == event_head) {
+        return EC11_DIR_NONE;
+    }
+
+    __data uint8_t event = events[event_tail];
+    __data uint16_t event_time = event_times[event_tail];
+    event_tail = (event_tail + 1) & (EC11_EVENT_BUFFER_SIZE - 1);
 
-    if (count >= threshold) {
-        encoder.direction = EC11_DIR_CW; // 顺时针旋转
-        count = 0;
-    } else if (count <= -threshold) {
-        encoder.direction = EC11_DIR_CCW; // 逆时针旋转
-        count = 0;
+    __xdata ec11_t *encoder = &encoders[EC11_EVENT_INDEX(event)];
+
+    // 计算与上一次事件的时间间隔，超过加速起始间隔视为从静止开始旋转。
+    // 时间戳相同的事件（同一齿一次写入的多个事件，或同一时钟周期内的
+    // 多次跳变）沿用上一个间隔，不视为无限快的旋转
+    if (event_time != encoder->last_event_time) {
+        encoder->event_interval = event_time - encoder->last_event_time;
+        if (encoder->event_interval > ACCEL_IDLE_INTERVAL) {
+            encoder->event_interval = 0xFFFF;
+        }
+        encoder->last_event_time = event_time;
     }
 
+    *index = EC11_EVENT_INDEX(event);
+
     // 应用相位转换，统一转换为 A 相超前的逻辑
-    encoder.direction = EC11_ConvertDirection(encoder.direction);
+    return EC11_ConvertDirection(EC11_EVENT_DIRECTION(event));
+}
+
+/**
+ * @brief 获取编码器最近一次取出的旋转事件与上一次事件的时间间隔
+ * @param index 编码器索引
+ * @return 时间间隔（毫秒），空闲后的首个事件返回 0xFFFF
+ */
+uint16_t EC11_GetEventInterval(uint8_t index) {
+    return encoders[index].event_interval;
+}
+
+/**
+ * @brief 获取编码器最近一次取出的旋转事件的时间戳
+ * @param index 编码器索引
+ * @return 时间戳（millis() 低 16 位）
+ */
+uint16_t EC11_GetEventTime(uint8_t index) {
+    return encoders[index].last_event_time;
+}
 
-    // 更新 A 相和 B 相的上一次状态
-    encoder.last_a_state = current_a_state;
-    encoder.last_b_state = current_b_state;
+/**
+ * @brief 设置旋转加速度曲线
+ * @param gain 各曲线节点的附加增益（单位 1/4 倍），共 ACCEL_CURVE_POINTS 个
+ */
+void EC11_SetAccelCurve(const uint8_t *gain) {
+    memcpy(accel_gain, gain, sizeof(accel_gain));
+}
 
-    // 检测按键状态变化
-    encoder.key_changed = (encoder.last_key_state != current_key_state);
+/**
+ * @brief 根据编码器最近一次旋转事件的速度对旋转角度应用加速度曲线
+ * @details 在相邻曲线节点之间按事件间隔线性插值得到附加增益 gain，
+ *          倍率为 (4 + gain) / 4，全部使用整数运算
+ * @param index 编码器索引
+ * @param degrees 基础旋转角度
+ * @return 加速后的旋转角度
+ */
+int16_t EC11_ApplyAccel(uint8_t index, int16_t degrees) {
+    __data uint16_t interval = encoders[index].event_interval;
+    __data uint16_t upper_interval = ACCEL_IDLE_INTERVAL;
+    __data uint8_t upper_gain = 0;
+    __data uint8_t gain = 0;
 
-    // 更新按键状态
-    if (encoder.key_changed) {
-        encoder.key_state =
-            (current_key_state == LOW) ? EC11_KEY_PRESSED : EC11_KEY_RELEASED;
-        encoder.last_key_state = current_key_state;
+    if (interval >= ACCEL_IDLE_INTERVAL) {
+        return degrees;
     }
+
+    for (__data uint8_t i = 0; i < ACCEL_CURVE_POINTS; i++) {
+        __data uint16_t lower_interval = ACCEL_INTERVALS[i];
+        __data uint8_t lower_gain = accel_gain[i];
+
+        if (interval >= lower_interval) {
+            // 在 (upper_interval, upper_gain) 与 (lower_interval, lower_gain)
+            // 之间线性插值，曲线单调不减，因此 lower_gain >= upper_gain
+            gain = upper_gain +
+                   (uint8_t)(((uint16_t)(lower_gain - upper_gain) *
+                              (upper_interval - interval)) /
+                             (upper_interval - lower_interval));
+            break;
+        }
+
+        upper_interval = lower_interval;
+        upper_gain = lower_gain;
+        gain = lower_gain; // 快于最后一个节点时保持最大增益
+    }
+
+    // 基础角度不超过 360 度、倍率不超过 16 倍，乘积不会溢出 int16_t
+    return (degrees * (4 + gain)) / 4;
 }
 
 /**
- * @brief 获取 EC11 编码器旋转方向
- * @return 旋转方向
+ * @brief 获取因缓冲区已满而丢弃的旋转事件数量
+ * @return 丢弃的事件数量
  */
-inline ec11_direction_t EC11_GetDirection() { return encoder.direction; }
+uint8_t EC11_GetDroppedEvents() { return event_dropped; }
+
+/**
+ * @brief 获取编码器被丢弃的非法 A/B 相状态跳变次数
+ * @param index 编码器索引
+ * @return 非法跳变次数
+ */
+uint8_t EC11_GetInvalidTransitions(uint8_t index) {
+    return encoders[index].invalid_count;
+}
 
 /**
  * @brief 获取 EC11 编码器按键状态
+ * @param index 编码器索引
  * @return 按键状态
  */
-ec11_key_state_t EC11_GetKeyState() { return encoder.key_state; }
+ec11_key_state_t EC11_GetKeyState(uint8_t index) {
+    return encoders[index].key_state;
+}
 
 /**
  * @brief 检查 EC11 编码器按键状态是否变化
+ * @param index 编码器索引
  * @return 是否变化
  */
-bool EC11_IsKeyChanged() { return encoder.key_changed; }
+bool EC11_IsKeyChanged(uint8_t index) { return encoders[index].key_changed; }
+
+/**
+ * @brief 取出编码器最近识别到的按键手势
+ * @param index 编码器索引
+ * @return 按键手势，无新手势时返回 EC11_GESTURE_NONE
+ */
+ec11_key_gesture_t EC11_GetKeyGesture(uint8_t index) {
+    __data ec11_key_gesture_t gesture = encoders[index].gesture;
+
+    encoders[index].gesture = EC11_GESTURE_NONE;
+    return gesture;
+}
 
 /**
  * @brief 设置 EC11 编码器触发动作的次数
- * @param step 每转动一齿触发动作次数
+ * @param step 每转动一齿触发动作次数（1、2 或 4）
  */
 void EC11_SetStepPerTeeth(uint8_t step) {
-    if (step == STEP_PER_TEETH_1X || step == STEP_PER_TEETH_2X) {
-        encoder.step_per_teeth = step;
+    if (step == STEP_PER_TEETH_1X || step == STEP_PER_TEETH_2X ||
+        step == STEP_PER_TEETH_4X) {
+        step_per_teeth = step;
     }
 }
 
 /**
  * @brief 设置 EC11 编码器相位配置
- * @param phase 相位配置
+ * @param value 相位配置
  */
-void EC11_SetPhase(ec11_phase_t phase) { encoder.phase = phase; }
+void EC11_SetPhase(ec11_phase_t value) { phase = value; }
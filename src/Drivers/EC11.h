@@ -10,6 +10,21 @@
 #include "../Common.h"
 #include <Arduino.h>
 
+// 旋转事件缓冲区大小（必须为 2 的幂）
+#define EC11_EVENT_BUFFER_SIZE 32
+
+// 按键消抖积分时长（毫秒）
+#define EC11_KEY_DEBOUNCE_MS 8
+// 长按判定时长（毫秒）
+#define EC11_KEY_LONG_PRESS_MS 500
+// 双击判定间隔（毫秒）
+#define EC11_KEY_DOUBLE_CLICK_MS 250
+
+// 按键时序使用的时钟，可在编译时替换以注入模拟时钟
+#ifndef EC11_CLOCK
+#define EC11_CLOCK() millis()
+#endif
+
 /**
  * @brief EC11 编码器相位配置枚举
  * @details 用于指定 EC11 编码器的硬件相位配置
@@ -39,57 +54,137 @@ typedef enum {
     EC11_KEY_PRESSED   // 按键按下
 } ec11_key_state_t;
 
+/**
+ * @brief EC11 编码器按键手势枚举
+ */
+typedef enum {
+    EC11_GESTURE_NONE,         // 无手势
+    EC11_GESTURE_CLICK,        // 单击
+    EC11_GESTURE_DOUBLE_CLICK, // 双击
+    EC11_GESTURE_LONG_PRESS    // 长按
+} ec11_key_gesture_t;
+
 /**
  * @brief EC11 编码器结构体
+ * @note 转动一齿触发次数、相位与加速度曲线为所有编码器共用的配置
  */
 typedef struct {
-    uint8_t pin_a;              // A 相引脚
-    uint8_t pin_b;              // B 相引脚
-    uint8_t pin_key;            // 按键引脚
-    uint8_t last_a_state;       // 上一次 A 相状态
-    uint8_t last_b_state;       // 上一次 B 相状态
-    uint8_t last_key_state;     // 上一次按键状态
-    ec11_direction_t direction; // 当前旋转方向
-    ec11_key_state_t key_state; // 当前按键状态
+    uint8_t last_ab_state;      // 上一次 A/B 相组合状态（bit1:A, bit0:B）
+    int8_t step_count;          // 格雷码状态跳变累计值
+    uint8_t invalid_count;      // 非法状态跳变次数
+    uint16_t last_event_time;   // 上一次旋转事件时间戳（毫秒，低 16 位）
+    uint16_t event_interval;    // 最近两次旋转事件的间隔（毫秒）
+    uint8_t key_integrator;     // 按键消抖积分值（毫秒）
+    uint32_t key_sample_time;   // 上一次按键采样时间戳
+    ec11_key_state_t key_state; // 当前按键状态（消抖后）
     bool key_changed;           // 按键状态是否变化
-    uint8_t step_per_teeth;     // 转动一齿触发次数
-    ec11_phase_t phase;         // 相位配置
+    uint8_t gesture_state;      // 手势识别状态
+    uint32_t gesture_time;      // 手势识别状态起始时间戳
+    ec11_key_gesture_t gesture; // 待取出的按键手势
 } ec11_t;
 
 /**
- * @brief 初始化 EC11 编码器
- * @param pin_a A 相引脚
- * @param pin_b B 相引脚
- * @param pin_key 按键引脚
+ * @brief 初始化全部 EC11 编码器
+ * @details 引脚由 Common.h 中的 EC11_PIN_* 与 EC11_n_PIN_* 定义
  */
-void EC11_Init(uint8_t pin_a, uint8_t pin_b, uint8_t pin_key);
+void EC11_Init();
 
+#if EC11_SAMPLE_MODE != EC11_SAMPLE_POLLING
 /**
- * @brief 更新 EC11 编码器状态
+ * @brief 定时器 2 中断处理函数，推进时间戳时钟，定时器采样方式下同时
+ *        以固定频率采样 A/B 相
+ * @note 需在定时器 2 中断服务函数中调用
+ */
+void EC11_TimerInterrupt();
+#endif
+
+#if EC11_SAMPLE_MODE == EC11_SAMPLE_INTERRUPT
+/**
+ * @brief GPIO 中断处理函数，在 B 相下降沿解码旋转
+ * @note 需在 GPIO 中断服务函数中调用
+ */
+void EC11_GpioInterrupt();
+#endif
+
+/**
+ * @brief 更新全部 EC11 编码器状态
+ * @details 轮询模式下采样 A/B 相并将旋转事件写入缓冲区，同时更新按键状态；
+ *          中断与定时器模式下旋转事件由中断写入，此处仅更新按键状态
  */
 void EC11_UpdateStatus();
 
 /**
- * @brief 获取 EC11 编码器旋转方向
- * @return 旋转方向
+ * @brief 从旋转事件缓冲区取出一个旋转方向
+ * @param index 用于返回产生该事件的编码器索引
+ * @return 旋转方向，缓冲区为空时返回 EC11_DIR_NONE
+ */
+ec11_direction_t EC11_GetDirection(uint8_t *index);
+
+/**
+ * @brief 获取编码器最近一次取出的旋转事件与上一次事件的时间间隔
+ * @param index 编码器索引
+ * @return 时间间隔（毫秒），空闲后的首个事件返回 0xFFFF
+ */
+uint16_t EC11_GetEventInterval(uint8_t index);
+
+/**
+ * @brief 获取编码器最近一次取出的旋转事件的时间戳
+ * @param index 编码器索引
+ * @return 时间戳（millis() 低 16 位）
+ */
+uint16_t EC11_GetEventTime(uint8_t index);
+
+/**
+ * @brief 设置旋转加速度曲线
+ * @param gain 各曲线节点的附加增益（单位 1/4 倍），共 ACCEL_CURVE_POINTS 个
  */
-extern inline ec11_direction_t EC11_GetDirection();
+void EC11_SetAccelCurve(const uint8_t *gain);
+
+/**
+ * @brief 根据编码器最近一次旋转事件的速度对旋转角度应用加速度曲线
+ * @param index 编码器索引
+ * @param degrees 基础旋转角度
+ * @return 加速后的旋转角度
+ */
+int16_t EC11_ApplyAccel(uint8_t index, int16_t degrees);
+
+/**
+ * @brief 获取因缓冲区已满而丢弃的旋转事件数量
+ * @return 丢弃的事件数量
+ */
+uint8_t EC11_GetDroppedEvents();
+
+/**
+ * @brief 获取编码器被丢弃的非法 A/B 相状态跳变次数
+ * @param index 编码器索引
+ * @return 非法跳变次数
+ */
+uint8_t EC11_GetInvalidTransitions(uint8_t index);
 
 /**
  * @brief 获取 EC11 编码器按键状态
+ * @param index 编码器索引
  * @return 按键状态
  */
-ec11_key_state_t EC11_GetKeyState();
+ec11_key_state_t EC11_GetKeyState(uint8_t index);
 
 /**
  * @brief 检查 EC11 编码器按键状态是否变化
+ * @param index 编码器索引
  * @return 是否变化
  */
-bool EC11_IsKeyChanged();
+bool EC11_IsKeyChanged(uint8_t index);
+
+/**
+ * @brief 取出编码器最近识别到的按键手势
+ * @param index 编码器索引
+ * @return 按键手势，无新手势时返回 EC11_GESTURE_NONE
+ */
+ec11_key_gesture_t EC11_GetKeyGesture(uint8_t index);
 
 /**
  * @brief 设置 EC11 编码器触发动作的次数
- * @param step 每转动一齿触发动作次数
+ * @param step 每转动一齿触发动作次数（1、2 或 4）
  */
 void EC11_SetStepPerTeeth(uint8_t step);
 
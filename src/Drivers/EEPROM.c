@@ -8,6 +8,42 @@
 
 static __xdata eeprom_config_t config;
 
+// 上电以来实际写入 EEPROM 的字节数
+static uint16_t bytes_written = 0;
+
+/**
+ * @brief 验证旋转加速度曲线有效性
+ * @param gain 各曲线节点的附加增益数组
+ * @return 操作状态
+ */
+static eeprom_status_t EEPROM_ValidateAccelCurve(const uint8_t *gain) {
+    for (uint8_t i = 0; i < ACCEL_CURVE_POINTS; i++) {
+        if (gain[i] > ACCEL_GAIN_MAX) {
+            return EEPROM_STATUS_INVALID_PARAM;
+        }
+
+        // 转速越快增益越大，曲线需单调不减
+        if (i > 0 && gain[i] < gain[i - 1]) {
+            return EEPROM_STATUS_INVALID_PARAM;
+        }
+    }
+
+    return EEPROM_STATUS_OK;
+}
+
+/**
+ * @brief 检查 HID 端点轮询间隔是否为支持的取值
+ * @param interval 轮询间隔（毫秒）
+ * @return 是否有效
+ */
+static bool EEPROM_IsValidHidPollInterval(uint8_t interval) {
+    return interval == HID_POLL_INTERVAL_1MS ||
+           interval == HID_POLL_INTERVAL_2MS ||
+           interval == HID_POLL_INTERVAL_4MS ||
+           interval == HID_POLL_INTERVAL_8MS ||
+           interval == HID_POLL_INTERVAL_10MS;
+}
+
 /**
  * @brief 获取完整的配置结构体数据指针
  * @return 配置结构体指针
@@ -39,7 +75,20 @@ eeprom_status_t EEPROM_LoadConfig() {
 }
 
 /**
- * @brief 将配置参数写入 EEPROM
+ * @brief 仅在 EEPROM 中的值不同时写入一个字节
+ * @details 读取远快于擦写，跳过未变化的字节可缩短保存耗时并减少擦写次数
+ * @param addr EEPROM 地址
+ * @param value 待写入的值
+ */
+static void EEPROM_UpdateByte(uint8_t addr, uint8_t value) {
+    if (eeprom_read_byte(addr) != value) {
+        eeprom_write_byte(addr, value);
+        bytes_written++;
+    }
+}
+
+/**
+ * @brief 将配置参数写入 EEPROM，只写入发生变化的字节
  * @return 操作状态
  */
 eeprom_status_t EEPROM_SaveConfig() {
@@ -49,18 +98,24 @@ eeprom_status_t EEPROM_SaveConfig() {
     }
 
     // 写入版本信息默认值
-    eeprom_write_byte(EEPROM_CONFIG_START_ADDRESS + 0, FIRMWARE_VERSION);
-    eeprom_write_byte(EEPROM_CONFIG_START_ADDRESS + 1, FIRMWARE_REVISION);
+    EEPROM_UpdateByte(EEPROM_CONFIG_START_ADDRESS + 0, FIRMWARE_VERSION);
+    EEPROM_UpdateByte(EEPROM_CONFIG_START_ADDRESS + 1, FIRMWARE_REVISION);
 
     const __xdata uint8_t *data = (const __xdata uint8_t *)&config;
 
     for (uint8_t i = 2; i < CONFIG_STRUCT_SIZE; i++) {
-        eeprom_write_byte(EEPROM_CONFIG_START_ADDRESS + i, data[i]);
+        EEPROM_UpdateByte(EEPROM_CONFIG_START_ADDRESS + i, data[i]);
     }
 
     return EEPROM_STATUS_OK;
 }
 
+/**
+ * @brief 获取上电以来实际写入 EEPROM 的字节数
+ * @return 写入字节数，超过 65535 后回绕
+ */
+uint16_t EEPROM_GetBytesWritten() { return bytes_written; }
+
 /**
  * @brief 重置配置参数为默认值
  * @return 操作状态
@@ -80,6 +135,12 @@ eeprom_status_t EEPROM_Reset() {
     config.step_per_teeth = STEP_PER_TEETH_DEFAULT; // 默认转动一齿触发次数
     config.phase = EC11_PHASE_A_LEADS; // 默认 EC11 编码器相位配置
 
+    // 默认不启用旋转加速
+    memset(config.accel_gain, ACCEL_GAIN_DEFAULT, sizeof(config.accel_gain));
+
+    // 默认使用编译时设置的 HID 端点轮询间隔
+    config.hid_poll_interval = HID_POLL_INTERVAL_DEFAULT;
+
     // 初始化预留空间
     memset(config.reserved, 0, sizeof(config.reserved));
 
@@ -138,7 +199,8 @@ eeprom_status_t EEPROM_Validate() {
 
     // 检查转动一齿触发次数是否在有效范围内
     if (config.step_per_teeth != STEP_PER_TEETH_1X &&
-        config.step_per_teeth != STEP_PER_TEETH_2X) {
+        config.step_per_teeth != STEP_PER_TEETH_2X &&
+        config.step_per_teeth != STEP_PER_TEETH_4X) {
         return EEPROM_STATUS_INVALID_PARAM;
     }
 
@@ -148,6 +210,17 @@ eeprom_status_t EEPROM_Validate() {
         return EEPROM_STATUS_INVALID_PARAM;
     }
 
+    // 检查旋转加速度曲线是否有效
+    if (EEPROM_ValidateAccelCurve(config.accel_gain) != EEPROM_STATUS_OK) {
+        return EEPROM_STATUS_INVALID_PARAM;
+    }
+
+    // 检查 HID 端点轮询间隔是否有效，旧版本配置中该字节为 0
+    if (config.hid_poll_interval != 0 &&
+        !EEPROM_IsValidHidPollInterval(config.hid_poll_interval)) {
+        return EEPROM_STATUS_INVALID_PARAM;
+    }
+
     return EEPROM_STATUS_OK;
 }
 
@@ -335,7 +408,8 @@ uint8_t EEPROM_GetStepPerTeeth() { return config.step_per_teeth; }
  * @return 操作状态
  */
 eeprom_status_t EEPROM_SetStepPerTeeth(uint8_t step) {
-    if (step != STEP_PER_TEETH_1X && step != STEP_PER_TEETH_2X) {
+    if (step != STEP_PER_TEETH_1X && step != STEP_PER_TEETH_2X &&
+        step != STEP_PER_TEETH_4X) {
         return EEPROM_STATUS_INVALID_PARAM;
     }
 
@@ -362,3 +436,49 @@ eeprom_status_t EEPROM_SetPhase(ec11_phase_t phase) {
     config.phase = phase;
     return EEPROM_STATUS_OK;
 }
+
+/**
+ * @brief 获取旋转加速度曲线
+ * @return 各曲线节点的附加增益数组（单位 1/4 倍）
+ */
+const uint8_t *EEPROM_GetAccelCurve() { return config.accel_gain; }
+
+/**
+ * @brief 设置旋转加速度曲线
+ * @param gain 各曲线节点的附加增益数组（单位 1/4 倍），需单调不减
+ * @return 操作状态
+ */
+eeprom_status_t EEPROM_SetAccelCurve(const uint8_t *gain) {
+    if (EEPROM_ValidateAccelCurve(gain) != EEPROM_STATUS_OK) {
+        return EEPROM_STATUS_INVALID_PARAM;
+    }
+
+    memcpy(config.accel_gain, gain, sizeof(config.accel_gain));
+    return EEPROM_STATUS_OK;
+}
+
+/**
+ * @brief 获取 HID 端点轮询间隔
+ * @return 轮询间隔（毫秒）
+ */
+uint8_t EEPROM_GetHidPollInterval() {
+    if (config.hid_poll_interval == 0) {
+        return HID_POLL_INTERVAL_DEFAULT;
+    }
+
+    return config.hid_poll_interval;
+}
+
+/**
+ * @brief 设置 HID 端点轮询间隔
+ * @param interval 轮询间隔（1、2、4、8 或 10 毫秒）
+ * @return 操作状态
+ */
+eeprom_status_t EEPROM_SetHidPollInterval(uint8_t interval) {
+    if (!EEPROM_IsValidHidPollInterval(interval)) {
+        return EEPROM_STATUS_INVALID_PARAM;
+    }
+
+    config.hid_poll_interval = interval;
+    return EEPROM_STATUS_OK;
+}
@@ -46,7 +46,11 @@ typedef struct {
     uint8_t step_per_teeth; // 转动一齿触发次数 (14)
     ec11_phase_t phase;     // EC11 编码器相位配置 (15)
 
-    uint8_t reserved[16]; // 预留空间，用于未来扩展 (16-31)
+    uint8_t accel_gain[ACCEL_CURVE_POINTS]; // 旋转加速度曲线附加增益 (16-19)
+
+    uint8_t hid_poll_interval; // HID 端点轮询间隔，0 表示编译时默认值 (20)
+
+    uint8_t reserved[11]; // 预留空间，用于未来扩展 (21-31)
 } eeprom_config_t;        /* 共 32 字节 */
 
 /**
@@ -62,11 +66,18 @@ extern inline eeprom_config_t *EEPROM_GetConfigData();
 eeprom_status_t EEPROM_LoadConfig();
 
 /**
- * @brief 将配置参数写入 EEPROM
+ * @brief 将配置参数写入 EEPROM，只写入发生变化的字节
  * @return 操作状态
  */
 eeprom_status_t EEPROM_SaveConfig();
 
+/**
+ * @brief 获取上电以来实际写入 EEPROM 的字节数
+ * @details 未变化而跳过的字节不计入，用于评估配置调节造成的擦写量
+ * @return 写入字节数，超过 65535 后回绕
+ */
+uint16_t EEPROM_GetBytesWritten();
+
 /**
  * @brief 重置配置参数为默认值
  * @return 操作状态
@@ -221,4 +232,30 @@ ec11_phase_t EEPROM_GetPhase();
  */
 eeprom_status_t EEPROM_SetPhase(ec11_phase_t phase);
 
+/**
+ * @brief 获取旋转加速度曲线
+ * @return 各曲线节点的附加增益数组（单位 1/4 倍）
+ */
+const uint8_t *EEPROM_GetAccelCurve();
+
+/**
+ * @brief 设置旋转加速度曲线
+ * @param gain 各曲线节点的附加增益数组（单位 1/4 倍），需单调不减
+ * @return 操作状态
+ */
+eeprom_status_t EEPROM_SetAccelCurve(const uint8_t *gain);
+
+/**
+ * @brief 获取 HID 端点轮询间隔
+ * @return 轮询间隔（毫秒）
+ */
+uint8_t EEPROM_GetHidPollInterval();
+
+/**
+ * @brief 设置 HID 端点轮询间隔
+ * @param interval 轮询间隔（1、2、4、8 或 10 毫秒）
+ * @return 操作状态
+ */
+eeprom_status_t EEPROM_SetHidPollInterval(uint8_t interval);
+
 #endif /* __EEPROM_H__ */
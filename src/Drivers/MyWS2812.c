@@ -106,7 +106,7 @@ void WS2812_GetPixel(uint8_t index, const uint8_t *led_data, uint8_t *r,
  * @param index LED 索引
  * @param color 颜色结构体指针
  */
-inline void WS2812_SetPixelColor(uint8_t index, const ws2812_color_t *color) {
+void WS2812_SetPixelColor(uint8_t index, const ws2812_color_t *color) {
     WS2812_SetPixel(index, color->r, color->g, color->b);
 }
 
@@ -294,7 +294,7 @@ void WS2812_ShowFadeEffect() {
     // 确保进度不超过255
     progress = (progress > 255) ? 255 : progress;
 
-    __data uint8_t target_r, target_g, target_b;
+    __data uint8_t target_r = 0, target_g = 0, target_b = 0;
 
     for (uint8_t i = 0; i < ws2812.led_count; i++) {
         WS2812_GetPixel(i, ws2812.last_led_data, &target_r, &target_g,
@@ -90,8 +90,7 @@ void WS2812_GetPixel(uint8_t index, const uint8_t *led_data, uint8_t *r,
  * @param index LED 索引
  * @param color 颜色结构体指针
  */
-extern inline void WS2812_SetPixelColor(uint8_t index,
-                                        const ws2812_color_t *color);
+void WS2812_SetPixelColor(uint8_t index, const ws2812_color_t *color);
 
 /**
  * @brief 设置所有 LED 为同一颜色
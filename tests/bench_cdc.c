@@ -0,0 +1,214 @@
+/*
+  CDC 串口收发模拟
+
+  主机每帧最多收发指定数量的批量数据包：
+    发送  主循环每帧运行 1 或 8 次，输出 8 KB 的多行应答，按剩余空间写入
+          （背压）或不检查剩余空间直接写入（丢弃），输出送达所需帧数、
+          每帧字节数、丢弃的行数，以及主循环单次运行中等待 USB 的最长时间。
+          全速批量传输每帧最多 19 个数据包（1216 字节）
+    接收  主机连续发送 8 KB 数据，主循环每帧运行一次，每次最多读出
+          指定字节数，输出所需
+          帧数、每帧字节数与端点回复 NAK 的次数
+    会话  主机一次发出 20 条配置命令，主循环逐行应答，输出会话总帧数与
+          命令往返延迟
+  时间以模拟的 USB 帧计，结果与主机性能无关
+*/
+#include "usb_sim.h"
+
+#include <stdio.h>
+
+#define RESPONSE_SIZE 8000 // 应答总长度
+#define LINE_SIZE 40       // 每行长度（含换行符）
+
+/**
+ * @brief 模拟一次大应答的发送
+ * @param backpressure 是否按剩余空间写入
+ * @param packets 主机每帧最多读取的数据包数量
+ * @param loops 主循环每帧运行的次数，主机读取均匀穿插其间
+ */
+static void transmit(bool backpressure, uint8_t packets, uint8_t loops) {
+    char line[LINE_SIZE];
+    uint16_t written = 0;
+    uint16_t dropped = 0;
+    uint16_t stall_max = 0;
+    uint32_t start;
+    uint8_t slice = 0;
+    uint8_t budget = 0; // 本帧主机剩余可读取的数据包数量
+
+    usb_sim_reset();
+    usb_enumerate();
+    usb_cdc_line_state(CDC_LINE_STATE_DTR);
+    memset(line, 'x', sizeof(line));
+    start = host_millis;
+
+    while (written < RESPONSE_SIZE || sim_cdc_rx_len + dropped * LINE_SIZE <
+                                          RESPONSE_SIZE) {
+        uint32_t loop_start = host_millis;
+
+        // 主循环：写入本次能写入的行，USB 函数都不会等待主机
+        while (written < RESPONSE_SIZE &&
+               (!backpressure ||
+                USBSerial_availableForWrite() >= LINE_SIZE)) {
+            uint8_t overflow = USBSerial_getTxOverflow();
+
+            USBSerial_print_n((uint8_t *)line, LINE_SIZE - 1);
+            USBSerial_write('\n');
+            dropped += USBSerial_getTxOverflow() != overflow;
+            written += LINE_SIZE;
+        }
+        USBSerial_flush();
+
+        if (host_millis - loop_start > stall_max) {
+            stall_max = host_millis - loop_start;
+        }
+
+        if (slice++ % loops == 0) {
+            usb_frame();
+            budget = packets;
+        }
+
+        uint8_t share = (packets + loops - 1) / loops;
+        uint16_t before = sim_cdc_packets;
+        usb_cdc_in_frame(share < budget ? share : budget);
+        budget -= sim_cdc_packets - before;
+    }
+
+    uint32_t frames = host_millis - start;
+
+    printf("%-12s %2u/frame %u %6lu %8.1f %7u %6u ms\n",
+           backpressure ? "backpressure" : "drop", packets, loops,
+           (unsigned long)frames, (double)sim_cdc_rx_len / frames, dropped,
+           stall_max);
+}
+
+/**
+ * @brief 主机在一帧内从 data 发送数据包，直到端点回复 NAK
+ * @return 已发送的字节数
+ */
+static uint16_t host_send(const uint8_t *data, uint16_t len, uint8_t packets,
+                          uint16_t *naks) {
+    uint16_t sent = 0;
+
+    while (packets-- > 0 && sent < len) {
+        uint8_t size =
+            len - sent > MAX_PACKET_SIZE ? MAX_PACKET_SIZE : len - sent;
+
+        if (!usb_cdc_out(data + sent, size)) {
+            (*naks)++;
+            break;
+        }
+        sent += size;
+    }
+    return sent;
+}
+
+/**
+ * @brief 模拟主机连续发送数据
+ * @param packets 主机每帧最多发送的数据包数量
+ * @param budget 主循环每次最多读出的字节数
+ */
+static void receive(uint8_t packets, uint16_t budget) {
+    static uint8_t data[RESPONSE_SIZE];
+    uint16_t sent = 0;
+    uint16_t received = 0;
+    uint16_t naks = 0;
+
+    usb_sim_reset();
+    usb_enumerate();
+    usb_cdc_line_state(CDC_LINE_STATE_DTR);
+
+    while (received < RESPONSE_SIZE) {
+        usb_frame();
+        sent += host_send(data + sent, RESPONSE_SIZE - sent, packets, &naks);
+
+        for (uint16_t n = budget; n > 0 && USBSerial_available(); n--) {
+            USBSerial_read();
+            received++;
+        }
+    }
+
+    printf("%2u/frame %4u B/loop %6lu %8.1f %6u\n", packets, budget,
+           (unsigned long)host_millis, (double)RESPONSE_SIZE / host_millis,
+           naks);
+}
+
+/**
+ * @brief 模拟一次配置会话：主机一次发出全部命令，主循环逐行应答
+ */
+static void session() {
+    static const char command[] = "set_brightness=3\n";
+    uint8_t data[20 * (sizeof(command) - 1)];
+    uint32_t sent_at[20];
+    uint16_t sent = 0;
+    uint16_t naks = 0;
+    uint8_t replies = 0;
+    uint16_t scanned = 0;
+    uint32_t rtt_sum = 0;
+    uint32_t rtt_max = 0;
+
+    usb_sim_reset();
+    usb_enumerate();
+    usb_cdc_line_state(CDC_LINE_STATE_DTR);
+    for (uint8_t i = 0; i < 20; i++) {
+        memcpy(data + i * (sizeof(command) - 1), command,
+               sizeof(command) - 1);
+    }
+
+    while (replies < 20) {
+        usb_frame();
+
+        // 命令最后一个字节发出的帧即为发出时刻
+        uint16_t before = sent;
+        sent += host_send(data + sent, sizeof(data) - sent, 19, &naks);
+        for (uint16_t i = before; i < sent; i++) {
+            if (data[i] == '\n') {
+                sent_at[i / (sizeof(command) - 1)] = host_millis;
+            }
+        }
+
+        // 主循环读出全部已接收的数据，每行应答一次
+        while (USBSerial_available()) {
+            if (USBSerial_read() == '\n') {
+                USBSerial_print_n((uint8_t *)"ok\n", 3);
+                USBSerial_commit();
+            }
+        }
+        USBSerial_flush();
+
+        usb_cdc_in_frame(19);
+        for (; scanned < sim_cdc_rx_len; scanned++) {
+            if (sim_cdc_rx[scanned] == '\n') {
+                uint32_t rtt = host_millis - sent_at[replies++];
+
+                rtt_sum += rtt;
+                rtt_max = rtt > rtt_max ? rtt : rtt_max;
+            }
+        }
+    }
+
+    printf("20 commands in %lu frames, rtt avg %.1f max %lu frames, "
+           "%u NAKs\n",
+           (unsigned long)host_millis, rtt_sum / 20.0,
+           (unsigned long)rtt_max, naks);
+}
+
+int main() {
+    static const uint8_t packets[] = {1, 2, 4, 19};
+
+    printf("policy       host  loops frames  B/frame dropped  max stall\n");
+    for (uint8_t i = 0; i < sizeof(packets); i++) {
+        transmit(true, packets[i], 1);
+        transmit(true, packets[i], 8);
+        transmit(false, packets[i], 1);
+    }
+
+    printf("\nhost     loop        frames  B/frame   NAKs\n");
+    receive(1, 64);
+    receive(19, 64);
+    receive(19, 128);
+    receive(19, 1024);
+
+    printf("\n");
+    session();
+    return 0;
+}
@@ -0,0 +1,177 @@
+/*
+  编码器采样抖动与丢步模拟
+
+  以轮询或定时器采样方式编译驱动（bench_jitter_polling 与
+  bench_jitter_timer），按微秒推进模拟时间。主循环每次迭代调用
+  EC11_UpdateStatus 并取出旋转事件，迭代耗时按固定随机序列产生：
+    多数迭代    0.2~0.8 毫秒
+    LED 刷新    2~5 毫秒，约 9% 的迭代
+    USB 阻塞    20~100 毫秒，约 1% 的迭代
+  编码器以固定速率顺时针旋转 10 秒，每齿 4 次 A/B 相跳变均匀分布。
+  轮询方式在每次迭代开始时采样，定时器方式由定时器中断按
+  EC11_SAMPLE_RATE_HZ 采样。输出相邻两次采样间隔的分布（中位数、
+  90%/99% 分位数与最大值，微秒）、转过的齿数与丢失的齿数，以及检测到的
+  非法跳变次数。时间为模拟时间，结果与主机性能无关
+*/
+#include "../src/Drivers/EC11.c"
+#include "ec11_sim.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define SPIN_US 10000000UL // 旋转持续时间
+#define TAIL_US 200000UL   // 旋转停止后主循环继续运行的时间
+#define MAX_SAMPLES 40000
+
+#if EC11_SAMPLE_MODE == EC11_SAMPLE_TIMER
+#define MODE_NAME "timer"
+#define TICK_US (1000000UL / EC11_SAMPLE_RATE_HZ)
+#else
+#define MODE_NAME "polling"
+#endif
+
+static uint32_t now_us;
+static uint32_t next_edge_us; // 下一次 A/B 相跳变的时刻
+static uint32_t edge_us;      // 相邻两次跳变的间隔
+static uint32_t edges;        // 已产生的跳变次数
+#if EC11_SAMPLE_MODE == EC11_SAMPLE_TIMER
+static uint32_t next_tick_us; // 下一次定时器中断的时刻
+#endif
+
+static uint32_t samples;
+static uint32_t last_sample_us;
+static uint32_t intervals[MAX_SAMPLES];
+static uint32_t detents_received;
+
+/**
+ * @brief 记录一次采样的时刻
+ */
+static void record_sample() {
+    if (samples > 0 && samples <= MAX_SAMPLES) {
+        intervals[samples - 1] = now_us - last_sample_us;
+    }
+    last_sample_us = now_us;
+    samples++;
+}
+
+/**
+ * @brief 推进模拟时间，按时间顺序处理期间的 A/B 相跳变与定时器中断
+ */
+static void advance_to(uint32_t end_us) {
+    for (;;) {
+        uint32_t next = end_us;
+
+        if (next_edge_us < next) {
+            next = next_edge_us;
+        }
+#if EC11_SAMPLE_MODE == EC11_SAMPLE_TIMER
+        if (next_tick_us < next) {
+            next = next_tick_us;
+        }
+#endif
+        now_us = next;
+        host_millis = now_us / 1000;
+        host_micros = now_us;
+
+        if (now_us == next_edge_us) {
+            edges++;
+            sim_set_ab(0, CW_DETENT[(edges - 1) & 3]);
+            next_edge_us = (now_us + edge_us < SPIN_US) ? now_us + edge_us
+                                                         : UINT32_MAX;
+#if EC11_SAMPLE_MODE == EC11_SAMPLE_TIMER
+        } else if (now_us == next_tick_us) {
+            TF2 = 1;
+            EC11_TimerInterrupt();
+            record_sample();
+            next_tick_us += TICK_US;
+#endif
+        } else {
+            return;
+        }
+    }
+}
+
+/**
+ * @brief 产生一次主循环迭代的耗时
+ */
+static uint32_t loop_duration() {
+    int r = rand() % 100;
+
+    if (r == 0) {
+        return 20000 + rand() % 80001; // USB 阻塞
+    }
+    if (r < 10) {
+        return 2000 + rand() % 3001; // LED 刷新
+    }
+    return 200 + rand() % 601;
+}
+
+static int compare(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+static uint32_t percentile(uint32_t count, uint8_t p) {
+    return intervals[(uint32_t)((uint64_t)(count - 1) * p / 100)];
+}
+
+/**
+ * @brief 以给定转速模拟一次旋转
+ * @param rate 每秒齿数
+ */
+static void simulate(uint16_t rate) {
+    srand(1);
+    sim_reset();
+    EC11_SetStepPerTeeth(STEP_PER_TEETH_1X);
+
+    now_us = 0;
+    edge_us = 1000000UL / rate / 4;
+    next_edge_us = edge_us;
+    edges = 0;
+#if EC11_SAMPLE_MODE == EC11_SAMPLE_TIMER
+    next_tick_us = TICK_US;
+#endif
+    samples = 0;
+    detents_received = 0;
+
+    while (now_us < SPIN_US + TAIL_US) {
+        uint8_t index;
+
+#if EC11_SAMPLE_MODE == EC11_SAMPLE_POLLING
+        record_sample();
+#endif
+        EC11_UpdateStatus();
+        while (EC11_GetDirection(&index) == EC11_DIR_CW) {
+            detents_received++;
+        }
+
+        advance_to(now_us + loop_duration());
+    }
+
+    uint32_t count = (samples - 1 < MAX_SAMPLES) ? samples - 1 : MAX_SAMPLES;
+    uint32_t detents = edges / 4;
+
+    qsort(intervals, count, sizeof(intervals[0]), compare);
+    printf("%-8s %5u/s %7lu %6lu %6lu %6lu %7lu %7lu %5lu %7u\n", MODE_NAME,
+           rate, (unsigned long)samples, (unsigned long)percentile(count, 50),
+           (unsigned long)percentile(count, 90),
+           (unsigned long)percentile(count, 99),
+           (unsigned long)intervals[count - 1], (unsigned long)detents,
+           (unsigned long)(detents - detents_received),
+           EC11_GetInvalidTransitions(0));
+}
+
+int main() {
+#if EC11_SAMPLE_MODE == EC11_SAMPLE_POLLING
+    printf("                              sample interval (us)\n");
+    printf("mode       speed samples    p50    p90    p99     max detents "
+           " lost invalid\n");
+#endif
+    simulate(5);
+    simulate(20);
+    simulate(50);
+
+    return 0;
+}
@@ -0,0 +1,136 @@
+/*
+  多编码器采样耗时
+
+  以轮询采样方式编译 EC11 驱动，EC11_COUNT 由编译参数指定（1~4 各编译
+  一次）。全部编码器同时持续旋转，计时以下路径，均已扣除模拟引脚电平的
+  开销：
+    采样        EC11_UpdateStatus，包含端口读取、旋转解码与按键处理
+    端口快照    EC11_READ_PORTS，全部编码器共用，只读取用到的端口
+    按引脚读取  每个编码器的 A/B/K 各调用一次 digitalRead，即改为端口
+                快照之前每个编码器单独读取引脚的方式
+  并以采样耗时减去端口快照、加上按引脚读取，估计按引脚读取时的采样耗时。
+  端口读取次数不随编码器数量增加，旋转解码与按键处理仍按编码器逐个进行。
+  EC11_COUNT 为 1 时引脚在编译时确定，之后经由引脚表查找，因此 1 到 2 个
+  编码器的耗时增加较多。
+  主机耗时不等于 CH552 上的指令周期数，只用于比较不同编码器数量的相对开销
+*/
+#include <Arduino.h>
+
+// 端口寄存器以 volatile 读取并计数，避免主机编译器把读取与模拟引脚电平的
+// 写入合并
+static uint8_t port1 = 0xFF;
+static uint8_t port3 = 0xFF;
+static uint32_t port_reads;
+
+#define P1 (port_reads++, *(volatile uint8_t *)&port1)
+#define P3 (port_reads++, *(volatile uint8_t *)&port3)
+#define SIM_P1 port1
+#define SIM_P3 port3
+
+#include "../src/Drivers/EC11.c"
+#include "digital_read.h"
+#include "ec11_sim.h"
+
+#include <stdio.h>
+#include <time.h>
+
+#define ITERATIONS 1000000UL
+#define ROUNDS 5 // 取多轮中的最短耗时，减少调度干扰
+
+static volatile uint8_t sink;
+
+static double now_seconds() {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * @brief 模拟全部编码器旋转，每两次采样改变一次 A/B 相
+ */
+static void drive(uint32_t n) {
+    for (uint8_t i = 0; i < EC11_COUNT; i++) {
+        sim_set_ab(i, CW_DETENT[(n >> 1) & 3]);
+    }
+}
+
+typedef void (*sample_fn)(uint32_t n);
+
+static void input_only(uint32_t n) { drive(n); }
+
+static void sample(uint32_t n) {
+    drive(n);
+    host_millis = n >> 1;
+    EC11_UpdateStatus();
+    // 丢弃事件，避免缓冲区写满后只测到丢弃路径
+    event_tail = event_head;
+}
+
+static void read_snapshot(uint32_t n) {
+    __data uint8_t ports[2];
+
+    drive(n);
+    EC11_READ_PORTS(ports);
+    for (uint8_t i = 0; i < EC11_COUNT; i++) {
+        sink = EC11_AB_STATE(ports, i);
+        sink = EC11_KEY_LOW(ports, i);
+    }
+}
+
+static void read_per_pin(uint32_t n) {
+    drive(n);
+    for (uint8_t i = 0; i < EC11_COUNT; i++) {
+        sink = (core_digitalRead(EC11_MAP_PIN_A(i)) << 1) |
+               core_digitalRead(EC11_MAP_PIN_B(i));
+        sink = core_digitalRead(EC11_MAP_PIN_K(i));
+    }
+}
+
+/**
+ * @brief 测量每次调用的耗时
+ * @return 多轮中的最短平均耗时（纳秒）
+ */
+static double measure(sample_fn fn) {
+    double best = 0;
+
+    for (uint8_t round = 0; round < ROUNDS; round++) {
+        sim_reset();
+        EC11_SetStepPerTeeth(STEP_PER_TEETH_4X);
+        port_reads = 0;
+
+        double start = now_seconds();
+        for (uint32_t n = 0; n < ITERATIONS; n++) {
+            fn(n);
+        }
+        double ns = (now_seconds() - start) * 1e9 / ITERATIONS;
+
+        if (round == 0 || ns < best) {
+            best = ns;
+        }
+    }
+
+    return best;
+}
+
+int main() {
+    double input = measure(input_only);
+    double update = measure(sample) - input;
+    double reads = (double)port_reads / ITERATIONS;
+    double snapshot = measure(read_snapshot) - input;
+    double per_pin = measure(read_per_pin) - input;
+    double estimate = update - snapshot + per_pin;
+
+#if EC11_COUNT == 1
+    printf("%8s | %-18s | %-15s | %-15s | %-18s\n", "", "sample",
+           "port snapshot", "per-pin reads", "per-pin sample");
+    printf("%8s | %7s %10s | %5s %9s | %5s %9s | %7s %10s\n", "encoders",
+           "ns", "ns/encoder", "reads", "ns", "calls", "ns", "ns",
+           "ns/encoder");
+#endif
+    printf("%8u | %7.2f %10.2f | %5.1f %9.2f | %5u %9.2f | %7.2f %10.2f\n",
+           EC11_COUNT, update, update / EC11_COUNT, reads, snapshot,
+           3 * EC11_COUNT, per_pin, estimate, estimate / EC11_COUNT);
+
+    return 0;
+}
@@ -0,0 +1,126 @@
+/*
+  编码器采样路径耗时
+
+  以定时器采样方式编译 EC11 驱动，在主机上计时比较：
+    digitalRead ×3  改为端口快照之前的读取方式，按 CH55xduino 核心的
+                    digitalRead 实现（查表得到端口与位掩码后按端口分支），
+                    每个引脚一次函数调用
+    端口快照        EC11_READ_PORTS 读取一次端口寄存器后按位提取
+    定时器中断      EC11_TimerInterrupt，即实际的采样中断路径
+    主循环更新      EC11_UpdateStatus，定时器采样方式下只处理按键
+  编码器以每两次采样改变一次 A/B 相的速度持续旋转，输出每次调用的耗时，
+  已扣除模拟引脚电平的开销。
+  开发环境中没有 8051 模拟器，主机耗时不等于 CH552 上的指令周期数，
+  只用于比较同一台主机上两种读取方式的相对开销
+*/
+#include <Arduino.h>
+
+// 端口寄存器每次访问都读取硬件，以 volatile 读取代替，避免主机编译器
+// 把读取与模拟引脚电平的写入合并
+static uint8_t port1 = 0xFF;
+static uint8_t port3 = 0xFF;
+
+#define P1 (*(volatile uint8_t *)&port1)
+#define P3 (*(volatile uint8_t *)&port3)
+#define SIM_P1 port1
+#define SIM_P3 port3
+
+#include "../src/Drivers/EC11.c"
+#include "digital_read.h"
+#include "ec11_sim.h"
+
+#include <stdio.h>
+#include <time.h>
+
+#define ITERATIONS 2000000UL
+#define ROUNDS 5 // 取多轮中的最短耗时，减少调度干扰
+
+static volatile uint8_t sink;
+
+/**
+ * @brief 模拟编码器旋转，每两次采样改变一次 A/B 相
+ */
+static void drive(uint32_t n) { sim_set_ab(0, CW_DETENT[(n >> 1) & 3]); }
+
+static double now_seconds() {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+typedef void (*sample_fn)(uint32_t n);
+
+static void input_only(uint32_t n) { drive(n); }
+
+static void read_digital(uint32_t n) {
+    drive(n);
+    sink = (core_digitalRead(EC11_PIN_A) << 1) | core_digitalRead(EC11_PIN_B);
+    sink = core_digitalRead(EC11_PIN_K);
+}
+
+static void read_snapshot(uint32_t n) {
+    __data uint8_t ports[2];
+
+    drive(n);
+    EC11_READ_PORTS(ports);
+    sink = EC11_AB_STATE(ports, 0);
+    sink = EC11_KEY_LOW(ports, 0);
+}
+
+static void timer_isr(uint32_t n) {
+    drive(n);
+    EC11_TimerInterrupt();
+    // 丢弃事件，避免缓冲区写满后只测到丢弃路径
+    event_tail = event_head;
+}
+
+static void main_update(uint32_t n) {
+    drive(n);
+    host_millis = n >> 1;
+    EC11_UpdateStatus();
+}
+
+/**
+ * @brief 测量每次调用的耗时
+ * @return 多轮中的最短平均耗时（纳秒）
+ */
+static double measure(sample_fn fn) {
+    double best = 0;
+
+    for (uint8_t round = 0; round < ROUNDS; round++) {
+        sim_reset();
+        EC11_SetStepPerTeeth(STEP_PER_TEETH_4X);
+
+        double start = now_seconds();
+        for (uint32_t n = 0; n < ITERATIONS; n++) {
+            fn(n);
+        }
+        double ns = (now_seconds() - start) * 1e9 / ITERATIONS;
+
+        if (round == 0 || ns < best) {
+            best = ns;
+        }
+    }
+
+    return best;
+}
+
+int main() {
+    double input = measure(input_only);
+    double digital = measure(read_digital) - input;
+    double snapshot = measure(read_snapshot) - input;
+    double isr = measure(timer_isr) - input;
+    double update = measure(main_update) - input;
+
+    printf("%-18s %10s\n", "path", "ns/call");
+    printf("%-18s %10.2f\n", "digitalRead x3", digital);
+    printf("%-18s %10.2f\n", "port snapshot", snapshot);
+    printf("%-18s %10.2f\n", "timer interrupt", isr);
+    printf("%-18s %10.2f\n", "main loop update", update);
+    if (snapshot > 0) {
+        printf("digitalRead x3 / port snapshot: %.1fx\n", digital / snapshot);
+    }
+
+    return 0;
+}
@@ -0,0 +1,149 @@
+/*
+  径向控制器报告发送模拟
+
+  编码器以固定速率旋转 1 秒，主循环每毫秒运行一次，比较两种发送方式：
+    阻塞发送  每齿调用 Radial_SendReport，端点3 忙时忙等（最长 250 毫秒），
+              即改为报告队列之前的发送方式
+    报告队列  每齿调用 Radial_SendData，旋转量合并后在主机轮询前装入端点3
+  输出主机每秒收到的报告数、主循环处理完全部事件时仍未送达的角度，以及
+  主循环因发送而阻塞的最长与累计时间。
+  另在随机时刻产生单齿旋转，输出各轮询间隔下从输入到主机取走报告的延迟。
+  时间以模拟的 USB 帧计，结果与主机性能无关
+*/
+#include "usb_sim.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define SPIN_MS 1000        // 旋转持续时间
+#define TAIL_MS 100         // 旋转停止后等待主机取走剩余报告的时间
+#define SEND_TIMEOUT_MS 250 // 阻塞发送的忙等上限（50000 × 5 微秒）
+#define DETENT_DEGREE 10    // 每齿旋转角度，同默认配置
+
+static uint16_t spin_rate; // 每秒齿数
+static uint16_t arrived;   // 已产生的旋转事件数
+static uint16_t pending;   // 等待主循环处理的事件，容量同 EC11 事件缓冲区
+static uint16_t dropped;   // 事件缓冲区已满或发送超时丢弃的事件数
+
+/**
+ * @brief 运行一帧，并按旋转速率产生到当前时刻为止的编码器事件
+ */
+static void tick() {
+    uint32_t now = host_millis + 1 < SPIN_MS ? host_millis + 1 : SPIN_MS;
+    uint16_t due = now * spin_rate / 1000;
+
+    usb_frame();
+    while (arrived < due) {
+        arrived++;
+        if (pending < EC11_EVENT_BUFFER_SIZE) {
+            pending++;
+        } else {
+            dropped++;
+        }
+    }
+}
+
+/**
+ * @brief 模拟一种发送方式
+ * @param blocking 是否使用阻塞发送
+ * @param interval HID 端点轮询间隔（毫秒）
+ */
+static void simulate(bool blocking, uint8_t interval, uint16_t rate) {
+    uint16_t stall_max = 0;
+    uint32_t stall_total = 0;
+
+    usb_sim_reset();
+    Radial_SetPollInterval(interval);
+    usb_enumerate();
+    host_millis = 0;
+    spin_rate = rate;
+    arrived = 0;
+    pending = 0;
+    dropped = 0;
+
+    while (host_millis < SPIN_MS + TAIL_MS) {
+        tick();
+
+        while (pending > 0) {
+            pending--;
+
+            if (!blocking) {
+                Radial_SendData(0, 0, DETENT_DEGREE);
+                continue;
+            }
+
+            uint16_t waited = 0;
+            RadialReport report = {RADIAL_REPORT_ID,
+                                   (DETENT_DEGREE * 10) & RADIAL_DIAL_MASK};
+
+            while (UpPoint3_Busy && waited < SEND_TIMEOUT_MS) {
+                tick();
+                waited++;
+            }
+            stall_total += waited;
+            if (waited > stall_max) {
+                stall_max = waited;
+            }
+
+            if (!Radial_SendReport(&report)) {
+                dropped++;
+            }
+        }
+    }
+
+    int32_t received = sim_dial_total[0] / 10;
+    int32_t input = (int32_t)arrived * DETENT_DEGREE;
+
+    printf("%-8s %2u ms %5u/s %7.1f %7ld %7ld %7ld %6u ms %6lu ms\n",
+           blocking ? "blocking" : "queue", interval, rate,
+           sim_report_count * 1000.0 / host_millis, (long)input,
+           (long)received, (long)(input - received), stall_max,
+           (unsigned long)stall_total);
+}
+
+/**
+ * @brief 统计单齿旋转从输入到主机取走报告的延迟
+ * @param interval HID 端点轮询间隔（毫秒）
+ */
+static void latency(uint8_t interval) {
+    RadialLatencyStats stats;
+
+    usb_sim_reset();
+    Radial_SetPollInterval(interval);
+    usb_enumerate();
+    srand(interval);
+
+    for (uint16_t n = 0; n < 1000; n++) {
+        usb_frames(rand() % 50);
+        Radial_SetInputTime((uint16_t)host_millis);
+        Radial_SendData(0, 0, DETENT_DEGREE);
+        usb_drain_reports(100);
+    }
+
+    Radial_TakeLatencyStats(&stats);
+    printf("%2u ms %6u %4u ms %4u ms %4u ms\n", interval, stats.count,
+           stats.min, stats.average, stats.max);
+}
+
+int main() {
+    static const uint8_t intervals[] = {HID_POLL_INTERVAL_10MS,
+                                        HID_POLL_INTERVAL_1MS};
+    static const uint16_t rates[] = {50, 200, 1000};
+
+    printf("mode     poll   detents reports   input  recv'd    lost "
+           "max stall  sum stall\n");
+    for (uint8_t i = 0; i < sizeof(intervals); i++) {
+        for (uint8_t r = 0; r < sizeof(rates) / sizeof(rates[0]); r++) {
+            simulate(true, intervals[i], rates[r]);
+            simulate(false, intervals[i], rates[r]);
+        }
+    }
+
+    printf("\npoll  inputs     min     avg     max\n");
+    latency(HID_POLL_INTERVAL_10MS);
+    latency(HID_POLL_INTERVAL_8MS);
+    latency(HID_POLL_INTERVAL_4MS);
+    latency(HID_POLL_INTERVAL_2MS);
+    latency(HID_POLL_INTERVAL_1MS);
+    return 0;
+}
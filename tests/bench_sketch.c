@@ -0,0 +1,422 @@
+/*
+  主程序串口命令解析基准测试
+
+  解析    以配置工具会话的命令组合反复解析，比较按字节推进的接收状态机与
+          命令表（receive_byte）和之前的实现（每字节 strlen/memcmp 检查
+          save_settings= 前缀，命令结束后依次 strcmp），只解析不执行命令。
+          输出每字节与每条命令中字符串函数扫描的字节数，SDCC 下这部分
+          开销与之成正比
+  调节    模拟拖动亮度滑块，每 50 毫秒修改一次，比较每次发送完整配置
+          （save_settings=）与只发送修改的参数（set_brightness=），
+          输出拖动结束并保存后写入 EEPROM 的字节数、LED 重新初始化次数，
+          以及每次修改从发送到收到应答的主机耗时
+  突发    主机连接时一次发出进入配置模式、读取配置与读取全部单项参数的
+          命令，主循环每帧运行一次，比较在时间预算内执行全部完整命令与
+          每次循环只执行一条命令（每条命令耗时超出预算时的行为），输出
+          收到全部应答所需的帧数
+  参数    对参数表中的每个参数名称，比较 find_param 与之前的实现（逐项
+          strlen 计算名称长度后比较）的查找耗时与扫描的字节数，并计时
+          get_<参数名> 与 set_<参数名>=<当前值> 命令从接收到执行完毕的
+          分发耗时（含 receive_byte、命令表查找、参数查找与处理函数，
+          串口未打开，应答直接丢弃）
+  主机耗时只用于比较不同实现的相对开销
+*/
+#define SIM_COUNT_STRING_OPS
+#include "sketch_sim.h"
+
+#include <time.h>
+
+#define ROUNDS 20000
+#define REPEATS 5 // 参数查找与分发取多轮中的最短耗时，减少调度干扰
+#define SLIDER_CHANGES 40 // 拖动滑块产生的修改次数
+#define SLIDER_STEP_MS 50 // 相邻两次修改的间隔
+
+// 之前的实现依次比较的命令名称，顺序同原 process_commands
+static const char *const legacy_names[] = {
+    CMD_CONFIG_MODE_ENABLED, CMD_CONFIG_HEARTBEAT, CMD_CONFIG_LOAD_SETTINGS,
+    CMD_CONFIG_SAVE_SETTINGS_PREFIX, CMD_CONFIG_RESET_SETTINGS,
+    CMD_TEST_SHOW_MENU, CMD_TEST_CLICK, CMD_TEST_ROTATE_LEFT,
+    CMD_TEST_ROTATE_RIGHT, CMD_TEST_LATENCY, CMD_TEST_POLL_STATS,
+};
+
+static uint8_t param_lengths[PARAM_COUNT]; // 参数名称长度
+
+static uint8_t session[512];
+static uint16_t session_len;
+static uint8_t session_commands;
+
+static double now_seconds() {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void append(const void *data, uint8_t len) {
+    memcpy(session + session_len, data, len);
+    session_len += len;
+    session_commands++;
+}
+
+/**
+ * @brief 生成一次配置会话的命令：心跳为主，夹杂读取、保存与测试命令
+ */
+static void make_session() {
+    static const char *const text[] = {
+        "config_mode_enabled\n", "load_settings\n", "heartbeat\n",
+        "heartbeat\n",           "latency\n",       "heartbeat\n",
+        "poll_stats\n",          "heartbeat\n",     "rotate_right\n",
+        "heartbeat\n",
+    };
+    uint8_t save[64];
+
+    for (uint8_t i = 0; i < sizeof(text) / sizeof(text[0]); i++) {
+        append(text[i], strlen(text[i]));
+    }
+
+    memcpy(save, CMD_CONFIG_SAVE_SETTINGS_PREFIX,
+           sizeof(CMD_CONFIG_SAVE_SETTINGS_PREFIX) - 1);
+    memcpy(save + sizeof(CMD_CONFIG_SAVE_SETTINGS_PREFIX) - 1,
+           (uint8_t *)EEPROM_GetConfigData() + 2,
+           CMD_CONFIG_SAVE_SETTINGS_PAYLOAD);
+    save[sizeof(CMD_CONFIG_SAVE_SETTINGS_PREFIX) - 1 +
+         CMD_CONFIG_SAVE_SETTINGS_PAYLOAD] = '\n';
+    append(save, sizeof(CMD_CONFIG_SAVE_SETTINGS_PREFIX) +
+                     CMD_CONFIG_SAVE_SETTINGS_PAYLOAD);
+}
+
+/**
+ * @brief 之前的实现：按字节接收，完整命令后依次比较命令名称
+ * @return 识别出的命令数量
+ */
+static uint16_t legacy_parse(const uint8_t *data, uint16_t len) {
+    static uint8_t buf[50];
+    uint8_t ptr = 0;
+    uint16_t found = 0;
+    bool is_save_command = false;
+
+    for (uint16_t n = 0; n < len; n++) {
+        uint8_t c = data[n];
+        bool complete = false;
+
+        if (ptr >= strlen(CMD_CONFIG_SAVE_SETTINGS_PREFIX)) {
+            is_save_command =
+                memcmp(buf, CMD_CONFIG_SAVE_SETTINGS_PREFIX,
+                       strlen(CMD_CONFIG_SAVE_SETTINGS_PREFIX)) == 0;
+        }
+
+        if (is_save_command) {
+            buf[ptr++] = c;
+            if (ptr >= strlen(CMD_CONFIG_SAVE_SETTINGS_PREFIX) + 30 + 1) {
+                buf[ptr] = '\0';
+                complete = true;
+            }
+        } else if (c == '\n' || c == '\r') {
+            buf[ptr] = '\0';
+            complete = ptr > 0;
+        } else {
+            buf[ptr++] = c;
+            if (ptr >= sizeof(buf) - 1) {
+                buf[ptr] = '\0';
+                complete = true;
+            }
+        }
+
+        if (!complete) {
+            continue;
+        }
+
+        for (uint8_t i = 0; i < sizeof(legacy_names) / sizeof(char *); i++) {
+            const char *name = legacy_names[i];
+
+            if (i == 3 ? memcmp(buf, name, strlen(name)) == 0
+                       : strcmp((char *)buf, name) == 0) {
+                found++;
+                break;
+            }
+        }
+        ptr = 0;
+        is_save_command = false;
+    }
+    return found;
+}
+
+/**
+ * @brief 当前实现：receive_byte 在结束符处查命令表
+ * @return 识别出的命令数量
+ */
+static uint16_t table_parse(const uint8_t *data, uint16_t len) {
+    uint16_t found = 0;
+
+    for (uint16_t n = 0; n < len; n++) {
+        if (receive_byte(data[n])) {
+            found += receive_command != NULL;
+            receive_ptr = 0;
+        }
+    }
+    return found;
+}
+
+static void bench(const char *name, uint16_t (*parse)(const uint8_t *,
+                                                      uint16_t)) {
+    uint16_t found;
+
+    sim_string_ops = 0;
+    found = parse(session, session_len);
+    uint32_t ops = sim_string_ops;
+
+    double start = now_seconds();
+    for (uint32_t n = 0; n < ROUNDS; n++) {
+        parse(session, session_len);
+    }
+    double elapsed = now_seconds() - start;
+
+    printf("%-8s %5.1f %8.1f %9.2f ns %9.1f ns %s\n", name,
+           (double)ops / session_len, (double)ops / session_commands,
+           elapsed * 1e9 / ((double)session_len * ROUNDS),
+           elapsed * 1e9 / ((double)session_commands * ROUNDS),
+           found == session_commands ? "" : "(missed commands)");
+}
+
+/**
+ * @brief 之前的实现：逐项以 strlen 计算参数名称长度后比较
+ */
+static __code param_entry_t *legacy_find_param(const uint8_t *name,
+                                               uint8_t length) {
+    for (uint8_t i = 0; i < PARAM_COUNT; i++) {
+        __code param_entry_t *entry = &param_table[i];
+
+        if (strlen(entry->name) == length &&
+            memcmp(name, entry->name, length) == 0) {
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief 依次查找参数表中的全部参数名称
+ * @return 查找到正确条目的数量
+ */
+static uint8_t lookup_all(__code param_entry_t *(*find)(const uint8_t *,
+                                                        uint8_t)) {
+    uint8_t found = 0;
+
+    for (uint8_t i = 0; i < PARAM_COUNT; i++) {
+        const char *name = param_table[i].name;
+
+        found += find((const uint8_t *)name, param_lengths[i]) ==
+                 &param_table[i];
+    }
+    return found;
+}
+
+static void lookup(const char *name,
+                   __code param_entry_t *(*find)(const uint8_t *, uint8_t)) {
+    uint8_t found;
+
+    sim_string_ops = 0;
+    found = lookup_all(find);
+    uint32_t ops = sim_string_ops;
+
+    double elapsed = 0;
+    for (uint8_t repeat = 0; repeat < REPEATS; repeat++) {
+        double start = now_seconds();
+        for (uint32_t n = 0; n < ROUNDS; n++) {
+            lookup_all(find);
+        }
+        double seconds = now_seconds() - start;
+
+        if (repeat == 0 || seconds < elapsed) {
+            elapsed = seconds;
+        }
+    }
+
+    printf("%-8s %8.1f %9.2f ns %s\n", name, (double)ops / PARAM_COUNT,
+           elapsed * 1e9 / ((double)PARAM_COUNT * ROUNDS),
+           found == PARAM_COUNT ? "" : "(missed parameters)");
+}
+
+/**
+ * @brief 计时一批命令从接收到执行完毕的耗时
+ * @param text 以换行符分隔的命令
+ * @param commands 命令数量
+ */
+static void dispatch(const char *name, const char *text, uint8_t commands) {
+    uint16_t len = strlen(text);
+
+    double elapsed = 0;
+    for (uint8_t repeat = 0; repeat < REPEATS; repeat++) {
+        double start = now_seconds();
+        for (uint32_t n = 0; n < ROUNDS; n++) {
+            for (uint16_t i = 0; i < len; i++) {
+                if (receive_byte(text[i])) {
+                    process_commands(receive_buf);
+                    receive_ptr = 0;
+                }
+            }
+        }
+        double seconds = now_seconds() - start;
+
+        if (repeat == 0 || seconds < elapsed) {
+            elapsed = seconds;
+        }
+    }
+
+    printf("%-8s %9.2f ns\n", name,
+           elapsed * 1e9 / ((double)commands * ROUNDS));
+}
+
+static void dispatch_params() {
+    char get[512];
+    char set[512];
+    uint16_t get_len = 0;
+    uint16_t set_len = 0;
+
+    sketch_reset();
+    for (uint8_t i = 0; i < PARAM_COUNT; i++) {
+        get_len += sprintf(get + get_len, "get_%s\n", param_table[i].name);
+        set_len += sprintf(set + set_len, "set_%s=%d\n", param_table[i].name,
+                           param_table[i].get());
+    }
+
+    dispatch("get", get, PARAM_COUNT);
+    dispatch("set", set, PARAM_COUNT);
+}
+
+/**
+ * @brief 模拟拖动亮度滑块
+ * @param full 是否每次发送完整配置
+ */
+static void tune(bool full) {
+    uint8_t command[64];
+    uint8_t prefix = sizeof(CMD_CONFIG_SAVE_SETTINGS_PREFIX) - 1;
+    double apply = 0;
+
+    sketch_reset();
+    usb_enumerate();
+    usb_cdc_line_state(CDC_LINE_STATE_DTR);
+
+    uint16_t written = EEPROM_GetBytesWritten();
+    uint16_t inits = sim_led_inits;
+
+    for (uint8_t n = 0; n < SLIDER_CHANGES; n++) {
+        // 亮度在 0 到最大值之间往复
+        uint8_t period = 2 * BRIGHTNESS_MAX;
+        uint8_t level = n % period <= BRIGHTNESS_MAX ? n % period
+                                                     : period - n % period;
+        uint8_t len;
+
+        if (full) {
+            eeprom_config_t config = *EEPROM_GetConfigData();
+
+            config.brightness = level;
+            memcpy(command, CMD_CONFIG_SAVE_SETTINGS_PREFIX, prefix);
+            memcpy(command + prefix, (uint8_t *)&config + 2,
+                   CMD_CONFIG_SAVE_SETTINGS_PAYLOAD);
+            len = prefix + CMD_CONFIG_SAVE_SETTINGS_PAYLOAD;
+            command[len++] = '\n';
+        } else {
+            len = snprintf((char *)command, sizeof(command),
+                           "set_brightness=%u\n", level);
+        }
+
+        double start = now_seconds();
+        sketch_send_data(command, len);
+        sketch_replies();
+        apply += now_seconds() - start;
+
+        sketch_run(SLIDER_STEP_MS);
+    }
+    sketch_run(SETTINGS_SAVE_DELAY + INPUT_IDLE_TIME);
+
+    printf("%-15s %7u %8u %10.2f us\n",
+           full ? "save_settings=" : "set_brightness=",
+           EEPROM_GetBytesWritten() - written, sim_led_inits - inits,
+           apply * 1e6 / SLIDER_CHANGES);
+}
+
+/**
+ * @brief 模拟主机连接时的突发命令
+ * @param command_us 每条命令的执行耗时（微秒）
+ */
+static void burst(uint16_t command_us) {
+    char text[512];
+    uint16_t len = 0;
+    uint16_t sent = 0;
+    uint8_t expected = 2 + PARAM_COUNT;
+    uint8_t replies = 0;
+    uint16_t scanned = 0;
+
+    len += sprintf(text + len, "config_mode_enabled\nload_settings\n");
+    for (uint8_t i = 0; i < PARAM_COUNT; i++) {
+        len += sprintf(text + len, "get_%s\n", param_table[i].name);
+    }
+
+    sketch_reset();
+    usb_enumerate();
+    usb_cdc_line_state(CDC_LINE_STATE_DTR);
+    sim_micros_step = command_us;
+    sim_cdc_rx_len = 0;
+    uint32_t start = host_millis;
+
+    while (replies < expected && host_millis - start < 1000) {
+        usb_frame();
+
+        // 主机在一帧内发送数据包，直到端点回复 NAK
+        for (uint8_t n = 0; n < 19 && sent < len; n++) {
+            uint8_t size = len - sent > MAX_PACKET_SIZE ? MAX_PACKET_SIZE
+                                                        : len - sent;
+
+            if (!usb_cdc_out((uint8_t *)text + sent, size)) {
+                break;
+            }
+            sent += size;
+        }
+
+        loop();
+        usb_cdc_in_frame(19);
+        for (; scanned + 1 < sim_cdc_rx_len; scanned++) {
+            replies += sim_cdc_rx[scanned] == '\r' &&
+                       sim_cdc_rx[scanned + 1] == '\n';
+        }
+    }
+
+    printf("%-12s %5u us %8u %7lu\n",
+           command_us < COMMAND_TIME_BUDGET ? "budget" : "one per loop",
+           command_us, expected, (unsigned long)(host_millis - start));
+}
+
+int main() {
+    sketch_reset();
+    make_session();
+
+    printf("%u commands, %u bytes per session\n\n", session_commands,
+           session_len);
+    printf("         scanned bytes        host time\n");
+    printf("parser   /byte /command    /byte   /command\n");
+    bench("legacy", legacy_parse);
+    bench("table", table_parse);
+
+    for (uint8_t i = 0; i < PARAM_COUNT; i++) {
+        param_lengths[i] = strlen(param_table[i].name);
+    }
+    printf("\n%u parameters\n", (unsigned)PARAM_COUNT);
+    printf("lookup   scanned   host time\n");
+    lookup("legacy", legacy_find_param);
+    lookup("table", find_param);
+    printf("\ndispatch host time\n");
+    dispatch_params();
+
+    printf("\n%u slider changes\n%-15s %7s %8s %13s\n", SLIDER_CHANGES,
+           "command", "EEPROM", "LED init", "apply time");
+    tune(true);
+    tune(false);
+
+    printf("\n%-12s %8s %8s %7s\n", "mode", "cost", "replies",
+           "frames");
+    burst(200);
+    burst(COMMAND_TIME_BUDGET);
+    return 0;
+}
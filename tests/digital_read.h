@@ -0,0 +1,65 @@
+/*
+  CH55xduino digitalRead 模型
+
+  按 CH55xduino 核心的 digitalRead 实现（pins_arduino.c 中按引脚号索引的
+  端口与位掩码表，查表后按端口分支读取寄存器），用于基准测试比较改为
+  端口快照之前按引脚读取的开销
+*/
+#ifndef __DIGITAL_READ_H__
+#define __DIGITAL_READ_H__
+
+#define NOT_A_PORT 0
+#define P1PORT 1
+#define P3PORT 3
+#define LOW 0
+#define HIGH 1
+
+static const uint8_t digital_pin_to_port[] = {
+    NOT_A_PORT, NOT_A_PORT, NOT_A_PORT, NOT_A_PORT, // 0-3
+    NOT_A_PORT, NOT_A_PORT, NOT_A_PORT, NOT_A_PORT, // 4-7
+    NOT_A_PORT, NOT_A_PORT, P1PORT,     P1PORT,     // 8-11
+    P1PORT,     P1PORT,     P1PORT,     P1PORT,     // 12-15
+    P1PORT,     P1PORT,     NOT_A_PORT, NOT_A_PORT, // 16-19
+    NOT_A_PORT, NOT_A_PORT, NOT_A_PORT, NOT_A_PORT, // 20-23
+    NOT_A_PORT, NOT_A_PORT, NOT_A_PORT, NOT_A_PORT, // 24-27
+    NOT_A_PORT, NOT_A_PORT, P3PORT,     P3PORT,     // 28-31
+    P3PORT,     P3PORT,     P3PORT,     P3PORT,     // 32-35
+    P3PORT,     P3PORT,                             // 36-37
+};
+
+static const uint8_t digital_pin_to_bit_mask[] = {
+    0,    0,    0,    0,    0,    0,    0,    0,    // 0-7
+    0,    0,    0x01, 0x02, 0x04, 0x08, 0x10, 0x20, // 8-15
+    0x40, 0x80, 0,    0,    0,    0,    0,    0,    // 16-23
+    0,    0,    0,    0,    0,    0,    0x01, 0x02, // 24-31
+    0x04, 0x08, 0x10, 0x20, 0x40, 0x80,             // 32-37
+};
+
+/**
+ * @brief CH55xduino 核心库的 digitalRead，位于另一个编译单元，不会内联
+ */
+__attribute__((noinline)) static uint8_t core_digitalRead(uint8_t pin) {
+    uint8_t bit = digital_pin_to_bit_mask[pin];
+    uint8_t port = digital_pin_to_port[pin];
+
+    if (port == NOT_A_PORT) {
+        return LOW;
+    }
+
+    switch (port) {
+    case P1PORT:
+        if (P1 & bit) {
+            return HIGH;
+        }
+        break;
+    case P3PORT:
+        if (P3 & bit) {
+            return HIGH;
+        }
+        break;
+    }
+
+    return LOW;
+}
+
+#endif
@@ -0,0 +1,89 @@
+/*
+  EC11 编码器引脚模拟
+
+  在包含 EC11.c 之后包含，按 Common.h 中的引脚定义改写 P1/P3 端口寄存器，
+  模拟编码器的 A/B 相与按键电平
+*/
+#ifndef __EC11_SIM_H__
+#define __EC11_SIM_H__
+
+// 测试程序可将端口寄存器替换为计数读取次数的宏，此时经由这两个名字改写电平
+#ifndef SIM_P1
+#define SIM_P1 P1
+#define SIM_P3 P3
+#endif
+
+// 格雷码顺时针与逆时针一齿的状态序列（A << 1 | B），静止状态为 3
+static const uint8_t CW_DETENT[4] = {1, 0, 2, 3};
+static const uint8_t CCW_DETENT[4] = {2, 0, 1, 3};
+
+static uint8_t *sim_port(uint8_t i) {
+    return EC11_MAP_PORT(i) == EC11_PORT_P1 ? &SIM_P1 : &SIM_P3;
+}
+
+/**
+ * @brief 设置第 i 个编码器的 A/B 相电平
+ * @param state A/B 相组合状态（bit1:A, bit0:B）
+ */
+static void sim_set_ab(uint8_t i, uint8_t state) {
+    uint8_t *port = sim_port(i);
+
+    *port &= ~(EC11_MAP_MASK_A(i) | EC11_MAP_MASK_B(i));
+    if (state & 0x02) {
+        *port |= EC11_MAP_MASK_A(i);
+    }
+    if (state & 0x01) {
+        *port |= EC11_MAP_MASK_B(i);
+    }
+}
+
+/**
+ * @brief 设置第 i 个编码器的按键电平，按下为低电平
+ */
+static void sim_set_key(uint8_t i, bool pressed) {
+    uint8_t *port = sim_port(i);
+
+    if (pressed) {
+        *port &= ~EC11_MAP_MASK_K(i);
+    } else {
+        *port |= EC11_MAP_MASK_K(i);
+    }
+}
+
+/**
+ * @brief 释放全部引脚并重新初始化驱动
+ */
+static void sim_reset() {
+    SIM_P1 = 0xFF;
+    SIM_P3 = 0xFF;
+    host_millis = 0;
+    EC11_Init();
+    EC11_SetStepPerTeeth(STEP_PER_TEETH_DEFAULT);
+    EC11_SetPhase(EC11_PHASE_A_LEADS);
+}
+
+/**
+ * @brief 取出缓冲区中的全部旋转事件并按方向计数
+ * @param index 只统计该编码器的事件
+ */
+static void sim_drain(uint8_t index, uint8_t *cw, uint8_t *ccw) {
+    uint8_t event_index;
+    ec11_direction_t direction;
+
+    *cw = 0;
+    *ccw = 0;
+
+    while ((direction = EC11_GetDirection(&event_index)) != EC11_DIR_NONE) {
+        if (event_index != index) {
+            continue;
+        }
+
+        if (direction == EC11_DIR_CW) {
+            (*cw)++;
+        } else {
+            (*ccw)++;
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,33 @@
+/*
+  帧协议测试用 CDC 发送桩
+
+  Frame_Send 写入的字节追加到 sink 缓冲区，sink_space 模拟 CDC 发送缓冲区
+  的剩余空间
+*/
+#ifndef __FRAME_SINK_H__
+#define __FRAME_SINK_H__
+
+#include <stdint.h>
+#include <string.h>
+
+static uint8_t sink[4096];
+static uint16_t sink_len;
+static uint8_t sink_space = 255;
+
+static void sink_reset() {
+    sink_len = 0;
+    sink_space = 255;
+}
+
+uint8_t USBSerial_print_n(uint8_t *buf, int len) {
+    memcpy(sink + sink_len, buf, len);
+    sink_len += len;
+    sink_space -= len;
+    return len;
+}
+
+uint8_t USBSerial_availableForWrite() { return sink_space; }
+
+bool USBSerial_commit() { return true; }
+
+#endif
@@ -0,0 +1,191 @@
+/*
+  固件主程序模拟
+
+  在 USB 设备模拟的基础上编译 Radial-Controller.ino 及其余驱动源文件，
+  以 C11 _Generic 代替 CH55xduino 核心的 USBSerial_print/println 宏，
+  并记录 LED 驱动的初始化次数。micros() 每次调用前进 sim_micros_step
+  微秒，用于模拟命令执行耗时。定义 SIM_COUNT_STRING_OPS 时统计主程序中
+  字符串函数扫描的字节数
+*/
+#ifndef __SKETCH_SIM_H__
+#define __SKETCH_SIM_H__
+
+#include "usb_sim.h"
+
+#include <stdio.h>
+
+#define OUTPUT 1
+
+static uint16_t sim_led_inits;    // WS2812_Init 的调用次数
+static uint16_t sim_micros_step; // 每次调用 micros() 前进的微秒数
+
+void delayMicroseconds(uint16_t us) { host_micros += us; }
+
+void set_pixel_for_GRB_LED(uint8_t *buf, uint8_t index, uint8_t r, uint8_t g,
+                           uint8_t b) {
+    buf[index * 3] = g;
+    buf[index * 3 + 1] = r;
+    buf[index * 3 + 2] = b;
+}
+
+void set_pixel_for_RGB_LED(uint8_t *buf, uint8_t index, uint8_t r, uint8_t g,
+                           uint8_t b) {
+    buf[index * 3] = r;
+    buf[index * 3 + 1] = g;
+    buf[index * 3 + 2] = b;
+}
+
+void neopixel_show_P1_5(uint8_t *data, uint8_t len) {}
+
+// WS2812_Init 设置 LED 引脚为输出，以此统计初始化次数
+#define pinMode(pin, mode)                                                     \
+    (sim_led_inits += (pin) == WS2812_PIN, pinMode(pin, mode))
+#include "../src/Drivers/MyWS2812.c"
+#undef pinMode
+
+#include "../src/Drivers/EC11.c"
+#include "../src/CdcRadial/USBFrame.c"
+
+/**
+ * @brief 输出以 '\0' 结尾的字符串
+ */
+static void sim_print_s(const char *s) {
+    USBSerial_print_n((uint8_t *)s, strlen(s));
+}
+
+/**
+ * @brief 以十进制输出整数
+ */
+static void sim_print_i(long value) {
+    char buf[12];
+
+    sim_print_s(snprintf(buf, sizeof(buf), "%ld", value) > 0 ? buf : "");
+}
+
+#define USBSerial_print(x)                                                     \
+    _Generic((x), char *: sim_print_s, const char *: sim_print_s,              \
+             default: sim_print_i)(x)
+
+// 同 CH55xduino，println 以 "\r\n" 结束并提交消息
+#define SIM_PRINTLN_0() (USBSerial_write('\r'), USBSerial_write('\n'))
+#define SIM_PRINTLN_1(x) (USBSerial_print(x), SIM_PRINTLN_0())
+#define SIM_PRINTLN_SELECT(_0, _1, name, ...) name
+#define USBSerial_println(...)                                                 \
+    SIM_PRINTLN_SELECT(_0, ##__VA_ARGS__, SIM_PRINTLN_1,                       \
+                       SIM_PRINTLN_0)(__VA_ARGS__)
+
+#define micros() (host_micros += sim_micros_step)
+
+#ifdef SIM_COUNT_STRING_OPS
+// 字符串函数扫描的字节数。SDCC 不会把 strlen 常量折叠，也没有针对 __code
+// 字符串优化的库函数，以此近似比较字符串处理在 8051 上的开销
+static uint32_t sim_string_ops;
+
+static size_t sim_strlen(const char *s) {
+    size_t n = strlen(s);
+
+    sim_string_ops += n + 1;
+    return n;
+}
+
+static int sim_memcmp(const void *a, const void *b, size_t n) {
+    const uint8_t *x = a;
+    const uint8_t *y = b;
+
+    for (size_t i = 0; i < n; i++) {
+        sim_string_ops++;
+        if (x[i] != y[i]) {
+            return x[i] - y[i];
+        }
+    }
+    return 0;
+}
+
+static int sim_strcmp(const char *a, const char *b) {
+    for (size_t i = 0;; i++) {
+        sim_string_ops++;
+        if (a[i] != b[i] || a[i] == '\0') {
+            return (uint8_t)a[i] - (uint8_t)b[i];
+        }
+    }
+}
+
+#define strlen sim_strlen
+#define memcmp sim_memcmp
+#define strcmp sim_strcmp
+#endif
+
+#include "../Radial-Controller.ino"
+
+#undef micros
+
+/**
+ * @brief 上电复位设备、主机模型与主程序状态，运行 setup()
+ * @details EEPROM 内容为空，按默认配置启动
+ */
+static void sketch_reset() {
+    memset(host_eeprom, 0xFF, sizeof(host_eeprom));
+    sim_led_inits = 0;
+    sim_micros_step = 0;
+
+    receive_ptr = 0;
+    receive_state = RECEIVE_STATE_NAME;
+    receive_overflow = false;
+    is_config_mode = false;
+    config_by_dtr = false;
+    heartbeat_last_received = 0;
+    is_preview_mode = false;
+    settings_dirty = false;
+    test_release_pending = false;
+    input_last_time = 0;
+
+    setup();
+    usb_sim_reset();
+}
+
+/**
+ * @brief 主机经端点1 发送数据，端点回复 NAK 时运行主循环，发送完后再运行一次
+ */
+static void sketch_send_data(const uint8_t *data, uint16_t len) {
+    while (len > 0) {
+        uint8_t size = len > MAX_PACKET_SIZE ? MAX_PACKET_SIZE : len;
+
+        if (!usb_cdc_out(data, size)) {
+            loop();
+            continue;
+        }
+        data += size;
+        len -= size;
+    }
+    loop();
+}
+
+static void sketch_send(const char *text) {
+    sketch_send_data((const uint8_t *)text, strlen(text));
+}
+
+/**
+ * @brief 运行 ms 帧，每帧运行一次主循环
+ */
+static void sketch_run(uint16_t ms) {
+    while (ms-- > 0) {
+        usb_frame();
+        loop();
+    }
+}
+
+/**
+ * @brief 主机读取主程序的全部应答，以 '\0' 结尾存入 sim_cdc_rx
+ * @return 应答长度
+ */
+static uint16_t sketch_replies() {
+    sim_cdc_rx_len = 0;
+    while (usb_cdc_in_frame(19) > 0) {
+    }
+    sim_cdc_rx[sim_cdc_rx_len < sizeof(sim_cdc_rx) ? sim_cdc_rx_len
+                                                   : sizeof(sim_cdc_rx) - 1] =
+        '\0';
+    return sim_cdc_rx_len;
+}
+
+#endif
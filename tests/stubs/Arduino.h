@@ -0,0 +1,38 @@
+/*
+  主机测试用 Arduino 桩头文件
+
+  将 CH55xduino 的引脚、时钟、EEPROM 接口替换为主机可编译的定义，
+  使固件源文件无需修改即可在主机上编译测试
+*/
+#ifndef __HOST_ARDUINO_H__
+#define __HOST_ARDUINO_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "include/ch5xx.h"
+
+#define F_CPU 24000000UL
+
+#define INPUT_PULLUP 2
+#define FALLING 2
+
+// 主机时钟，由测试程序推进；millis_calls 统计 millis() 的调用次数
+extern uint32_t host_millis;
+extern uint32_t host_micros;
+extern uint32_t millis_calls;
+
+uint32_t millis();
+uint32_t micros();
+void pinMode(uint8_t pin, uint8_t mode);
+void attachInterrupt(uint8_t interrupt, void (*handler)(), uint8_t mode);
+
+// 模拟 DataFlash，eeprom_write_count 统计实际写入次数
+extern uint8_t host_eeprom[128];
+extern uint16_t eeprom_write_count;
+
+uint8_t eeprom_read_byte(uint8_t addr);
+void eeprom_write_byte(uint8_t addr, uint8_t value);
+
+#endif
@@ -0,0 +1,16 @@
+/*
+  主机测试用 WS2812 桩头文件
+
+  仅提供 MyWS2812.h 引用的 CH55xduino 灯带接口声明
+*/
+#ifndef __HOST_WS2812_H__
+#define __HOST_WS2812_H__
+
+#include <stdint.h>
+
+void set_pixel_for_GRB_LED(uint8_t *buf, uint8_t index, uint8_t r, uint8_t g,
+                           uint8_t b);
+void set_pixel_for_RGB_LED(uint8_t *buf, uint8_t index, uint8_t r, uint8_t g,
+                           uint8_t b);
+
+#endif
@@ -0,0 +1,58 @@
+/*
+  主机测试用 CH55xduino 运行环境桩实现
+*/
+#include <Arduino.h>
+
+uint8_t P1 = 0xFF, P3 = 0xFF;
+uint8_t EA, EX0, EX1, ET2, IE_USB;
+uint8_t PCON, TMOD, SAFE_MOD, WAKE_CTRL, XBUS_AUX;
+uint8_t GPIO_IE, IE_GPIO;
+
+uint8_t TR2, TF2, C_T2, CP_RL2, T2MOD;
+uint8_t RCAP2L, RCAP2H, TL2, TH2;
+
+uint8_t USB_CTRL, UDEV_CTRL, USB_DEV_AD, USB_INT_EN, USB_INT_FG;
+uint8_t USB_INT_ST, USB_MIS_ST, USB_RX_LEN;
+uint8_t U_TOG_OK, UIF_BUS_RST, UIF_SUSPEND, UIF_TRANSFER;
+
+uint8_t UEP0_CTRL, UEP1_CTRL, UEP2_CTRL, UEP3_CTRL, UEP4_CTRL;
+uint8_t UEP0_T_LEN, UEP1_T_LEN, UEP2_T_LEN, UEP3_T_LEN;
+uint8_t UEP2_3_MOD, UEP4_1_MOD;
+uint16_t UEP0_DMA, UEP1_DMA, UEP2_DMA, UEP3_DMA;
+uint8_t UEP0_DMA_H, UEP0_DMA_L, UEP1_DMA_H, UEP1_DMA_L;
+uint8_t UEP2_DMA_H, UEP2_DMA_L;
+uint8_t UEP3_RX_LEN_HOST;
+
+uint32_t host_millis = 0;
+uint32_t host_micros = 0;
+uint32_t millis_calls = 0;
+
+uint8_t host_eeprom[128];
+uint16_t eeprom_write_count = 0;
+
+uint32_t millis() {
+    millis_calls++;
+    return host_millis;
+}
+
+uint32_t micros() { return host_micros; }
+
+void pinMode(uint8_t pin, uint8_t mode) {
+    (void)pin;
+    (void)mode;
+}
+
+void attachInterrupt(uint8_t interrupt, void (*handler)(), uint8_t mode) {
+    (void)interrupt;
+    (void)handler;
+    (void)mode;
+}
+
+uint8_t eeprom_read_byte(uint8_t addr) {
+    return host_eeprom[addr % sizeof(host_eeprom)];
+}
+
+void eeprom_write_byte(uint8_t addr, uint8_t value) {
+    host_eeprom[addr % sizeof(host_eeprom)] = value;
+    eeprom_write_count++;
+}
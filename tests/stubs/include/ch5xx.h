@@ -0,0 +1,100 @@
+/*
+  主机测试用 CH5xx 寄存器桩头文件
+
+  SDCC 存储类关键字定义为空（__code 定义为 const），特殊功能寄存器与
+  位寻址标志替换为普通变量，由 host.c 定义，测试程序直接读写这些变量
+  模拟硬件状态；位定义取自 CH552 数据手册
+*/
+#ifndef __HOST_CH5XX_H__
+#define __HOST_CH5XX_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define __xdata
+#define __idata
+#define __data
+#define __code const
+#define __bit bool
+#define __at(addr)
+
+#define CH552
+
+// 端口与中断
+extern uint8_t P1, P3;
+extern uint8_t EA, EX0, EX1, ET2, IE_USB;
+extern uint8_t PCON, TMOD, SAFE_MOD, WAKE_CTRL, XBUS_AUX;
+
+// GPIO 中断
+extern uint8_t GPIO_IE, IE_GPIO;
+#define bIE_IO_EDGE 0x80
+#define bIE_P3_1_LO 0x02
+
+// 定时器 2
+extern uint8_t TR2, TF2, C_T2, CP_RL2, T2MOD;
+extern uint8_t RCAP2L, RCAP2H, TL2, TH2;
+#define bTMR_CLK 0x80
+#define bT2_CLK 0x40
+
+// USB 控制与中断
+extern uint8_t USB_CTRL, UDEV_CTRL, USB_DEV_AD, USB_INT_EN, USB_INT_FG;
+extern uint8_t USB_INT_ST, USB_MIS_ST, USB_RX_LEN;
+extern uint8_t U_TOG_OK, UIF_BUS_RST, UIF_SUSPEND, UIF_TRANSFER;
+
+#define bUC_HOST_MODE 0x80
+#define bUC_LOW_SPEED 0x40
+#define bUC_DEV_PU_EN 0x20
+#define bUC_INT_BUSY 0x08
+#define bUC_DMA_EN 0x01
+#define bUD_PD_DIS 0x80
+#define bUD_DP_PD_DIS 0x80
+#define bUD_LOW_SPEED 0x04
+#define bUD_PORT_EN 0x01
+#define bUDA_GP_BIT 0x80
+#define bUMS_SUSPEND 0x04
+#define bUIE_DEV_SOF 0x80
+#define bUIE_SUSPEND 0x04
+#define bUIE_TRANSFER 0x02
+#define bUIE_BUS_RST 0x01
+
+#define MASK_UIS_TOKEN 0x30
+#define MASK_UIS_ENDP 0x0F
+#define UIS_TOKEN_OUT 0x00
+#define UIS_TOKEN_SOF 0x10
+#define UIS_TOKEN_IN 0x20
+#define UIS_TOKEN_SETUP 0x30
+
+// USB 端点
+extern uint8_t UEP0_CTRL, UEP1_CTRL, UEP2_CTRL, UEP3_CTRL, UEP4_CTRL;
+extern uint8_t UEP0_T_LEN, UEP1_T_LEN, UEP2_T_LEN, UEP3_T_LEN;
+extern uint8_t UEP2_3_MOD, UEP4_1_MOD;
+extern uint16_t UEP0_DMA, UEP1_DMA, UEP2_DMA, UEP3_DMA;
+extern uint8_t UEP0_DMA_H, UEP0_DMA_L, UEP1_DMA_H, UEP1_DMA_L;
+extern uint8_t UEP2_DMA_H, UEP2_DMA_L;
+
+// USBRadial.h 按 XDATA 地址访问端点3 接收长度，主机以变量代替
+extern uint8_t UEP3_RX_LEN_HOST;
+#define UEP3_RX_LEN UEP3_RX_LEN_HOST
+
+#define bUEP_R_TOG 0x80
+#define bUEP_T_TOG 0x40
+#define bUEP_AUTO_TOG 0x10
+#define MASK_UEP_R_RES 0x0C
+#define UEP_R_RES_ACK 0x00
+#define UEP_R_RES_TOUT 0x04
+#define UEP_R_RES_NAK 0x08
+#define UEP_R_RES_STALL 0x0C
+#define MASK_UEP_T_RES 0x03
+#define UEP_T_RES_ACK 0x00
+#define UEP_T_RES_TOUT 0x01
+#define UEP_T_RES_NAK 0x02
+#define UEP_T_RES_STALL 0x03
+
+#define bUEP1_RX_EN 0x80
+#define bUEP1_TX_EN 0x40
+#define bUEP3_TX_EN 0x40
+#define bUEP2_RX_EN 0x08
+#define bUEP2_TX_EN 0x04
+#define bUEP2_BUF_MOD 0x01
+
+#endif
@@ -0,0 +1,54 @@
+/*
+  主机测试用 CH5xx USB 定义桩头文件
+*/
+#ifndef __HOST_CH5XX_USB_H__
+#define __HOST_CH5XX_USB_H__
+
+#include <stdint.h>
+
+#define DEFAULT_ENDP0_SIZE 8
+#define MAX_PACKET_SIZE 64
+
+// 标准请求
+#define USB_GET_STATUS 0x00
+#define USB_CLEAR_FEATURE 0x01
+#define USB_SET_FEATURE 0x03
+#define USB_SET_ADDRESS 0x05
+#define USB_GET_DESCRIPTOR 0x06
+#define USB_GET_CONFIGURATION 0x08
+#define USB_SET_CONFIGURATION 0x09
+#define USB_GET_INTERFACE 0x0A
+#define USB_SET_INTERFACE 0x0B
+
+// HID 类请求
+#define HID_GET_REPORT 0x01
+#define HID_GET_IDLE 0x02
+#define HID_GET_PROTOCOL 0x03
+#define HID_SET_REPORT 0x09
+#define HID_SET_IDLE 0x0A
+#define HID_SET_PROTOCOL 0x0B
+
+// bmRequestType
+#define USB_REQ_TYP_IN 0x80
+#define USB_REQ_TYP_OUT 0x00
+#define USB_REQ_TYP_MASK 0x60
+#define USB_REQ_TYP_STANDARD 0x00
+#define USB_REQ_TYP_CLASS 0x20
+#define USB_REQ_TYP_VENDOR 0x40
+#define USB_REQ_RECIP_MASK 0x1F
+#define USB_REQ_RECIP_DEVICE 0x00
+#define USB_REQ_RECIP_INTERF 0x01
+#define USB_REQ_RECIP_ENDP 0x02
+
+typedef struct _USB_SETUP_REQ {
+    uint8_t bRequestType;
+    uint8_t bRequest;
+    uint8_t wValueL;
+    uint8_t wValueH;
+    uint8_t wIndexL;
+    uint8_t wIndexH;
+    uint8_t wLengthL;
+    uint8_t wLengthH;
+} USB_SETUP_REQ, *PUSB_SETUP_REQ;
+
+#endif
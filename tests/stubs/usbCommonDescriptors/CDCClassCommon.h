@@ -0,0 +1,40 @@
+/*
+  主机测试用 CDC 类描述符桩头文件
+*/
+#ifndef __HOST_CDC_CLASS_COMMON_H__
+#define __HOST_CDC_CLASS_COMMON_H__
+
+#include "StdDescriptors.h"
+
+#define CDC_CSCP_CDCClass 0x02
+#define CDC_CSCP_ACMSubclass 0x02
+#define CDC_CSCP_ATCommandProtocol 0x01
+#define CDC_CSCP_CDCDataClass 0x0A
+#define CDC_CSCP_NoDataSubclass 0x00
+#define CDC_CSCP_NoDataProtocol 0x00
+
+#define CDC_DTYPE_CSInterface 0x24
+#define CDC_DSUBTYPE_CSInterface_Header 0x00
+#define CDC_DSUBTYPE_CSInterface_ACM 0x02
+#define CDC_DSUBTYPE_CSInterface_Union 0x06
+
+typedef struct {
+    USB_Descriptor_Header_t Header;
+    uint8_t Subtype;
+    uint16_t CDCSpecification;
+} ATTR_PACKED USB_CDC_Descriptor_FunctionalHeader_t;
+
+typedef struct {
+    USB_Descriptor_Header_t Header;
+    uint8_t Subtype;
+    uint8_t Capabilities;
+} ATTR_PACKED USB_CDC_Descriptor_FunctionalACM_t;
+
+typedef struct {
+    USB_Descriptor_Header_t Header;
+    uint8_t Subtype;
+    uint8_t MasterInterfaceNumber;
+    uint8_t SlaveInterfaceNumber;
+} ATTR_PACKED USB_CDC_Descriptor_FunctionalUnion_t;
+
+#endif
@@ -0,0 +1,27 @@
+/*
+  主机测试用 HID 类描述符桩头文件
+*/
+#ifndef __HOST_HID_CLASS_COMMON_H__
+#define __HOST_HID_CLASS_COMMON_H__
+
+#include "StdDescriptors.h"
+
+#define HID_CSCP_HIDClass 0x03
+#define HID_CSCP_NonBootSubclass 0x00
+#define HID_CSCP_BootSubclass 0x01
+#define HID_CSCP_NonBootProtocol 0x00
+#define HID_CSCP_KeyboardBootProtocol 0x01
+
+#define HID_DTYPE_HID 0x21
+#define HID_DTYPE_Report 0x22
+
+typedef struct {
+    USB_Descriptor_Header_t Header;
+    uint16_t HIDSpec;
+    uint8_t CountryCode;
+    uint8_t TotalReportDescriptors;
+    uint8_t HIDReportType;
+    uint16_t HIDReportLength;
+} ATTR_PACKED USB_HID_Descriptor_HID_t;
+
+#endif
@@ -0,0 +1,97 @@
+/*
+  主机测试用 USB 标准描述符桩头文件
+
+  结构体布局与 CH55xduino 的 LUFA 描述符定义相同，按字节紧凑排列
+*/
+#ifndef __HOST_STD_DESCRIPTORS_H__
+#define __HOST_STD_DESCRIPTORS_H__
+
+#include <stdint.h>
+
+#define ATTR_PACKED __attribute__((packed))
+
+#define NO_DESCRIPTOR 0
+#define VERSION_BCD(major, minor, revision)                                    \
+    (((major & 0xFF) << 8) | ((minor & 0x0F) << 4) | (revision & 0x0F))
+#define USB_CONFIG_POWER_MA(mA) ((mA) >> 1)
+#define USB_CONFIG_ATTR_RESERVED 0x80
+#define USB_CONFIG_ATTR_SELFPOWERED 0x40
+#define USB_CONFIG_ATTR_REMOTEWAKEUP 0x20
+
+#define EP_TYPE_CONTROL 0x00
+#define EP_TYPE_ISOCHRONOUS 0x01
+#define EP_TYPE_BULK 0x02
+#define EP_TYPE_INTERRUPT 0x03
+#define ENDPOINT_ATTR_NO_SYNC (0 << 2)
+#define ENDPOINT_USAGE_DATA (0 << 4)
+
+enum USB_DescriptorTypes_t {
+    DTYPE_Device = 0x01,
+    DTYPE_Configuration = 0x02,
+    DTYPE_String = 0x03,
+    DTYPE_Interface = 0x04,
+    DTYPE_Endpoint = 0x05,
+    DTYPE_InterfaceAssociation = 0x0B,
+};
+
+typedef struct {
+    uint8_t Size;
+    uint8_t Type;
+} ATTR_PACKED USB_Descriptor_Header_t;
+
+typedef struct {
+    USB_Descriptor_Header_t Header;
+    uint16_t USBSpecification;
+    uint8_t Class;
+    uint8_t SubClass;
+    uint8_t Protocol;
+    uint8_t Endpoint0Size;
+    uint16_t VendorID;
+    uint16_t ProductID;
+    uint16_t ReleaseNumber;
+    uint8_t ManufacturerStrIndex;
+    uint8_t ProductStrIndex;
+    uint8_t SerialNumStrIndex;
+    uint8_t NumberOfConfigurations;
+} ATTR_PACKED USB_Descriptor_Device_t;
+
+typedef struct {
+    USB_Descriptor_Header_t Header;
+    uint16_t TotalConfigurationSize;
+    uint8_t TotalInterfaces;
+    uint8_t ConfigurationNumber;
+    uint8_t ConfigurationStrIndex;
+    uint8_t ConfigAttributes;
+    uint8_t MaxPowerConsumption;
+} ATTR_PACKED USB_Descriptor_Configuration_Header_t;
+
+typedef struct {
+    USB_Descriptor_Header_t Header;
+    uint8_t InterfaceNumber;
+    uint8_t AlternateSetting;
+    uint8_t TotalEndpoints;
+    uint8_t Class;
+    uint8_t SubClass;
+    uint8_t Protocol;
+    uint8_t InterfaceStrIndex;
+} ATTR_PACKED USB_Descriptor_Interface_t;
+
+typedef struct {
+    USB_Descriptor_Header_t Header;
+    uint8_t FirstInterfaceIndex;
+    uint8_t TotalInterfaces;
+    uint8_t Class;
+    uint8_t SubClass;
+    uint8_t Protocol;
+    uint8_t IADStrIndex;
+} ATTR_PACKED USB_Descriptor_Interface_Association_t;
+
+typedef struct {
+    USB_Descriptor_Header_t Header;
+    uint8_t EndpointAddress;
+    uint8_t Attributes;
+    uint16_t EndpointSize;
+    uint8_t PollingIntervalMS;
+} ATTR_PACKED USB_Descriptor_Endpoint_t;
+
+#endif
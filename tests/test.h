@@ -0,0 +1,48 @@
+/*
+  主机测试断言宏
+
+  断言失败时打印文件、行号与实际值，不中止后续用例，
+  由 TEST_RESULT() 汇总返回进程退出码
+*/
+#ifndef __TEST_H__
+#define __TEST_H__
+
+#include <stdio.h>
+
+static int test_failures = 0;
+static int test_checks = 0;
+
+#define CHECK(cond)                                                            \
+    do {                                                                       \
+        test_checks++;                                                         \
+        if (!(cond)) {                                                         \
+            test_failures++;                                                   \
+            printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond);    \
+        }                                                                      \
+    } while (0)
+
+#define CHECK_EQ(actual, expected)                                             \
+    do {                                                                       \
+        long test_a = (long)(actual);                                          \
+        long test_e = (long)(expected);                                        \
+        test_checks++;                                                         \
+        if (test_a != test_e) {                                                \
+            test_failures++;                                                   \
+            printf("%s:%d: %s == %ld, expected %ld\n", __FILE__, __LINE__,     \
+                   #actual, test_a, test_e);                                   \
+        }                                                                      \
+    } while (0)
+
+#define RUN(test)                                                              \
+    do {                                                                       \
+        int test_before = test_failures;                                       \
+        test();                                                                \
+        printf("%s %s\n", test_failures == test_before ? "ok  " : "FAIL",      \
+               #test);                                                         \
+    } while (0)
+
+#define TEST_RESULT()                                                          \
+    (printf("%d checks, %d failed\n", test_checks, test_failures),             \
+     test_failures != 0)
+
+#endif
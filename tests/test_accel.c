@@ -0,0 +1,124 @@
+/*
+  旋转加速度曲线主机测试
+
+  直接包含驱动源文件，通过设置编码器的事件间隔检查 EC11_ApplyAccel
+  在曲线节点、节点之间与两端的倍率，以及 EEPROM 对曲线增益的校验
+*/
+#include "../src/Drivers/EC11.c"
+#include "../src/Drivers/EEPROM.c"
+#include "test.h"
+
+// 用于测试的曲线：各节点附加增益（单位 1/4 倍）
+static const uint8_t CURVE[ACCEL_CURVE_POINTS] = {8, 16, 32, ACCEL_GAIN_MAX};
+
+static int16_t accel_at(uint16_t interval, int16_t degrees) {
+    encoders[0].event_interval = interval;
+    return EC11_ApplyAccel(0, degrees);
+}
+
+static void setup_curve() {
+    EC11_Init();
+    EC11_SetAccelCurve(CURVE);
+}
+
+static void test_idle_interval_is_unchanged() {
+    setup_curve();
+
+    CHECK_EQ(accel_at(0xFFFF, 10), 10);
+    CHECK_EQ(accel_at(ACCEL_IDLE_INTERVAL, 10), 10);
+    CHECK_EQ(accel_at(ACCEL_IDLE_INTERVAL + 1, -10), -10);
+
+    // 刚快于起始间隔时插值增益不足 1，倍率仍为 1
+    CHECK_EQ(accel_at(ACCEL_IDLE_INTERVAL - 1, 10), 10);
+}
+
+static void test_knee_points() {
+    setup_curve();
+
+    // 倍率 (4 + gain) / 4
+    for (uint8_t i = 0; i < ACCEL_CURVE_POINTS; i++) {
+        CHECK_EQ(accel_at(ACCEL_INTERVALS[i], 40), 40 * (4 + CURVE[i]) / 4);
+    }
+}
+
+static void test_interpolation() {
+    setup_curve();
+
+    // 200 ms（增益 0）与 100 ms（增益 8）的中点，增益 4
+    CHECK_EQ(accel_at(150, 40), 40 * (4 + 4) / 4);
+
+    // 50 ms（增益 16）与 25 ms（增益 32）之间 40 ms，增益 16 + 16 * 10 / 25
+    CHECK_EQ(accel_at(40, 40), 40 * (4 + 16 + 16 * 10 / 25) / 4);
+
+    // 间隔越短倍率越大，整段曲线单调不减
+    int16_t previous = accel_at(ACCEL_IDLE_INTERVAL, 15);
+    for (int16_t interval = ACCEL_IDLE_INTERVAL - 1; interval >= 0;
+         interval--) {
+        int16_t degrees = accel_at((uint16_t)interval, 15);
+        CHECK(degrees >= previous);
+        previous = degrees;
+    }
+}
+
+static void test_clamp_below_last_knee() {
+    setup_curve();
+
+    int16_t fastest = 40 * (4 + ACCEL_GAIN_MAX) / 4;
+
+    CHECK_EQ(accel_at(ACCEL_INTERVALS[ACCEL_CURVE_POINTS - 1] - 1, 40),
+             fastest);
+    CHECK_EQ(accel_at(1, 40), fastest);
+    CHECK_EQ(accel_at(0, 40), fastest);
+    CHECK_EQ(accel_at(0, -40), -fastest);
+}
+
+static void test_max_gain_fits_int16() {
+    static const uint8_t max_curve[ACCEL_CURVE_POINTS] = {
+        ACCEL_GAIN_MAX, ACCEL_GAIN_MAX, ACCEL_GAIN_MAX, ACCEL_GAIN_MAX};
+
+    EC11_Init();
+    EC11_SetAccelCurve(max_curve);
+
+    // SDCC 的 int 为 16 位，最大角度乘以最大倍率不得溢出
+    CHECK(ROTATE_ANGLE_MAX * (4 + ACCEL_GAIN_MAX) <= INT16_MAX);
+    CHECK(-ROTATE_ANGLE_MAX * (4 + ACCEL_GAIN_MAX) >= INT16_MIN);
+
+    CHECK_EQ(accel_at(0, ROTATE_ANGLE_MAX),
+             ROTATE_ANGLE_MAX * (4 + ACCEL_GAIN_MAX) / 4);
+    CHECK_EQ(accel_at(0, -ROTATE_ANGLE_MAX),
+             -ROTATE_ANGLE_MAX * (4 + ACCEL_GAIN_MAX) / 4);
+
+    // 200 ms（增益 0）与 100 ms（增益 60）的中点，增益 30
+    CHECK_EQ(accel_at(150, ROTATE_ANGLE_MAX),
+             ROTATE_ANGLE_MAX * (4 + ACCEL_GAIN_MAX / 2) / 4);
+}
+
+static void test_eeprom_rejects_invalid_curve() {
+    static const uint8_t too_steep[ACCEL_CURVE_POINTS] = {0, 0, 0,
+                                                          ACCEL_GAIN_MAX + 1};
+    static const uint8_t decreasing[ACCEL_CURVE_POINTS] = {16, 8, 32, 32};
+    static const uint8_t flat_max[ACCEL_CURVE_POINTS] = {
+        ACCEL_GAIN_MAX, ACCEL_GAIN_MAX, ACCEL_GAIN_MAX, ACCEL_GAIN_MAX};
+
+    EEPROM_Reset();
+
+    CHECK_EQ(EEPROM_SetAccelCurve(too_steep), EEPROM_STATUS_INVALID_PARAM);
+    CHECK_EQ(EEPROM_SetAccelCurve(decreasing), EEPROM_STATUS_INVALID_PARAM);
+    CHECK_EQ(EEPROM_GetAccelCurve()[ACCEL_CURVE_POINTS - 1],
+             ACCEL_GAIN_DEFAULT);
+
+    CHECK_EQ(EEPROM_SetAccelCurve(flat_max), EEPROM_STATUS_OK);
+    CHECK_EQ(EEPROM_SetAccelCurve(CURVE), EEPROM_STATUS_OK);
+    CHECK_EQ(memcmp(EEPROM_GetAccelCurve(), CURVE, sizeof(CURVE)), 0);
+    CHECK_EQ(EEPROM_Validate(), EEPROM_STATUS_OK);
+}
+
+int main() {
+    RUN(test_idle_interval_is_unchanged);
+    RUN(test_knee_points);
+    RUN(test_interpolation);
+    RUN(test_clamp_below_last_knee);
+    RUN(test_max_gain_fits_int16);
+    RUN(test_eeprom_rejects_invalid_curve);
+    return TEST_RESULT();
+}
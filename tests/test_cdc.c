@@ -0,0 +1,423 @@
+/*
+  CDC 串口主机测试
+
+  经由 USB 设备模拟读写 CDC 端点，检查发送环形缓冲区以消息为单位提交与
+  丢弃，主机不会收到截断的行，满包后以零长度包结束传输；接收 FIFO 在
+  剩余空间足够时连续接收数据包，空间不足时回复 NAK，读出后恢复接收；
+  端点2 一个缓冲区发送期间预装另一个缓冲区，主机一帧内可连续读取；
+  主机关闭串口（DTR 释放）、总线复位与挂起时报告主机离开；总线复位后
+  重新枚举，CDC 数据端点与描述符一致并可收发；设备事件
+  经端点1 以 8 字节通知发送，主机按顺序解码
+*/
+#include "usb_sim.h"
+#include "test.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * @brief 写入一条消息（不含换行符的内容加换行符）
+ * @return 消息完整提交返回 true
+ */
+static bool write_line(const char *text) {
+    uint8_t overflow = USBSerial_getTxOverflow();
+
+    USBSerial_print_n((uint8_t *)text, strlen(text));
+    USBSerial_write('\n');
+    return USBSerial_getTxOverflow() == overflow;
+}
+
+static void open_port() {
+    usb_sim_reset();
+    usb_enumerate();
+    usb_cdc_line_state(CDC_LINE_STATE_DTR | CDC_LINE_STATE_RTS);
+    USBSerial_takeHostLost();
+}
+
+static void test_closed_port_discards() {
+    usb_sim_reset();
+    usb_enumerate();
+
+    CHECK_EQ(USBSerial_write('x'), 0);
+    USBSerial_flush();
+    CHECK_EQ(usb_cdc_in_frame(19), 0);
+    CHECK_EQ(sim_cdc_packets, 0);
+}
+
+static void test_short_line_sent_on_flush() {
+    open_port();
+
+    // 不足一个数据包的消息在 flush 时发送
+    CHECK(write_line("hello"));
+    CHECK_EQ(usb_cdc_in_frame(19), 0);
+    USBSerial_flush();
+    CHECK_EQ(usb_cdc_in_frame(19), 6);
+    CHECK_EQ(memcmp(sim_cdc_rx, "hello\n", 6), 0);
+    CHECK_EQ(sim_cdc_zlps, 0);
+}
+
+static void test_full_packet_ends_with_zlp() {
+    char line[MAX_PACKET_SIZE];
+
+    open_port();
+    memset(line, 'a', sizeof(line) - 1);
+    line[sizeof(line) - 1] = '\0';
+
+    // 恰好 64 字节的消息提交后立即发送，随后以零长度包结束传输
+    CHECK(write_line(line));
+    CHECK_EQ(usb_cdc_in_frame(19), MAX_PACKET_SIZE);
+    CHECK_EQ(sim_cdc_packets, 2);
+    CHECK_EQ(sim_cdc_zlps, 1);
+    CHECK_EQ(usb_cdc_in(), -1);
+}
+
+static void test_full_ring_drops_whole_message() {
+    char line[50];
+
+    open_port();
+    memset(line, 'b', sizeof(line) - 1);
+    line[sizeof(line) - 1] = '\0';
+
+    // 主机不读取时，端点2 的两个缓冲区与环形缓冲区装满后，下一行整条丢弃
+    uint8_t lines = 0;
+    while (lines < 10 && write_line(line)) {
+        lines++;
+    }
+    CHECK(lines >= 2 && lines < 10);
+    CHECK_EQ(USBSerial_getTxOverflow(), 1);
+
+    // 丢弃后的新消息不受影响
+    CHECK(write_line("ok"));
+    USBSerial_flush();
+    while (usb_cdc_in_frame(19) > 0) {
+    }
+
+    CHECK_EQ(sim_cdc_rx_len, lines * 50 + 3);
+    CHECK_EQ(memcmp(sim_cdc_rx + lines * 50, "ok\n", 3), 0);
+    for (uint16_t i = 0; i < lines * 50; i++) {
+        CHECK_EQ(sim_cdc_rx[i], i % 50 == 49 ? '\n' : 'b');
+    }
+}
+
+static void test_large_response_with_backpressure() {
+    char line[40];
+    uint16_t sent = 0;
+    uint16_t expected = 0;
+
+    open_port();
+
+    // 主循环按剩余空间写入 200 行，主机每帧读取，全部按顺序到达且无丢弃
+    while (sent < 200) {
+        int len = snprintf(line, sizeof(line), "line %03u of a response",
+                           sent);
+
+        if (USBSerial_availableForWrite() > len) {
+            CHECK(write_line(line));
+            expected += len + 1;
+            sent++;
+        } else {
+            USBSerial_flush();
+            usb_frame();
+            usb_cdc_in_frame(19);
+        }
+    }
+    USBSerial_flush();
+    while (usb_cdc_in_frame(19) > 0) {
+    }
+
+    CHECK_EQ(USBSerial_getTxOverflow(), 0);
+    CHECK_EQ(sim_cdc_rx_len, expected);
+    CHECK_EQ(memcmp(sim_cdc_rx, "line 000 of a response\n", 23), 0);
+    CHECK_EQ(memcmp(sim_cdc_rx + expected - 23, "line 199 of a response\n",
+                    23),
+             0);
+}
+
+static void test_rx_fifo_accepts_two_packets() {
+    uint8_t packet[MAX_PACKET_SIZE];
+
+    open_port();
+    for (uint8_t i = 0; i < MAX_PACKET_SIZE; i++) {
+        packet[i] = i;
+    }
+
+    // 主循环未读取时连续接收两个数据包，第三个数据包回复 NAK
+    CHECK(usb_cdc_out(packet, MAX_PACKET_SIZE));
+    CHECK(usb_cdc_out(packet, MAX_PACKET_SIZE));
+    CHECK_EQ(USBSerial_available(), 2 * MAX_PACKET_SIZE);
+    CHECK(!usb_cdc_out(packet, MAX_PACKET_SIZE));
+
+    // 读出不足一个数据包时仍回复 NAK，空间足够后恢复接收
+    for (uint8_t i = 0; i < MAX_PACKET_SIZE - 1; i++) {
+        CHECK_EQ(USBSerial_read(), i);
+    }
+    CHECK(!usb_cdc_out(packet, MAX_PACKET_SIZE));
+    CHECK_EQ(USBSerial_read(), MAX_PACKET_SIZE - 1);
+    CHECK(usb_cdc_out(packet, 1));
+    CHECK_EQ(USBSerial_available(), MAX_PACKET_SIZE + 1);
+}
+
+static void test_rx_stream_in_order() {
+    uint8_t packet[MAX_PACKET_SIZE];
+    uint16_t sent = 0;
+    uint16_t received = 0;
+
+    open_port();
+    srand(13);
+
+    // 随机长度的数据包与随机读出量交替，数据按顺序到达，没有丢失
+    while (received < 5000) {
+        uint8_t len = 1 + rand() % MAX_PACKET_SIZE;
+
+        for (uint8_t i = 0; i < len; i++) {
+            packet[i] = (uint8_t)(sent + i);
+        }
+        if (sent < 5000 && usb_cdc_out(packet, len)) {
+            sent += len;
+        }
+
+        for (uint8_t n = rand() % 80; n > 0 && USBSerial_available(); n--) {
+            CHECK_EQ((uint8_t)USBSerial_read(), (uint8_t)received);
+            received++;
+        }
+    }
+
+    CHECK_EQ(received, sent);
+    CHECK_EQ(USBSerial_read(), 0);
+}
+
+static void test_rx_reset_drops_pending() {
+    uint8_t packet[MAX_PACKET_SIZE] = {0};
+
+    open_port();
+    CHECK(usb_cdc_out(packet, MAX_PACKET_SIZE));
+    CHECK(usb_cdc_out(packet, MAX_PACKET_SIZE));
+    CHECK(!usb_cdc_out(packet, MAX_PACKET_SIZE));
+
+    // 总线复位丢弃未读数据并恢复接收
+    usb_bus_reset();
+    CHECK_EQ(USBSerial_available(), 0);
+    CHECK(usb_cdc_out(packet, MAX_PACKET_SIZE));
+}
+
+static void test_endpoint_buffers_fit() {
+    // 各端点缓冲区互不重叠，且不超出 USB 内存设置；端点0 按数据手册
+    // 占用数据包长度加 2 字节
+    CHECK(EP0_ADDR + DEFAULT_ENDP0_SIZE + 2 <= EP1_ADDR);
+    CHECK(EP1_ADDR + sizeof(Ep1Buffer) <= EP2_ADDR);
+    CHECK(EP2_ADDR + sizeof(Ep2Buffer) <= EP3_ADDR);
+    CHECK(EP3_ADDR + sizeof(Ep3Buffer) <= USER_USB_RAM);
+    CHECK_EQ(sizeof(Ep2Buffer), 2 * MAX_PACKET_SIZE);
+}
+
+static void test_data_endpoints_after_reenumeration() {
+    USB_Descriptor_Configuration_t config;
+    const uint8_t text[] = "ping\n";
+
+    open_port();
+    for (uint8_t round = 0; round < 2; round++) {
+        // 总线复位后重新枚举，配置描述符中的 CDC 数据端点与硬件设置一致
+        usb_bus_reset();
+        CHECK_EQ(usb_control_in(USB_REQ_TYP_STANDARD, USB_GET_DESCRIPTOR,
+                                0x0200, 0, sizeof(config), (uint8_t *)&config),
+                 sizeof(config));
+        CHECK_EQ(config.CDC_DataOutEndpoint.EndpointAddress, 0x01);
+        CHECK_EQ(config.CDC_DataOutEndpoint.Attributes & 0x03, EP_TYPE_BULK);
+        CHECK_EQ(config.CDC_DataOutEndpoint.EndpointSize, MAX_PACKET_SIZE);
+        CHECK_EQ(config.CDC_DataInEndpoint.EndpointAddress, 0x82);
+        CHECK_EQ(config.CDC_DataInEndpoint.Attributes & 0x03, EP_TYPE_BULK);
+        CHECK_EQ(config.CDC_DataInEndpoint.EndpointSize, MAX_PACKET_SIZE);
+        CHECK(UEP4_1_MOD & bUEP1_RX_EN);
+        CHECK(!(UEP2_3_MOD & bUEP2_RX_EN));
+
+        // 重新打开串口后，数据双向收发
+        usb_enumerate();
+        usb_cdc_line_state(CDC_LINE_STATE_DTR | CDC_LINE_STATE_RTS);
+        CHECK(usb_cdc_out(text, sizeof(text) - 1));
+        for (uint8_t i = 0; i < sizeof(text) - 1; i++) {
+            CHECK_EQ(USBSerial_read(), text[i]);
+        }
+        CHECK_EQ(USBSerial_available(), 0);
+
+        sim_cdc_rx_len = 0;
+        CHECK(write_line("pong"));
+        USBSerial_flush();
+        CHECK_EQ(usb_cdc_in_frame(19), 5);
+        CHECK_EQ(memcmp(sim_cdc_rx, "pong\n", 5), 0);
+    }
+}
+
+/**
+ * @brief 写入一个恰好 64 字节的消息，内容为 tag 重复
+ */
+static void write_packet(char tag) {
+    char line[MAX_PACKET_SIZE];
+
+    memset(line, tag, sizeof(line) - 1);
+    line[sizeof(line) - 1] = '\0';
+    CHECK(write_line(line));
+}
+
+static void test_next_packet_staged() {
+    open_port();
+
+    // 第一个数据包发送期间，第二个数据包预装在另一个缓冲区
+    write_packet('a');
+    CHECK(UpPoint2BusyFlag);
+    CHECK(!txStaged);
+    write_packet('b');
+    CHECK(txStaged);
+    CHECK_EQ(txStagedLen, MAX_PACKET_SIZE);
+
+    uint8_t armed = (UEP2_CTRL & bUEP_T_TOG) ? MAX_PACKET_SIZE : 0;
+    uint8_t idle = MAX_PACKET_SIZE - armed;
+    CHECK_EQ(Ep2Buffer[armed], 'a');
+    CHECK_EQ(Ep2Buffer[idle], 'b');
+
+    // 预装缓冲区已满时，之后的数据留在环形缓冲区
+    write_packet('c');
+    CHECK_EQ(txHead - txTail, MAX_PACKET_SIZE);
+}
+
+static void test_packets_back_to_back() {
+    open_port();
+    write_packet('a');
+    write_packet('b');
+    write_packet('c');
+
+    // 主机一帧内连续读取三个数据包，预装的数据包在 IN 中断中立即启动
+    CHECK_EQ(usb_cdc_in(), MAX_PACKET_SIZE);
+    CHECK(UpPoint2BusyFlag);
+    CHECK_EQ(UEP2_T_LEN, MAX_PACKET_SIZE);
+    CHECK(txStaged); // 第三个数据包随即预装
+    CHECK_EQ(usb_cdc_in_frame(19), 2 * MAX_PACKET_SIZE);
+
+    CHECK_EQ(sim_cdc_packets, 4);
+    CHECK_EQ(sim_cdc_zlps, 1);
+    for (uint16_t i = 0; i < 3 * MAX_PACKET_SIZE; i++) {
+        CHECK_EQ(sim_cdc_rx[i], i % MAX_PACKET_SIZE == MAX_PACKET_SIZE - 1
+                                    ? '\n'
+                                    : 'a' + i / MAX_PACKET_SIZE);
+    }
+}
+
+static void test_host_presence() {
+    usb_sim_reset();
+    usb_enumerate();
+    CHECK(!USBSerial_takeHostLost());
+
+    // 打开串口：DTR 与 RTS 有效，不报告主机离开
+    usb_cdc_line_state(CDC_LINE_STATE_DTR | CDC_LINE_STATE_RTS);
+    CHECK_EQ(USBSerial_getLineState(),
+             CDC_LINE_STATE_DTR | CDC_LINE_STATE_RTS);
+    CHECK(!USBSerial_takeHostLost());
+
+    // 只改变 RTS 不是关闭串口
+    usb_cdc_line_state(CDC_LINE_STATE_DTR);
+    CHECK(!USBSerial_takeHostLost());
+
+    // 关闭串口：DTR 释放时报告一次主机离开
+    usb_cdc_line_state(0);
+    CHECK_EQ(USBSerial_getLineState(), 0);
+    CHECK(USBSerial_takeHostLost());
+    CHECK(!USBSerial_takeHostLost());
+    usb_cdc_line_state(CDC_LINE_STATE_RTS); // DTR 原本无效
+    CHECK(!USBSerial_takeHostLost());
+
+    // 挂起：报告主机离开，唤醒后串口仍然打开
+    usb_cdc_line_state(CDC_LINE_STATE_DTR);
+    usb_suspend();
+    CHECK(USBSerial_takeHostLost());
+    CHECK_EQ(USBSerial_getLineState(), CDC_LINE_STATE_DTR);
+
+    // 拔出（总线复位）：报告主机离开，重新枚举后需要再次打开串口
+    usb_bus_reset();
+    CHECK(USBSerial_takeHostLost());
+    usb_enumerate();
+    CHECK_EQ(USBSerial_getLineState(), 0);
+    CHECK_EQ(USBSerial_write('x'), 0);
+}
+
+/**
+ * @brief 主机读取一个端点1 通知并解码
+ * @return 收到设备事件通知返回 true，端点回复 NAK 返回 false
+ */
+static bool read_notification(uint8_t *event, uint8_t *param) {
+    uint8_t buf[CDC_NOTIFICATION_EPSIZE];
+    uint8_t len = UEP1_T_LEN; // IN 中断完成后清零
+
+    if (!usb_notify_in(buf)) {
+        return false;
+    }
+
+    CHECK_EQ(len, CDC_NOTIFICATION_EPSIZE);
+    CHECK_EQ(buf[0], 0xA1); // 设备到主机，类请求，接口
+    CHECK_EQ(buf[1], CDC_NOTIFY_DEVICE_EVENT);
+    CHECK_EQ(buf[4] | buf[5] << 8, INTERFACE_ID_CDC_CCI);
+    CHECK_EQ(buf[6] | buf[7] << 8, 0);
+    *event = buf[2];
+    *param = buf[3];
+    return true;
+}
+
+static void test_notifications_in_order() {
+    uint8_t event;
+    uint8_t param;
+
+    // 未配置时不发送通知
+    usb_sim_reset();
+    CHECK(!USBSerial_notify(CDC_EVENT_CONFIG_CHANGED, 0));
+    CHECK(!read_notification(&event, &param));
+
+    usb_enumerate();
+    CHECK(!read_notification(&event, &param)); // 没有事件时回复 NAK
+
+    // 第一个通知立即装入端点，其后队列可再容纳 CDC_NOTIFY_QUEUE_SIZE 个
+    CHECK(USBSerial_notify(CDC_EVENT_CONFIG_CHANGED, 0));
+    for (uint8_t i = 0; i < CDC_NOTIFY_QUEUE_SIZE; i++) {
+        CHECK(USBSerial_notify(CDC_EVENT_SAVE_COMPLETE, i));
+    }
+    CHECK(!USBSerial_notify(CDC_EVENT_ERROR, CDC_ERROR_SAVE_FAILED));
+
+    // 主机按发生顺序收到通知，被拒绝的通知不会发送
+    CHECK(read_notification(&event, &param));
+    CHECK_EQ(event, CDC_EVENT_CONFIG_CHANGED);
+    CHECK_EQ(param, 0);
+    for (uint8_t i = 0; i < CDC_NOTIFY_QUEUE_SIZE; i++) {
+        CHECK(read_notification(&event, &param));
+        CHECK_EQ(event, CDC_EVENT_SAVE_COMPLETE);
+        CHECK_EQ(param, i);
+    }
+    CHECK(!read_notification(&event, &param));
+
+    // 端点空闲后新的通知立即发送
+    CHECK(USBSerial_notify(CDC_EVENT_ERROR, CDC_ERROR_INVALID_CONFIG));
+    CHECK(read_notification(&event, &param));
+    CHECK_EQ(event, CDC_EVENT_ERROR);
+    CHECK_EQ(param, CDC_ERROR_INVALID_CONFIG);
+
+    // 总线复位丢弃尚未发送的通知
+    USBSerial_notify(CDC_EVENT_CONFIG_CHANGED, 0);
+    USBSerial_notify(CDC_EVENT_CONFIG_CHANGED, 0);
+    usb_bus_reset();
+    usb_enumerate();
+    CHECK(!read_notification(&event, &param));
+}
+
+int main() {
+    RUN(test_closed_port_discards);
+    RUN(test_short_line_sent_on_flush);
+    RUN(test_full_packet_ends_with_zlp);
+    RUN(test_full_ring_drops_whole_message);
+    RUN(test_large_response_with_backpressure);
+    RUN(test_rx_fifo_accepts_two_packets);
+    RUN(test_rx_stream_in_order);
+    RUN(test_rx_reset_drops_pending);
+    RUN(test_endpoint_buffers_fit);
+    RUN(test_data_endpoints_after_reenumeration);
+    RUN(test_next_packet_staged);
+    RUN(test_packets_back_to_back);
+    RUN(test_host_presence);
+    RUN(test_notifications_in_order);
+    return TEST_RESULT();
+}
@@ -0,0 +1,162 @@
+/*
+  格雷码状态跳变表解码主机测试
+
+  以主循环轮询采样方式回放 A/B 相状态序列，检查 1x/2x/4x 触发次数、
+  中途反转、触点抖动、非法跳变剔除与相位配置
+*/
+#include "../src/Drivers/EC11.c"
+#include "ec11_sim.h"
+#include "test.h"
+
+/**
+ * @brief 回放 A/B 相状态序列，每个状态采样一次
+ */
+static void replay(const uint8_t *states, uint8_t count) {
+    for (uint8_t i = 0; i < count; i++) {
+        sim_set_ab(0, states[i]);
+        host_millis++;
+        EC11_UpdateStatus();
+    }
+}
+
+static void replay_detents(const uint8_t *detent, uint8_t detents) {
+    for (uint8_t n = 0; n < detents; n++) {
+        replay(detent, 4);
+    }
+}
+
+static void test_transition_table() {
+    // 每个合法跳变与方向一一对应，无变化与 A/B 同时变化为 0
+    for (uint8_t from = 0; from < 4; from++) {
+        for (uint8_t to = 0; to < 4; to++) {
+            int8_t expected = 0;
+
+            for (uint8_t i = 0; i < 4; i++) {
+                if (from == CW_DETENT[(i + 3) % 4] && to == CW_DETENT[i]) {
+                    expected = 1;
+                }
+                if (from == CCW_DETENT[(i + 3) % 4] && to == CCW_DETENT[i]) {
+                    expected = -1;
+                }
+            }
+
+            CHECK_EQ(TRANSITION_TABLE[(from << 2) | to], expected);
+        }
+    }
+}
+
+static void test_resolution() {
+    static const uint8_t steps[3] = {STEP_PER_TEETH_1X, STEP_PER_TEETH_2X,
+                                     STEP_PER_TEETH_4X};
+    uint8_t cw, ccw;
+
+    for (uint8_t i = 0; i < 3; i++) {
+        sim_reset();
+        EC11_SetStepPerTeeth(steps[i]);
+
+        replay_detents(CW_DETENT, 5);
+        sim_drain(0, &cw, &ccw);
+        CHECK_EQ(cw, 5 * steps[i]);
+        CHECK_EQ(ccw, 0);
+
+        replay_detents(CCW_DETENT, 3);
+        sim_drain(0, &cw, &ccw);
+        CHECK_EQ(cw, 0);
+        CHECK_EQ(ccw, 3 * steps[i]);
+    }
+}
+
+static void test_reversal_mid_detent() {
+    static const uint8_t half_and_back[4] = {1, 0, 1, 3};
+    uint8_t cw, ccw;
+
+    // 1x 时转半齿再退回，累计值归零，不产生事件
+    sim_reset();
+    EC11_SetStepPerTeeth(STEP_PER_TEETH_1X);
+    replay(half_and_back, 4);
+    sim_drain(0, &cw, &ccw);
+    CHECK_EQ(cw + ccw, 0);
+
+    // 4x 时每个跳变都产生事件
+    sim_reset();
+    EC11_SetStepPerTeeth(STEP_PER_TEETH_4X);
+    replay(half_and_back, 4);
+    sim_drain(0, &cw, &ccw);
+    CHECK_EQ(cw, 2);
+    CHECK_EQ(ccw, 2);
+}
+
+static void test_contact_bounce() {
+    // A 相边沿抖动两次后完成一齿
+    static const uint8_t bouncy[8] = {1, 3, 1, 3, 1, 0, 2, 3};
+    uint8_t cw, ccw;
+
+    sim_reset();
+    EC11_SetStepPerTeeth(STEP_PER_TEETH_1X);
+    replay(bouncy, 8);
+    sim_drain(0, &cw, &ccw);
+    CHECK_EQ(cw, 1);
+    CHECK_EQ(ccw, 0);
+    CHECK_EQ(EC11_GetInvalidTransitions(0), 0);
+}
+
+static void test_invalid_transition_rejected() {
+    // 漏采导致 A/B 同时变化（3→0、0→3）
+    static const uint8_t skipped[4] = {0, 3, 1, 0};
+    uint8_t cw, ccw;
+
+    sim_reset();
+    EC11_SetStepPerTeeth(STEP_PER_TEETH_4X);
+    replay(skipped, 4);
+    sim_drain(0, &cw, &ccw);
+    CHECK_EQ(EC11_GetInvalidTransitions(0), 2);
+    CHECK_EQ(cw, 2);
+    CHECK_EQ(ccw, 0);
+}
+
+static void test_phase_b_leads() {
+    uint8_t cw, ccw;
+
+    sim_reset();
+    EC11_SetPhase(EC11_PHASE_B_LEADS);
+    replay_detents(CW_DETENT, 2);
+    sim_drain(0, &cw, &ccw);
+    CHECK_EQ(cw, 0);
+    CHECK_EQ(ccw, 2 * STEP_PER_TEETH_DEFAULT);
+}
+
+static void test_event_interval() {
+    uint8_t index;
+
+    sim_reset();
+    EC11_SetStepPerTeeth(STEP_PER_TEETH_1X);
+
+    // 每 10 毫秒一个状态跳变，一齿 40 毫秒
+    host_millis = 1000;
+    for (uint8_t n = 0; n < 2; n++) {
+        for (uint8_t i = 0; i < 4; i++) {
+            host_millis += 10;
+            sim_set_ab(0, CW_DETENT[i]);
+            EC11_UpdateStatus();
+        }
+    }
+
+    CHECK_EQ(EC11_GetDirection(&index), EC11_DIR_CW);
+    CHECK_EQ(EC11_GetEventTime(0), 1040);
+    CHECK_EQ(EC11_GetEventInterval(0), 0xFFFF);
+
+    CHECK_EQ(EC11_GetDirection(&index), EC11_DIR_CW);
+    CHECK_EQ(EC11_GetEventTime(0), 1080);
+    CHECK_EQ(EC11_GetEventInterval(0), 40);
+}
+
+int main() {
+    RUN(test_transition_table);
+    RUN(test_resolution);
+    RUN(test_reversal_mid_detent);
+    RUN(test_contact_bounce);
+    RUN(test_invalid_transition_rejected);
+    RUN(test_phase_b_leads);
+    RUN(test_event_interval);
+    return TEST_RESULT();
+}
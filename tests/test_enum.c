@@ -0,0 +1,271 @@
+/*
+  USB 枚举主机测试
+
+  经由 USB 设备模拟重放常见主机的枚举请求序列（描述符、地址、配置、
+  HID 空闲速率与协议、CDC 线路编码），主机每帧发出一个控制传输，
+  检查全程没有 STALL 并输出进入配置状态所需的帧数；另检查 SET_IDLE
+  设置的空闲速率按旋钮在端点3 上重复发送报告，未配置时不发送，总线复位后
+  恢复默认值；只支持报告协议；
+  配置描述符中 HID 描述符声明的报告描述符长度与实际返回的长度一致；
+  各端点均可设置与清除 ENDPOINT_HALT
+*/
+#include "usb_sim.h"
+#include "test.h"
+
+#include <stdio.h>
+
+#define STD_DEVICE (USB_REQ_TYP_STANDARD | USB_REQ_RECIP_DEVICE)
+#define STD_INTERF (USB_REQ_TYP_STANDARD | USB_REQ_RECIP_INTERF)
+#define CLASS_INTERF (USB_REQ_TYP_CLASS | USB_REQ_RECIP_INTERF)
+#define STD_ENDP (USB_REQ_TYP_STANDARD | USB_REQ_RECIP_ENDP)
+
+#define DEVICE_ADDRESS 5
+
+/**
+ * @brief 枚举序列中的一个控制传输
+ */
+typedef struct {
+    uint8_t type; // bmRequestType，含方向位
+    uint8_t request;
+    uint16_t value;
+    uint16_t index;
+    uint16_t length;
+} EnumRequest;
+
+// 115200 8N1
+static const uint8_t line_coding[LINE_CODEING_SIZE] = {0x00, 0xC2, 0x01, 0x00,
+                                                       0x00, 0x00, 0x08};
+
+static const EnumRequest enum_sequence[] = {
+    {STD_DEVICE | USB_REQ_TYP_IN, USB_GET_DESCRIPTOR, 0x0100, 0, 64},
+    {STD_DEVICE, USB_SET_ADDRESS, DEVICE_ADDRESS, 0, 0},
+    {STD_DEVICE | USB_REQ_TYP_IN, USB_GET_DESCRIPTOR, 0x0100, 0, 18},
+    {STD_DEVICE | USB_REQ_TYP_IN, USB_GET_DESCRIPTOR, 0x0200, 0, 9},
+    {STD_DEVICE | USB_REQ_TYP_IN, USB_GET_DESCRIPTOR, 0x0200, 0, 255},
+    {STD_DEVICE | USB_REQ_TYP_IN, USB_GET_DESCRIPTOR, 0x0300, 0, 255},
+    {STD_DEVICE | USB_REQ_TYP_IN, USB_GET_DESCRIPTOR, 0x0302, 0x0409, 255},
+    {STD_DEVICE | USB_REQ_TYP_IN, USB_GET_DESCRIPTOR, 0x0301, 0x0409, 255},
+    {STD_DEVICE | USB_REQ_TYP_IN, USB_GET_DESCRIPTOR, 0x0303, 0x0409, 255},
+    {STD_DEVICE | USB_REQ_TYP_IN, USB_GET_STATUS, 0, 0, 2},
+    {STD_DEVICE, USB_SET_CONFIGURATION, 1, 0, 0},
+    {CLASS_INTERF, HID_SET_IDLE, 0, INTERFACE_ID_HID, 0},
+    {STD_INTERF | USB_REQ_TYP_IN, USB_GET_DESCRIPTOR, 0x2200,
+     INTERFACE_ID_HID, sizeof(ReportDescriptor) + 64},
+    {CLASS_INTERF | USB_REQ_TYP_IN, HID_GET_PROTOCOL, 0, INTERFACE_ID_HID, 1},
+    {CLASS_INTERF, HID_SET_PROTOCOL, HID_PROTOCOL_REPORT, INTERFACE_ID_HID,
+     0},
+    {CLASS_INTERF | USB_REQ_TYP_IN, HID_GET_IDLE, RADIAL_REPORT_ID,
+     INTERFACE_ID_HID, 1},
+    {CLASS_INTERF | USB_REQ_TYP_IN, GET_LINE_CODING, 0, INTERFACE_ID_CDC_CCI,
+     LINE_CODEING_SIZE},
+    {CLASS_INTERF, SET_LINE_CODING, 0, INTERFACE_ID_CDC_CCI,
+     LINE_CODEING_SIZE},
+    {CLASS_INTERF, SET_CONTROL_LINE_STATE, 0, INTERFACE_ID_CDC_CCI, 0},
+};
+
+static void test_enumeration_replay() {
+    uint8_t buf[256];
+    uint16_t configured_at = 0;
+    uint8_t count = sizeof(enum_sequence) / sizeof(enum_sequence[0]);
+
+    usb_sim_reset();
+
+    for (uint8_t i = 0; i < count; i++) {
+        const EnumRequest *r = &enum_sequence[i];
+        uint16_t result;
+
+        usb_frame();
+        if (r->type & USB_REQ_TYP_IN) {
+            result = usb_control_in(r->type, r->request, r->value, r->index,
+                                    r->length, buf);
+        } else {
+            result = usb_control_out(r->type, r->request, r->value, r->index,
+                                     r->length, line_coding);
+        }
+        CHECK(result != SIM_STALL);
+
+        if (r->request == USB_SET_CONFIGURATION) {
+            configured_at = sim_frame;
+        }
+    }
+
+    CHECK_EQ(sim_stalls, 0);
+    CHECK_EQ(USB_DEV_AD & ~bUDA_GP_BIT, DEVICE_ADDRESS);
+    CHECK_EQ(UsbConfig, 1);
+    CHECK_EQ(memcmp(LineCoding, line_coding, LINE_CODEING_SIZE), 0);
+    printf("     %u requests, %u STALLs, configured after %u frames, "
+           "%u frames total\n",
+           count, sim_stalls, configured_at, sim_frame);
+}
+
+static void test_report_descriptor_length() {
+    uint8_t config[255];
+    uint8_t report[256];
+    uint16_t declared = 0;
+
+    usb_sim_reset();
+    usb_enumerate();
+
+    // 在配置描述符中找到 HID 描述符，wDescriptorLength 位于偏移 7
+    uint16_t total = usb_control_in(STD_DEVICE | USB_REQ_TYP_IN,
+                                    USB_GET_DESCRIPTOR, 0x0200, 0,
+                                    sizeof(config), config);
+    CHECK_EQ(total, sizeof(ConfigurationDescriptor));
+    for (uint16_t i = 0; i < total && config[i] != 0; i += config[i]) {
+        if (config[i + 1] == HID_DTYPE_HID) {
+            declared = config[i + 7] | (config[i + 8] << 8);
+        }
+    }
+
+    uint16_t length = usb_control_in(STD_INTERF | USB_REQ_TYP_IN,
+                                     USB_GET_DESCRIPTOR, 0x2200,
+                                     INTERFACE_ID_HID, sizeof(report), report);
+    CHECK_EQ(declared, sizeof(ReportDescriptor));
+    CHECK_EQ(length, declared);
+    CHECK_EQ(memcmp(report, ReportDescriptor, length), 0);
+}
+
+static void test_idle_and_protocol_requests() {
+    uint8_t value = 0xFF;
+
+    usb_sim_reset();
+    usb_enumerate();
+
+    // 报告 ID 为 0 的 SET_IDLE 作用于全部旋钮，GET_IDLE 按报告 ID 读出
+    CHECK_EQ(usb_control_out(CLASS_INTERF, HID_SET_IDLE, 0x0500,
+                             INTERFACE_ID_HID, 0, NULL),
+             0);
+    for (uint8_t dial = 0; dial < RADIAL_DIAL_COUNT; dial++) {
+        CHECK_EQ(usb_control_in(CLASS_INTERF, HID_GET_IDLE,
+                                RADIAL_REPORT_ID + dial, INTERFACE_ID_HID, 1,
+                                &value),
+                 1);
+        CHECK_EQ(value, 5);
+    }
+
+    // 单个旋钮的 SET_IDLE 不影响其他旋钮
+    CHECK_EQ(usb_control_out(CLASS_INTERF, HID_SET_IDLE,
+                             0x0200 | (RADIAL_REPORT_ID + 1),
+                             INTERFACE_ID_HID, 0, NULL),
+             0);
+    usb_control_in(CLASS_INTERF, HID_GET_IDLE, RADIAL_REPORT_ID + 1,
+                   INTERFACE_ID_HID, 1, &value);
+    CHECK_EQ(value, 2);
+    usb_control_in(CLASS_INTERF, HID_GET_IDLE, RADIAL_REPORT_ID,
+                   INTERFACE_ID_HID, 1, &value);
+    CHECK_EQ(value, 5);
+
+    // 不支持启动协议，切换到启动协议回复 STALL，始终保持报告协议
+    CHECK_EQ(usb_control_out(CLASS_INTERF, HID_SET_PROTOCOL,
+                             HID_PROTOCOL_BOOT, INTERFACE_ID_HID, 0, NULL),
+             SIM_STALL);
+    CHECK_EQ(usb_control_in(CLASS_INTERF, HID_GET_PROTOCOL, 0,
+                            INTERFACE_ID_HID, 1, &value),
+             1);
+    CHECK_EQ(value, HID_PROTOCOL_REPORT);
+    CHECK_EQ(usb_control_out(CLASS_INTERF, HID_SET_PROTOCOL,
+                             HID_PROTOCOL_REPORT, INTERFACE_ID_HID, 0, NULL),
+             0);
+
+    // 不存在的报告 ID 回复 STALL
+    CHECK_EQ(usb_control_out(CLASS_INTERF, HID_SET_IDLE,
+                             0x0100 | (RADIAL_REPORT_ID + RADIAL_DIAL_COUNT),
+                             INTERFACE_ID_HID, 0, NULL),
+             SIM_STALL);
+    CHECK_EQ(sim_stalls, 2);
+
+    // 总线复位恢复默认空闲速率
+    usb_bus_reset();
+    usb_enumerate();
+    usb_control_in(CLASS_INTERF, HID_GET_IDLE, RADIAL_REPORT_ID,
+                   INTERFACE_ID_HID, 1, &value);
+    CHECK_EQ(value, 0);
+    usb_control_in(CLASS_INTERF, HID_GET_PROTOCOL, 0, INTERFACE_ID_HID, 1,
+                   &value);
+    CHECK_EQ(value, HID_PROTOCOL_REPORT);
+}
+
+static void test_endpoint_halt() {
+    static const uint8_t endpoints[] = {0x01, 0x81, 0x02, 0x82, 0x83};
+
+    usb_sim_reset();
+    usb_enumerate();
+
+    for (uint8_t i = 0; i < sizeof(endpoints); i++) {
+        CHECK_EQ(usb_control_out(STD_ENDP, USB_SET_FEATURE, 0, endpoints[i],
+                                 0, NULL),
+                 0);
+        CHECK_EQ(usb_control_out(STD_ENDP, USB_CLEAR_FEATURE, 0,
+                                 endpoints[i], 0, NULL),
+                 0);
+    }
+    CHECK_EQ(sim_stalls, 0);
+}
+
+static void test_idle_rate_repeats_reports() {
+    usb_sim_reset();
+    usb_enumerate();
+
+    // 空闲速率为 0 时，报告取走后不再重复发送
+    Radial_SendData(0, 1, 0);
+    usb_drain_reports(100);
+    uint16_t reports = sim_report_count;
+    usb_frames(200);
+    CHECK_EQ(sim_report_count, reports);
+
+    // 旋钮 0 每 32 毫秒重复一次报告，旋转量为 0 并保持当前按钮状态
+    usb_control_out(CLASS_INTERF, HID_SET_IDLE, 0x0800 | RADIAL_REPORT_ID,
+                    INTERFACE_ID_HID, 0, NULL);
+    usb_frames(320);
+
+    uint16_t repeats = 0;
+    for (uint16_t i = reports; i < sim_report_count; i++) {
+        CHECK_EQ(sim_report_id[i], RADIAL_REPORT_ID);
+        CHECK_EQ(sim_report_value[i], RADIAL_BUTTON_MASK);
+        if (i > reports) {
+            CHECK_EQ(sim_report_frame[i] - sim_report_frame[i - 1], 32);
+        }
+        repeats++;
+    }
+    CHECK(repeats >= 9 && repeats <= 10);
+    CHECK_EQ(sim_dial_total[0], 0);
+    CHECK_EQ(sim_button[0], 1);
+
+    // 新的旋转立即发送，重复计时从这次发送重新开始
+    Radial_SendData(0, 0, 10);
+    usb_drain_reports(100);
+    reports = sim_report_count;
+    CHECK_EQ(sim_dial_total[0], 100);
+    CHECK_EQ(sim_button[0], 0);
+    usb_frames(40);
+    CHECK_EQ(sim_report_count, reports + 1);
+    CHECK_EQ(sim_report_value[reports], 0);
+    CHECK_EQ(sim_report_frame[reports] - sim_report_frame[reports - 1], 32);
+
+    // 取消配置后不再重复发送，重新配置后按保留的空闲速率恢复
+    usb_drain_reports(100);
+    CHECK_EQ(usb_control_out(STD_DEVICE, USB_SET_CONFIGURATION, 0, 0, 0, NULL),
+             0);
+    CHECK_EQ(UsbConfig, 0);
+    reports = sim_report_count;
+    usb_frames(200);
+    CHECK_EQ(sim_report_count, reports);
+    CHECK(!UpPoint3_Busy);
+
+    // 空闲速率早已到期，重新配置后的第一次轮询即重复发送
+    usb_control_out(STD_DEVICE, USB_SET_CONFIGURATION, 1, 0, 0, NULL);
+    usb_frames(8);
+    CHECK_EQ(sim_report_count, reports + 1);
+    usb_frames(32);
+    CHECK_EQ(sim_report_count, reports + 2);
+    CHECK_EQ(sim_report_frame[reports + 1] - sim_report_frame[reports], 32);
+}
+
+int main() {
+    RUN(test_enumeration_replay);
+    RUN(test_report_descriptor_length);
+    RUN(test_idle_and_protocol_requests);
+    RUN(test_idle_rate_repeats_reports);
+    RUN(test_endpoint_halt);
+    return TEST_RESULT();
+}
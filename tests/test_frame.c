@@ -0,0 +1,194 @@
+/*
+  COBS + CRC-16 帧协议主机测试
+
+  Frame_Send 编码的帧经 Frame_Decode 解码后应与原数据相同；
+  检查 0x00 连续出现、254 字节数据块、CRC 错误与截断的帧
+*/
+#include "../src/CdcRadial/USBFrame.c"
+#include "frame_sink.h"
+#include "test.h"
+
+#include <stdlib.h>
+
+// 序号 1 的 PING 请求编码结果，与 tools/web_config/frame.js 的测试共用
+static const uint8_t PING_FRAME[] = {0x00, 0x05, 0x01, 0x01,
+                                     0x1F, 0x3E, 0x00};
+
+/**
+ * @brief 发送一帧并去掉首尾分隔符后原地解码
+ * @return 解码得到的帧长度，失败返回 0
+ */
+static uint8_t round_trip(uint8_t *data, uint8_t len, uint8_t *decoded) {
+    uint8_t copy[FRAME_DECODED_MAX];
+
+    memcpy(copy, data, len);
+    sink_reset();
+    if (!Frame_Send(copy, len)) {
+        return 0;
+    }
+
+    CHECK_EQ(sink[0], FRAME_DELIMITER);
+    CHECK_EQ(sink[sink_len - 1], FRAME_DELIMITER);
+    CHECK(sink_len <= FRAME_ENCODED_MAX + 2);
+    for (uint16_t i = 1; i + 1 < sink_len; i++) {
+        CHECK(sink[i] != FRAME_DELIMITER);
+    }
+
+    memcpy(decoded, sink + 1, sink_len - 2);
+    return Frame_Decode(decoded, sink_len - 2);
+}
+
+static void test_crc16() {
+    CHECK_EQ(Frame_CRC16((const uint8_t *)"123456789", 9), 0x29B1);
+    CHECK_EQ(Frame_CRC16(NULL, 0), 0xFFFF);
+}
+
+static void test_known_frame() {
+    uint8_t data[FRAME_DECODED_MAX] = {0x01, FRAME_OP_PING};
+
+    sink_reset();
+    CHECK(Frame_Send(data, 2));
+    CHECK_EQ(sink_len, sizeof(PING_FRAME));
+    CHECK_EQ(memcmp(sink, PING_FRAME, sizeof(PING_FRAME)), 0);
+}
+
+static void test_round_trip_random() {
+    uint8_t data[FRAME_DECODED_MAX];
+    uint8_t decoded[FRAME_ENCODED_MAX];
+
+    srand(1);
+    for (uint16_t n = 0; n < 2000; n++) {
+        uint8_t len = FRAME_HEADER_SIZE + rand() % (FRAME_PAYLOAD_MAX + 1);
+
+        for (uint8_t i = 0; i < len; i++) {
+            // 约四分之一的字节为 0x00
+            data[i] = rand() % 4 ? rand() & 0xFF : 0;
+        }
+
+        CHECK_EQ(round_trip(data, len, decoded), len);
+        CHECK_EQ(memcmp(decoded, data, len), 0);
+    }
+}
+
+static void test_zero_run() {
+    uint8_t data[FRAME_DECODED_MAX] = {0};
+    uint8_t decoded[FRAME_ENCODED_MAX];
+    uint8_t len = FRAME_HEADER_SIZE + FRAME_PAYLOAD_MAX;
+
+    // 全部为 0x00 时每个字节编码为一个 0x01
+    CHECK_EQ(round_trip(data, len, decoded), len);
+    CHECK_EQ(memcmp(decoded, data, len), 0);
+    for (uint8_t i = 1; i <= len; i++) {
+        CHECK_EQ(sink[i], 0x01);
+    }
+
+    // 首尾与 CRC 前的 0x00
+    data[1] = 0x55;
+    data[len - 2] = 0xAA;
+    CHECK_EQ(round_trip(data, len, decoded), len);
+    CHECK_EQ(memcmp(decoded, data, len), 0);
+}
+
+static void test_max_block() {
+    uint8_t buf[255];
+    uint8_t decoded[254];
+    uint16_t crc;
+    uint8_t seed = 0;
+
+    // 254 字节不含 0x00 的数据块以 0xFF 编码，其后没有隐含的 0x00，
+    // 编码恰好 255 字节；选择使 CRC 两个字节也不为 0 的数据
+    do {
+        seed++;
+        for (uint8_t i = 0; i < 252; i++) {
+            decoded[i] = (uint8_t)(i * 7 + seed) | 0x01;
+        }
+        crc = Frame_CRC16(decoded, 252);
+    } while ((crc & 0xFF) == 0 || (crc >> 8) == 0);
+
+    decoded[252] = crc & 0xFF;
+    decoded[253] = crc >> 8;
+
+    buf[0] = 0xFF;
+    memcpy(buf + 1, decoded, 254);
+
+    CHECK_EQ(Frame_Decode(buf, 255), 252);
+    CHECK_EQ(memcmp(buf, decoded, 252), 0);
+
+    // 数据块声明的长度超出编码数据
+    buf[0] = 0xFF;
+    memcpy(buf + 1, decoded, 254);
+    CHECK_EQ(Frame_Decode(buf, 254), 0);
+}
+
+static void test_bad_crc() {
+    uint8_t data[FRAME_DECODED_MAX] = {0x07, FRAME_OP_SAVE_SETTINGS, 1, 0, 2};
+    uint8_t encoded[FRAME_ENCODED_MAX];
+    uint8_t buf[FRAME_ENCODED_MAX];
+    uint8_t len = 5;
+
+    sink_reset();
+    CHECK(Frame_Send(data, len));
+    uint8_t encoded_len = sink_len - 2;
+    memcpy(encoded, sink + 1, encoded_len);
+
+    // 逐个翻转每个编码字节的每一位，仍不含 0x00 的都应被 CRC 或 COBS 拒绝
+    for (uint8_t i = 0; i < encoded_len; i++) {
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            memcpy(buf, encoded, encoded_len);
+            buf[i] ^= 1 << bit;
+            if (buf[i] == 0) {
+                continue;
+            }
+            CHECK_EQ(Frame_Decode(buf, encoded_len), 0);
+        }
+    }
+}
+
+static void test_truncated_frame() {
+    uint8_t data[FRAME_DECODED_MAX] = {0x02, FRAME_OP_LOAD_SETTINGS, 0, 1, 0,
+                                       2,    3,                      0, 0, 4};
+    uint8_t encoded[FRAME_ENCODED_MAX];
+    uint8_t buf[FRAME_ENCODED_MAX];
+    uint8_t len = 10;
+
+    sink_reset();
+    CHECK(Frame_Send(data, len));
+    uint8_t encoded_len = sink_len - 2;
+    memcpy(encoded, sink + 1, encoded_len);
+
+    for (uint8_t cut = 0; cut < encoded_len; cut++) {
+        memcpy(buf, encoded, cut);
+        CHECK_EQ(Frame_Decode(buf, cut), 0);
+    }
+
+    // 编码数据中出现 0x00 说明帧被截断后与下一帧相接
+    memcpy(buf, encoded, encoded_len);
+    buf[encoded_len / 2] = 0;
+    CHECK_EQ(Frame_Decode(buf, encoded_len), 0);
+}
+
+static void test_send_without_space() {
+    uint8_t data[FRAME_DECODED_MAX] = {0x03, FRAME_OP_PING};
+
+    // 空间不足时整帧丢弃，不写入任何字节
+    sink_reset();
+    sink_space = sizeof(PING_FRAME) - 1;
+    CHECK(!Frame_Send(data, 2));
+    CHECK_EQ(sink_len, 0);
+
+    sink_space = sizeof(PING_FRAME);
+    CHECK(Frame_Send(data, 2));
+    CHECK_EQ(sink_len, sizeof(PING_FRAME));
+}
+
+int main() {
+    RUN(test_crc16);
+    RUN(test_known_frame);
+    RUN(test_round_trip_random);
+    RUN(test_zero_run);
+    RUN(test_max_block);
+    RUN(test_bad_crc);
+    RUN(test_truncated_frame);
+    RUN(test_send_without_space);
+    return TEST_RESULT();
+}
@@ -0,0 +1,148 @@
+/*
+  主机端帧协议库（tools/web_config/frame.js）测试
+
+  与 test_frame.c 使用相同的已知帧，确认主机端与固件的编码一致；
+  检查往返、0x00 连续出现、254 字节数据块、CRC 错误、截断的帧，
+  以及从 ASCII 与帧交错的数据流中分离应答
+*/
+const RadialFrame = require('../tools/web_config/frame.js');
+
+let failures = 0;
+let checks = 0;
+
+function check(cond, message) {
+    checks++;
+    if (!cond) {
+        failures++;
+        console.log(`check failed: ${message}`);
+    }
+}
+
+function equal_bytes(a, b) {
+    return a.length === b.length && a.every((byte, i) => byte === b[i]);
+}
+
+function run(name, test) {
+    const before = failures;
+    test();
+    console.log(`${failures === before ? 'ok  ' : 'FAIL'} ${name}`);
+}
+
+// 与 test_frame.c 中的 PING_FRAME 相同
+const PING_FRAME = [0x00, 0x05, 0x01, 0x01, 0x1F, 0x3E, 0x00];
+
+// 确定性的伪随机数，便于重现失败的用例
+let seed = 1;
+function random_byte() {
+    seed = (seed * 1103515245 + 12345) & 0x7FFFFFFF;
+    return seed >> 16 & 0xFF;
+}
+
+function strip(frame) {
+    return frame.subarray(1, frame.length - 1);
+}
+
+run('crc16', () => {
+    check(RadialFrame.crc16(Buffer.from('123456789')) === 0x29B1, 'check value');
+    check(RadialFrame.crc16([]) === 0xFFFF, 'empty');
+});
+
+run('known_frame', () => {
+    const frame = RadialFrame.encode(1, RadialFrame.OP.PING);
+    check(equal_bytes(frame, PING_FRAME), `ping frame ${Buffer.from(frame).toString('hex')}`);
+});
+
+run('round_trip_random', () => {
+    for (let n = 0; n < 2000; n++) {
+        const data = new Uint8Array(random_byte() % (RadialFrame.PAYLOAD_MAX + 1));
+        data.forEach((_, i) => { data[i] = random_byte() % 4 ? random_byte() : 0; });
+
+        const frame = RadialFrame.encode(n & 0xFF, n % 10, data);
+        check(strip(frame).every(byte => byte !== 0), 'delimiter inside frame');
+
+        const decoded = RadialFrame.decode(strip(frame));
+        check(decoded !== null && decoded.seq === (n & 0xFF) && decoded.opcode === n % 10 &&
+              equal_bytes(decoded.data, data), `round trip ${n}`);
+    }
+});
+
+run('zero_run', () => {
+    const data = new Uint8Array(RadialFrame.PAYLOAD_MAX);
+    const frame = RadialFrame.encode(0, 0, data);
+
+    // 序号、操作码与数据全为 0x00，每个字节编码为一个 0x01
+    const zeros = RadialFrame.HEADER_SIZE + data.length;
+    check(strip(frame).slice(0, zeros).every(byte => byte === 0x01), 'zeros encode as 0x01');
+    check(equal_bytes(RadialFrame.decode(strip(frame)).data, data), 'zeros round trip');
+});
+
+run('max_block', () => {
+    // 254 字节不含 0x00 的数据块以 0xFF 编码，其后的 0x01 不产生隐含的 0x00
+    const block = new Uint8Array(254).map((_, i) => (i * 7 + 1) | 1);
+    const encoded = RadialFrame.cobs_encode(block);
+
+    check(encoded[0] === 0xFF && encoded.length === 256 && encoded[255] === 0x01,
+          'block code');
+    check(equal_bytes(RadialFrame.cobs_decode(encoded), block), 'block round trip');
+    check(equal_bytes(RadialFrame.cobs_decode(encoded.subarray(0, 255)), block),
+          'block without trailing code');
+
+    // 数据块之后继续的数据
+    const longer = new Uint8Array(300).map((_, i) => (i === 270 ? 0 : (i % 250) + 1));
+    check(equal_bytes(RadialFrame.cobs_decode(RadialFrame.cobs_encode(longer)), longer),
+          'data after block');
+
+    check(RadialFrame.cobs_decode(encoded.subarray(0, 200)) === null, 'short block');
+});
+
+run('bad_crc', () => {
+    const encoded = strip(RadialFrame.encode(7, RadialFrame.OP.SAVE_SETTINGS, [1, 0, 2]));
+
+    for (let i = 0; i < encoded.length; i++) {
+        for (let bit = 0; bit < 8; bit++) {
+            const buf = Uint8Array.from(encoded);
+            buf[i] ^= 1 << bit;
+            if (buf[i] !== 0) {
+                check(RadialFrame.decode(buf) === null, `flip byte ${i} bit ${bit}`);
+            }
+        }
+    }
+});
+
+run('truncated_frame', () => {
+    const encoded = strip(RadialFrame.encode(2, RadialFrame.OP.LOAD_SETTINGS,
+                                             [0, 1, 0, 2, 3, 0, 0, 4]));
+
+    for (let cut = 0; cut < encoded.length; cut++) {
+        check(RadialFrame.decode(encoded.subarray(0, cut)) === null, `cut at ${cut}`);
+    }
+});
+
+run('reader', () => {
+    const response = RadialFrame.encode(3, RadialFrame.OP.PING | RadialFrame.OP.RESPONSE,
+                                        [RadialFrame.STATUS.OK, 0, 3]);
+    const corrupt = Uint8Array.from(response);
+    corrupt[3] ^= 0x01;
+
+    const stream = Uint8Array.from([
+        ...Buffer.from('heartbeat_success\r\n'), 0x00, ...response,
+        ...Buffer.from('bytes_written=4\n'), ...corrupt,
+    ]);
+    const reader = new RadialFrame.Reader();
+    const results = [];
+
+    // 连续的分隔符视为空帧；逐字节读取，模拟帧跨越多次读取
+    for (const byte of stream) {
+        results.push(...reader.push([byte]));
+    }
+
+    check(results.length === 4, `result count ${results.length}`);
+    check(results[0].type === 'line' && results[0].text === 'heartbeat_success', 'line 1');
+    check(results[1].type === 'frame' && results[1].frame.seq === 3 &&
+          equal_bytes(results[1].frame.data, [0, 0, 3]), 'frame');
+    check(results[2].type === 'line' && results[2].text === 'bytes_written=4', 'line 2');
+    check(results[3].type === 'error', 'corrupt frame');
+});
+
+console.log(`${checks} checks, ${failures} failed`);
+process.exit(failures !== 0 ? 1 : 0);
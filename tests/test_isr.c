@@ -0,0 +1,300 @@
+/*
+  外部中断采样主机测试
+
+  以外部中断采样方式编译驱动，在 A/B 相下降沿直接调用 A 相外部中断与
+  B 相 GPIO 中断处理函数，检查按齿解码、主循环阻塞期间不丢失步数、
+  触点抖动与非法跳变、中断上下文不调用 millis()、定时器 2 推进时间戳
+  时钟使阻塞期间的慢速旋转不被加速、旋转事件缓冲区的顺序与溢出计数，
+  以及按键锁存
+*/
+#include "../src/Drivers/EC11.c"
+#include "ec11_sim.h"
+#include "test.h"
+
+// 引脚上的 A/B 相电平，用于判断下降沿
+static uint8_t pin_state = 3;
+
+/**
+ * @brief 切换 A/B 相状态，在下降沿调用对应的中断处理函数
+ */
+static void isr_step(uint8_t state) {
+    uint8_t fell = pin_state & ~state;
+
+    sim_set_ab(0, state);
+    pin_state = state;
+    if (fell & 0x02) {
+        EC11_IsrA();
+    }
+    if (fell & 0x01) {
+        EC11_GpioInterrupt();
+    }
+}
+
+static void isr_reset() {
+    sim_reset();
+    pin_state = 3;
+}
+
+static void test_gpio_interrupt_setup() {
+    isr_reset();
+
+    // B 相使用边沿触发的 GPIO 中断
+    CHECK_EQ(GPIO_IE, bIE_IO_EDGE | bIE_P3_1_LO);
+    CHECK_EQ(IE_GPIO, 1);
+
+    // 主循环同步时间戳时钟后恢复 A/B 相中断
+    EC11_UpdateStatus();
+    CHECK_EQ(EX1, 1);
+    CHECK_EQ(IE_GPIO, 1);
+}
+
+static void test_isr_decodes_detents() {
+    uint8_t cw, ccw;
+
+    isr_reset();
+
+    // 每齿到达中点时一次写入 STEP_PER_TEETH_DEFAULT 个事件
+    for (uint8_t detent = 0; detent < 3; detent++) {
+        for (uint8_t i = 0; i < 4; i++) {
+            isr_step(CW_DETENT[i]);
+            host_millis++;
+            EC11_UpdateStatus();
+        }
+    }
+
+    sim_drain(0, &cw, &ccw);
+    CHECK_EQ(cw, 3 * STEP_PER_TEETH_DEFAULT);
+    CHECK_EQ(ccw, 0);
+    CHECK_EQ(EC11_GetInvalidTransitions(0), 0);
+
+    for (uint8_t i = 0; i < 4; i++) {
+        isr_step(CCW_DETENT[i]);
+        EC11_UpdateStatus();
+    }
+
+    sim_drain(0, &cw, &ccw);
+    CHECK_EQ(cw, 0);
+    CHECK_EQ(ccw, STEP_PER_TEETH_DEFAULT);
+
+    // 到达中点之前反转回到静止状态，不计数
+    isr_step(CW_DETENT[0]);
+    isr_step(3);
+    sim_drain(0, &cw, &ccw);
+    CHECK_EQ(cw + ccw, 0);
+    CHECK_EQ(EC11_GetInvalidTransitions(0), 0);
+}
+
+/**
+ * @brief 主循环阻塞期间只由中断解码 detents 齿，之后取出全部事件
+ */
+static void stalled_turn(uint8_t step, const uint8_t *detent, uint8_t detents,
+                         uint8_t *cw, uint8_t *ccw) {
+    isr_reset();
+    EC11_SetStepPerTeeth(step);
+    EC11_UpdateStatus();
+
+    for (uint8_t n = 0; n < detents; n++) {
+        for (uint8_t i = 0; i < 4; i++) {
+            isr_step(detent[i]);
+        }
+    }
+
+    sim_drain(0, cw, ccw);
+}
+
+static void test_stalled_loop_loses_no_steps() {
+    static const uint8_t steps[] = {STEP_PER_TEETH_1X, STEP_PER_TEETH_2X,
+                                    STEP_PER_TEETH_4X};
+    // 4 倍时事件缓冲区能容纳的齿数
+    uint8_t detents = (EC11_EVENT_BUFFER_SIZE - 1) / STEP_PER_TEETH_4X;
+    uint8_t cw, ccw;
+
+    // 主循环不运行，每齿的事件数与方向都由中断得出
+    for (uint8_t s = 0; s < sizeof(steps); s++) {
+        stalled_turn(steps[s], CW_DETENT, detents, &cw, &ccw);
+        CHECK_EQ(cw, detents * steps[s]);
+        CHECK_EQ(ccw, 0);
+        CHECK_EQ(EC11_GetInvalidTransitions(0), 0);
+        CHECK_EQ(EC11_GetDroppedEvents(), 0);
+
+        stalled_turn(steps[s], CCW_DETENT, detents, &cw, &ccw);
+        CHECK_EQ(cw, 0);
+        CHECK_EQ(ccw, detents * steps[s]);
+        CHECK_EQ(EC11_GetInvalidTransitions(0), 0);
+    }
+}
+
+static void test_isr_rejects_invalid_transition() {
+    uint8_t cw, ccw;
+
+    isr_reset();
+
+    // A/B 同时下降，两个中断都无法判断方向
+    isr_step(0);
+    isr_step(3);
+
+    sim_drain(0, &cw, &ccw);
+    CHECK_EQ(cw + ccw, 0);
+    CHECK_EQ(EC11_GetInvalidTransitions(0), 2);
+
+    // 中点处 B 相抖动，同一齿只计数一次
+    isr_step(CW_DETENT[0]);
+    isr_step(CW_DETENT[1]);
+    isr_step(CW_DETENT[0]);
+    isr_step(CW_DETENT[1]);
+    isr_step(CW_DETENT[2]);
+    isr_step(CW_DETENT[3]);
+
+    sim_drain(0, &cw, &ccw);
+    CHECK_EQ(cw, STEP_PER_TEETH_DEFAULT);
+    CHECK_EQ(ccw, 0);
+    CHECK_EQ(EC11_GetInvalidTransitions(0), 3);
+
+    // 下降沿中断响应前该相已回到高电平
+    sim_set_ab(0, 3);
+    EC11_IsrA();
+    CHECK_EQ(EC11_GetInvalidTransitions(0), 4);
+}
+
+static void test_isr_does_not_call_millis() {
+    uint8_t index;
+
+    isr_reset();
+    EC11_SetStepPerTeeth(STEP_PER_TEETH_4X);
+
+    host_millis = 1000;
+    EC11_UpdateStatus();
+
+    // 主循环阻塞期间中断仍记录事件，时间戳为最近一次同步的时钟
+    host_millis = 1040;
+    uint32_t calls = millis_calls;
+    isr_step(CW_DETENT[0]);
+    isr_step(CW_DETENT[1]);
+    CHECK_EQ(millis_calls, calls);
+
+    CHECK_EQ(EC11_GetDirection(&index), EC11_DIR_CW);
+    CHECK_EQ(EC11_GetEventTime(0), 1000);
+}
+
+/**
+ * @brief 模拟定时器 2 溢出 ms 次，每次 1 毫秒
+ */
+static void tick_ms(uint16_t ms) {
+    for (uint16_t n = 0; n < ms; n++) {
+        TF2 = 1;
+        EC11_TimerInterrupt();
+    }
+}
+
+static void test_stalled_events_keep_their_time() {
+    static const uint8_t gain[ACCEL_CURVE_POINTS] = {4, 8, 16, 32};
+    uint8_t index;
+
+    isr_reset();
+    EC11_SetAccelCurve(gain);
+
+    // 定时器 2 每毫秒中断一次，只推进时钟
+    uint16_t reload = ((uint16_t)RCAP2H << 8) | RCAP2L;
+    CHECK_EQ(65536 - reload, F_CPU / 12 / 1000);
+    CHECK_EQ(ET2, 1);
+
+    host_millis = 2000;
+    EC11_UpdateStatus();
+
+    // 主循环阻塞期间每 300 毫秒转动一齿，时间戳按定时器推进
+    uint32_t calls = millis_calls;
+    for (uint8_t n = 1; n <= 4; n++) {
+        for (uint8_t i = 0; i < 4; i++) {
+            tick_ms(75);
+            isr_step(CW_DETENT[i]);
+        }
+    }
+    CHECK_EQ(millis_calls, calls);
+
+    // 慢速旋转分批取出时仍按实际间隔判断，不被加速
+    for (uint8_t n = 1; n <= 4; n++) {
+        for (uint8_t e = 0; e < STEP_PER_TEETH_DEFAULT; e++) {
+            CHECK_EQ(EC11_GetDirection(&index), EC11_DIR_CW);
+            CHECK_EQ(EC11_GetEventTime(0), 2000 + 300 * (n - 1) + 150);
+            CHECK_EQ(EC11_GetEventInterval(0), 0xFFFF);
+            CHECK_EQ(EC11_ApplyAccel(0, 10), 10);
+        }
+    }
+
+    // 快速旋转的间隔同样按实际时间计算
+    for (uint8_t n = 0; n < 2; n++) {
+        for (uint8_t i = 0; i < 4; i++) {
+            tick_ms(5);
+            isr_step(CW_DETENT[i]);
+        }
+    }
+    EC11_GetDirection(&index);
+    EC11_GetDirection(&index);
+    EC11_GetDirection(&index);
+    CHECK_EQ(EC11_GetEventInterval(0), 20);
+    CHECK(EC11_ApplyAccel(0, 10) > 10);
+}
+
+static void test_event_ring_order_and_overflow() {
+    uint8_t index;
+
+    isr_reset();
+    EC11_SetStepPerTeeth(STEP_PER_TEETH_1X);
+
+    // 交替正反转，每齿产生一个事件，共 EC11_EVENT_BUFFER_SIZE + 8 个
+    for (uint8_t n = 0; n < EC11_EVENT_BUFFER_SIZE + 8; n++) {
+        for (uint8_t i = 0; i < 4; i++) {
+            isr_step(n % 2 ? CCW_DETENT[i] : CW_DETENT[i]);
+        }
+    }
+
+    // 环形缓冲区保留一个空位，其余事件计入丢弃数
+    CHECK_EQ(EC11_GetDroppedEvents(), 9);
+
+    for (uint8_t n = 0; n < EC11_EVENT_BUFFER_SIZE - 1; n++) {
+        CHECK_EQ(EC11_GetDirection(&index), n % 2 ? EC11_DIR_CCW : EC11_DIR_CW);
+        CHECK_EQ(index, 0);
+    }
+    CHECK_EQ(EC11_GetDirection(&index), EC11_DIR_NONE);
+}
+
+static void test_key_latch_catches_short_press() {
+    isr_reset();
+
+    host_millis = 100;
+    EC11_UpdateStatus();
+
+    // 按键在两次主循环采样之间按下又释放
+    sim_set_key(0, true);
+    EC11_IsrKey();
+    sim_set_key(0, false);
+
+    host_millis = 101;
+    EC11_UpdateStatus();
+    CHECK_EQ(EC11_GetKeyState(0), EC11_KEY_PRESSED);
+    CHECK(EC11_IsKeyChanged(0));
+
+    for (uint8_t n = 0; n < EC11_KEY_DEBOUNCE_MS; n++) {
+        host_millis++;
+        EC11_UpdateStatus();
+    }
+    CHECK_EQ(EC11_GetKeyState(0), EC11_KEY_RELEASED);
+
+    // 释放抖动触发的锁存在保护时间内被忽略
+    EC11_IsrKey();
+    host_millis++;
+    EC11_UpdateStatus();
+    CHECK_EQ(EC11_GetKeyState(0), EC11_KEY_RELEASED);
+}
+
+int main() {
+    RUN(test_gpio_interrupt_setup);
+    RUN(test_isr_decodes_detents);
+    RUN(test_stalled_loop_loses_no_steps);
+    RUN(test_isr_rejects_invalid_transition);
+    RUN(test_isr_does_not_call_millis);
+    RUN(test_stalled_events_keep_their_time);
+    RUN(test_event_ring_order_and_overflow);
+    RUN(test_key_latch_catches_short_press);
+    return TEST_RESULT();
+}
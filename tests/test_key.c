@@ -0,0 +1,180 @@
+/*
+  按键消抖与手势识别主机测试
+
+  通过 EC11_CLOCK 注入模拟时钟，按毫秒回放按键电平，检查积分消抖、
+  单击、双击、长按识别，以及主循环阻塞与时钟回绕时的行为
+*/
+#include <stdint.h>
+
+static uint32_t fake_now;
+#define EC11_CLOCK() fake_now
+
+#include "../src/Drivers/EC11.c"
+#include "ec11_sim.h"
+#include "test.h"
+
+// 回放期间观察到的按键边沿与手势
+static uint8_t presses;
+static uint8_t releases;
+static uint8_t gestures[EC11_GESTURE_LONG_PRESS + 1];
+
+static void key_reset(uint32_t start) {
+    sim_reset();
+    fake_now = start;
+    EC11_Init();
+
+    presses = 0;
+    releases = 0;
+    memset(gestures, 0, sizeof(gestures));
+}
+
+static void sample(bool pressed) {
+    sim_set_key(0, pressed);
+    EC11_UpdateStatus();
+
+    if (EC11_IsKeyChanged(0)) {
+        if (EC11_GetKeyState(0) == EC11_KEY_PRESSED) {
+            presses++;
+        } else {
+            releases++;
+        }
+    }
+
+    gestures[EC11_GetKeyGesture(0)]++;
+}
+
+/**
+ * @brief 保持按键电平 ms 毫秒，主循环每毫秒采样一次
+ */
+static void hold(bool pressed, uint16_t ms) {
+    for (uint16_t n = 0; n < ms; n++) {
+        fake_now++;
+        sample(pressed);
+    }
+}
+
+static uint16_t gesture_count() {
+    return gestures[EC11_GESTURE_CLICK] + gestures[EC11_GESTURE_DOUBLE_CLICK] +
+           gestures[EC11_GESTURE_LONG_PRESS];
+}
+
+static void test_bounce_rejected() {
+    key_reset(0);
+
+    // 触点每毫秒抖动一次，积分值无法累积到阈值
+    for (uint8_t n = 0; n < 20; n++) {
+        hold(n % 2 == 0, 1);
+    }
+    CHECK_EQ(presses, 0);
+
+    // 稳定低电平达到消抖时长后只判定一次按下
+    hold(true, EC11_KEY_DEBOUNCE_MS - 1);
+    CHECK_EQ(presses, 0);
+    hold(true, 1);
+    CHECK_EQ(presses, 1);
+    hold(true, 20);
+    CHECK_EQ(presses, 1);
+
+    // 释放时的抖动同样被滤除，积分值回落到 0 才判定释放
+    for (uint8_t n = 0; n < 6; n++) {
+        hold(n % 2 == 1, 1);
+    }
+    CHECK_EQ(releases, 0);
+    hold(false, EC11_KEY_DEBOUNCE_MS);
+    CHECK_EQ(releases, 1);
+    CHECK_EQ(presses, 1);
+}
+
+static void test_injected_clock() {
+    key_reset(0);
+
+    uint32_t calls = millis_calls;
+    hold(true, 30);
+    CHECK_EQ(millis_calls, calls);
+}
+
+static void test_stalled_loop() {
+    key_reset(0);
+
+    // 主循环阻塞 50 毫秒后的一次采样即按经过的时间积分
+    fake_now += 50;
+    sample(true);
+    CHECK_EQ(presses, 1);
+
+    fake_now += 50;
+    sample(false);
+    CHECK_EQ(releases, 1);
+}
+
+static void test_click() {
+    key_reset(0);
+
+    hold(true, 60);
+    hold(false, EC11_KEY_DOUBLE_CLICK_MS - 20);
+    CHECK_EQ(gesture_count(), 0);
+
+    hold(false, 40);
+    CHECK_EQ(gestures[EC11_GESTURE_CLICK], 1);
+    CHECK_EQ(gesture_count(), 1);
+
+    // 手势只取出一次
+    CHECK_EQ(EC11_GetKeyGesture(0), EC11_GESTURE_NONE);
+}
+
+static void test_double_click() {
+    key_reset(0);
+
+    hold(true, 40);
+    hold(false, 80);
+    hold(true, 40);
+    hold(false, 300);
+
+    CHECK_EQ(gestures[EC11_GESTURE_DOUBLE_CLICK], 1);
+    CHECK_EQ(gesture_count(), 1);
+}
+
+static void test_long_press() {
+    key_reset(0);
+
+    hold(true, EC11_KEY_LONG_PRESS_MS);
+    CHECK_EQ(gesture_count(), 0);
+    hold(true, 20);
+    CHECK_EQ(gestures[EC11_GESTURE_LONG_PRESS], 1);
+
+    // 长按后继续按住与释放都不再产生手势
+    hold(true, 1000);
+    hold(false, 500);
+    CHECK_EQ(gesture_count(), 1);
+
+    // 双击的第二次按下保持过久同样判定为长按
+    key_reset(0);
+    hold(true, 40);
+    hold(false, 80);
+    hold(true, EC11_KEY_LONG_PRESS_MS + 20);
+    hold(false, 500);
+    CHECK_EQ(gestures[EC11_GESTURE_LONG_PRESS], 1);
+    CHECK_EQ(gesture_count(), 1);
+}
+
+static void test_clock_wraparound() {
+    key_reset(UINT32_MAX - 100);
+
+    hold(true, 60);
+    hold(false, 300);
+
+    CHECK_EQ(presses, 1);
+    CHECK_EQ(releases, 1);
+    CHECK_EQ(gestures[EC11_GESTURE_CLICK], 1);
+    CHECK_EQ(gesture_count(), 1);
+}
+
+int main() {
+    RUN(test_bounce_rejected);
+    RUN(test_injected_clock);
+    RUN(test_stalled_loop);
+    RUN(test_click);
+    RUN(test_double_click);
+    RUN(test_long_press);
+    RUN(test_clock_wraparound);
+    return TEST_RESULT();
+}
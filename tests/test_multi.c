@@ -0,0 +1,139 @@
+/*
+  多编码器主机测试
+
+  以 4 个编码器编译驱动（P3 与 P1 各 2 个），检查每次采样两个端口各只读取
+  一次，以及同一次快照中多个编码器的旋转、非法跳变与按键互不干扰
+*/
+#include <Arduino.h>
+
+static uint8_t port1 = 0xFF;
+static uint8_t port3 = 0xFF;
+static uint16_t p1_reads;
+static uint16_t p3_reads;
+
+#define P1 (p1_reads++, port1)
+#define P3 (p3_reads++, port3)
+#define SIM_P1 port1
+#define SIM_P3 port3
+
+#include "../src/Drivers/EC11.c"
+#include "ec11_sim.h"
+#include "test.h"
+
+static void test_one_read_per_port() {
+    sim_reset();
+
+    p1_reads = 0;
+    p3_reads = 0;
+    for (uint8_t n = 0; n < 10; n++) {
+        EC11_UpdateStatus();
+    }
+
+    CHECK_EQ(p1_reads, 10);
+    CHECK_EQ(p3_reads, 10);
+}
+
+static void test_pin_map() {
+    CHECK_EQ(EC11_MAP_PORT(0), EC11_PORT_P3);
+    CHECK_EQ(EC11_MAP_PORT(1), EC11_PORT_P3);
+    CHECK_EQ(EC11_MAP_PORT(2), EC11_PORT_P1);
+    CHECK_EQ(EC11_MAP_PORT(3), EC11_PORT_P1);
+    CHECK_EQ(EC11_MAP_MASK_A(1), 1 << (EC11_2_PIN_A % 10));
+    CHECK_EQ(EC11_MAP_MASK_K(3), 1 << (EC11_4_PIN_K % 10));
+}
+
+static void test_simultaneous_rotation() {
+    uint8_t cw[EC11_COUNT] = {0};
+    uint8_t ccw[EC11_COUNT] = {0};
+    uint8_t index;
+    ec11_direction_t direction;
+
+    sim_reset();
+    EC11_SetStepPerTeeth(STEP_PER_TEETH_1X);
+
+    // 同一端口与不同端口上的编码器在同一次快照中同时转动
+    for (uint8_t n = 0; n < 3; n++) {
+        for (uint8_t i = 0; i < 4; i++) {
+            sim_set_ab(0, CW_DETENT[i]);
+            sim_set_ab(1, CCW_DETENT[i]);
+            sim_set_ab(2, CW_DETENT[i]);
+            if (n < 2) {
+                sim_set_ab(3, CCW_DETENT[i]);
+            }
+            host_millis++;
+            EC11_UpdateStatus();
+        }
+    }
+
+    while ((direction = EC11_GetDirection(&index)) != EC11_DIR_NONE) {
+        CHECK(index < EC11_COUNT);
+        if (direction == EC11_DIR_CW) {
+            cw[index]++;
+        } else {
+            ccw[index]++;
+        }
+    }
+
+    CHECK_EQ(cw[0], 3);
+    CHECK_EQ(ccw[0], 0);
+    CHECK_EQ(cw[1], 0);
+    CHECK_EQ(ccw[1], 3);
+    CHECK_EQ(cw[2], 3);
+    CHECK_EQ(ccw[2], 0);
+    CHECK_EQ(cw[3], 0);
+    CHECK_EQ(ccw[3], 2);
+
+    for (uint8_t i = 0; i < EC11_COUNT; i++) {
+        CHECK_EQ(EC11_GetInvalidTransitions(i), 0);
+    }
+}
+
+static void test_per_encoder_state() {
+    uint8_t index;
+
+    sim_reset();
+    EC11_SetStepPerTeeth(STEP_PER_TEETH_4X);
+
+    // 只有第 3 个编码器发生非法跳变，只有第 4 个编码器按下按键
+    sim_set_ab(2, 0);
+    sim_set_key(3, true);
+    for (uint8_t n = 0; n < EC11_KEY_DEBOUNCE_MS; n++) {
+        host_millis++;
+        EC11_UpdateStatus();
+    }
+
+    CHECK_EQ(EC11_GetDirection(&index), EC11_DIR_NONE);
+    for (uint8_t i = 0; i < EC11_COUNT; i++) {
+        CHECK_EQ(EC11_GetInvalidTransitions(i), i == 2 ? 1 : 0);
+        CHECK_EQ(EC11_GetKeyState(i),
+                 i == 3 ? EC11_KEY_PRESSED : EC11_KEY_RELEASED);
+    }
+
+    // 各编码器的事件间隔分别计算
+    host_millis = 1000;
+    sim_set_ab(0, CW_DETENT[0]);
+    EC11_UpdateStatus();
+    host_millis = 1030;
+    sim_set_ab(1, CW_DETENT[0]);
+    EC11_UpdateStatus();
+    host_millis = 1050;
+    sim_set_ab(0, CW_DETENT[1]);
+    EC11_UpdateStatus();
+
+    CHECK_EQ(EC11_GetDirection(&index), EC11_DIR_CW);
+    CHECK_EQ(index, 0);
+    CHECK_EQ(EC11_GetDirection(&index), EC11_DIR_CW);
+    CHECK_EQ(index, 1);
+    CHECK_EQ(EC11_GetEventInterval(1), 0xFFFF);
+    CHECK_EQ(EC11_GetDirection(&index), EC11_DIR_CW);
+    CHECK_EQ(index, 0);
+    CHECK_EQ(EC11_GetEventInterval(0), 50);
+}
+
+int main() {
+    RUN(test_one_read_per_port);
+    RUN(test_pin_map);
+    RUN(test_simultaneous_rotation);
+    RUN(test_per_encoder_state);
+    return TEST_RESULT();
+}
@@ -0,0 +1,82 @@
+/*
+  端口快照采样主机测试
+
+  将 P1/P3 替换为计数读取次数的表达式，检查单个编码器每次采样只读取一次
+  所在端口、不读取未使用的端口，且同一端口上其他引脚的电平变化不影响解码
+*/
+#include <Arduino.h>
+
+static uint8_t port1 = 0xFF;
+static uint8_t port3 = 0xFF;
+static uint16_t p1_reads;
+static uint16_t p3_reads;
+
+#define P1 (p1_reads++, port1)
+#define P3 (p3_reads++, port3)
+#define SIM_P1 port1
+#define SIM_P3 port3
+
+#include "../src/Drivers/EC11.c"
+#include "ec11_sim.h"
+#include "test.h"
+
+// 编码器所在端口上不属于编码器的引脚
+#define OTHER_PINS                                                             \
+    ((uint8_t)~(EC11_PIN_MASK(EC11_PIN_A) | EC11_PIN_MASK(EC11_PIN_B) |        \
+                EC11_PIN_MASK(EC11_PIN_K)))
+
+static void test_single_read_per_sample() {
+    sim_reset();
+
+    p1_reads = 0;
+    p3_reads = 0;
+    for (uint8_t n = 0; n < 10; n++) {
+        EC11_UpdateStatus();
+    }
+
+    CHECK_EQ(p3_reads, 10);
+    CHECK_EQ(p1_reads, 0);
+}
+
+static void test_other_pins_ignored() {
+    uint8_t cw, ccw;
+
+    sim_reset();
+    EC11_SetStepPerTeeth(STEP_PER_TEETH_4X);
+
+    // 其他引脚与另一个端口任意翻转
+    for (uint16_t n = 0; n < 256; n++) {
+        port3 = (port3 & ~OTHER_PINS) | ((uint8_t)n & OTHER_PINS);
+        port1 = (uint8_t)(n * 37);
+        host_millis++;
+        EC11_UpdateStatus();
+    }
+
+    sim_drain(0, &cw, &ccw);
+    CHECK_EQ(cw + ccw, 0);
+    CHECK_EQ(EC11_GetInvalidTransitions(0), 0);
+    CHECK_EQ(EC11_GetKeyState(0), EC11_KEY_RELEASED);
+
+    // 其他引脚全部为低电平时正常解码
+    port3 &= ~OTHER_PINS;
+    for (uint8_t i = 0; i < 4; i++) {
+        sim_set_ab(0, CW_DETENT[i]);
+        EC11_UpdateStatus();
+    }
+    sim_set_key(0, true);
+    for (uint8_t n = 0; n < EC11_KEY_DEBOUNCE_MS; n++) {
+        host_millis++;
+        EC11_UpdateStatus();
+    }
+
+    sim_drain(0, &cw, &ccw);
+    CHECK_EQ(cw, 4);
+    CHECK_EQ(ccw, 0);
+    CHECK_EQ(EC11_GetKeyState(0), EC11_KEY_PRESSED);
+}
+
+int main() {
+    RUN(test_single_read_per_sample);
+    RUN(test_other_pins_ignored);
+    return TEST_RESULT();
+}
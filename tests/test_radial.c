@@ -0,0 +1,427 @@
+/*
+  径向控制器报告主机测试
+
+  经由 USB 设备模拟运行报告队列与端点3 中断，主机按描述符间隔轮询，
+  检查 Radial_SendData 不阻塞、旋转量不丢失且单个报告不超出逻辑范围，
+  按钮边沿保持先后顺序，队列满时合并报告而不丢失按钮最终状态；
+  配置描述符按设置的轮询间隔生成，输入延迟统计与主机实际轮询一致；
+  测得主机轮询相位后只在轮询前一帧装入报告。
+  以 4 个旋钮编译，覆盖各旋钮独立的报告 ID
+*/
+#include "usb_sim.h"
+#include "test.h"
+
+#include <stdlib.h>
+
+/**
+ * @brief 检查主机收到的每个报告的旋转量都在描述符逻辑范围内
+ */
+static void check_report_range() {
+    for (uint16_t i = 0; i < sim_report_count; i++) {
+        int16_t delta = (int16_t)(sim_report_value[i] & RADIAL_DIAL_MASK);
+
+        CHECK(delta <= RADIAL_DIAL_LOGICAL_MAX);
+        CHECK(delta >= -RADIAL_DIAL_LOGICAL_MAX);
+    }
+}
+
+static void test_not_configured() {
+    usb_sim_reset();
+
+    CHECK(!Radial_SendData(0, 0, 10));
+    CHECK_EQ(Radial_GetLastError(), HID_ERR_USB_NOT_CONFIGURED);
+    CHECK(!Radial_SendData(RADIAL_DIAL_COUNT, 0, 10));
+    CHECK_EQ(Radial_GetLastError(), HID_ERR_INVALID_PARAM);
+}
+
+static void test_burst_coalesced() {
+    usb_sim_reset();
+    usb_enumerate();
+
+    // 同一帧内 100 个 10 度的旋转，端点忙时全部并入同一个报告
+    for (uint8_t i = 0; i < 100; i++) {
+        CHECK(Radial_SendData(0, 0, 10));
+    }
+    CHECK(Radial_GetQueueDepth() <= 1);
+
+    usb_drain_reports(1000);
+    CHECK_EQ(sim_dial_total[0], 100 * 10 * 10);
+    CHECK_EQ(Radial_GetQueueDepth(), 0);
+    CHECK(sim_report_count <= 5);
+    check_report_range();
+}
+
+static void test_degree_clamped() {
+    usb_sim_reset();
+    usb_enumerate();
+
+    CHECK(Radial_SendData(0, 0, 1000));
+    CHECK(Radial_SendData(0, 0, -1000));
+    CHECK(Radial_SendData(0, 0, 5));
+    usb_drain_reports(1000);
+    CHECK_EQ(sim_dial_total[0], 50);
+}
+
+static void test_random_spin_no_loss() {
+    int32_t expected = 0;
+
+    usb_sim_reset();
+    usb_enumerate();
+    srand(8);
+
+    // 每帧随机 0~3 个正反向旋转，报告数受主机轮询周期限制，总量不变
+    for (uint16_t frame = 0; frame < 2000; frame++) {
+        uint8_t steps = rand() % 4;
+
+        for (uint8_t i = 0; i < steps; i++) {
+            int16_t degree = rand() % 2 ? 15 : -15;
+
+            CHECK(Radial_SendData(0, 0, degree));
+            expected += degree * 10;
+        }
+        usb_frame();
+    }
+    usb_drain_reports(1000);
+
+    CHECK_EQ(sim_dial_total[0], expected);
+    CHECK(sim_report_count <= 2000 / sim_poll_period + 2);
+    CHECK_EQ(Radial_GetQueueOverflow(), 0);
+    check_report_range();
+}
+
+/**
+ * @brief 统计主机收到的某个旋钮的按下次数
+ */
+static uint16_t count_presses(uint8_t dial) {
+    uint16_t presses = 0;
+    uint8_t button = 0;
+
+    for (uint16_t i = 0; i < sim_report_count; i++) {
+        if (sim_report_id[i] != RADIAL_REPORT_ID + dial) {
+            continue;
+        }
+        if ((sim_report_value[i] & RADIAL_BUTTON_MASK) && !button) {
+            presses++;
+        }
+        button = sim_report_value[i] & RADIAL_BUTTON_MASK;
+    }
+    return presses;
+}
+
+static void test_button_edges_ordered() {
+    usb_sim_reset();
+    usb_enumerate();
+
+    // 同一轮询周期内按下、旋转、释放、旋转，按钮边沿不与旋转合并
+    CHECK(Radial_SendData(0, 1, 0));
+    CHECK(Radial_SendData(0, 1, 10));
+    CHECK(Radial_SendData(0, 0, 0));
+    CHECK(Radial_SendData(0, 0, 10));
+    CHECK_EQ(Radial_GetQueueDepth(), 2);
+    usb_drain_reports(100);
+
+    CHECK_EQ(sim_report_count, 3);
+    CHECK_EQ(sim_report_value[0], RADIAL_BUTTON_MASK);
+    CHECK_EQ(sim_report_value[1], 100 | RADIAL_BUTTON_MASK);
+    CHECK_EQ(sim_report_value[2], 100);
+    CHECK_EQ(sim_dial_total[0], 200);
+    CHECK_EQ(sim_button[0], 0);
+}
+
+static void test_clicks_in_one_window() {
+    usb_sim_reset();
+    usb_enumerate();
+
+    // 3 次单击在主机两次轮询之间完成，主机依次收到 3 次按下与释放
+    for (uint8_t i = 0; i < 3; i++) {
+        CHECK(Radial_SendData(0, 1, 0));
+        CHECK(Radial_SendData(0, 0, 0));
+    }
+    usb_drain_reports(200);
+
+    CHECK_EQ(count_presses(0), 3);
+    CHECK_EQ(sim_report_count, 6);
+    CHECK_EQ(sim_button[0], 0);
+    CHECK_EQ(Radial_GetQueueMaxDepth(), 5);
+}
+
+static void test_full_queue_compacted() {
+    usb_sim_reset();
+    usb_enumerate();
+
+    // 20 次带旋转的单击超出队列长度，相邻的按下与释放合并，旋转量不丢失
+    for (uint8_t i = 0; i < 20; i++) {
+        CHECK(Radial_SendData(0, 1, 10));
+        CHECK(Radial_SendData(0, 0, -5));
+    }
+    // 合并一对按下与释放腾出两个位置，队列保持接近满
+    CHECK(Radial_GetQueueDepth() >= RADIAL_QUEUE_SIZE - 1);
+    CHECK_EQ(Radial_GetQueueMaxDepth(), RADIAL_QUEUE_SIZE);
+    usb_drain_reports(1000);
+
+    CHECK_EQ(Radial_GetQueueOverflow(), 0);
+    CHECK_EQ(sim_dial_total[0], 20 * (100 - 50));
+    CHECK_EQ(sim_button[0], 0);
+    CHECK(count_presses(0) >= RADIAL_QUEUE_SIZE / 2);
+}
+
+static void test_full_queue_overflow() {
+    usb_sim_reset();
+    usb_enumerate();
+
+    // 队列中全部为各旋钮唯一的按钮边沿，无法合并时丢弃新报告并计数
+    CHECK(Radial_SendData(0, 1, 0)); // 立即装入端点3
+    for (uint8_t dial = 1; dial < RADIAL_DIAL_COUNT; dial++) {
+        CHECK(Radial_SendData(dial, 1, 0));
+    }
+    for (uint8_t dial = 0; dial < RADIAL_DIAL_COUNT; dial++) {
+        CHECK(Radial_SendData(dial, 0, 0));
+    }
+    CHECK(Radial_SendData(0, 1, 0));
+    CHECK_EQ(Radial_GetQueueDepth(), RADIAL_QUEUE_SIZE);
+
+    CHECK(!Radial_SendData(1, 1, 0));
+    CHECK_EQ(Radial_GetLastError(), HID_ERR_BUFFER_BUSY);
+    CHECK_EQ(Radial_GetQueueOverflow(), 1);
+
+    // 被丢弃的按下不改变该旋钮的入队按钮状态，之后的释放被当作旋转合并
+    CHECK(Radial_SendData(1, 0, 10));
+    CHECK_EQ(Radial_GetQueueOverflow(), 1);
+    usb_drain_reports(1000);
+
+    for (uint8_t dial = 0; dial < RADIAL_DIAL_COUNT; dial++) {
+        CHECK_EQ(count_presses(dial), dial == 0 ? 2 : 1);
+    }
+    CHECK_EQ(sim_button[0], 1);
+    CHECK_EQ(sim_button[1], 0);
+    CHECK_EQ(sim_dial_total[1], 100);
+    CHECK_EQ(Radial_GetQueueDepth(), 0);
+}
+
+static void test_poll_interval_option() {
+    CHECK_EQ(EEPROM_Reset(), EEPROM_STATUS_OK);
+    CHECK_EQ(EEPROM_GetHidPollInterval(), HID_POLL_INTERVAL_DEFAULT);
+    CHECK_EQ(EEPROM_SetHidPollInterval(3), EEPROM_STATUS_INVALID_PARAM);
+    CHECK_EQ(EEPROM_SetHidPollInterval(HID_POLL_INTERVAL_2MS),
+             EEPROM_STATUS_OK);
+    CHECK_EQ(EEPROM_GetHidPollInterval(), HID_POLL_INTERVAL_2MS);
+
+    // 0 表示使用编译时默认值
+    EEPROM_GetConfigData()->hid_poll_interval = 0;
+    CHECK_EQ(EEPROM_Validate(), EEPROM_STATUS_OK);
+    CHECK_EQ(EEPROM_GetHidPollInterval(), HID_POLL_INTERVAL_DEFAULT);
+}
+
+static void test_descriptor_interval() {
+    static const uint8_t intervals[] = {1, 2, 4, 8, 10};
+    static const uint8_t periods[] = {1, 2, 4, 8, 8};
+
+    for (uint8_t i = 0; i < sizeof(intervals); i++) {
+        usb_sim_reset();
+        Radial_SetPollInterval(intervals[i]);
+
+        CHECK_EQ(usb_enumerate(), intervals[i]);
+        CHECK_EQ(sim_poll_period, periods[i]);
+        CHECK_EQ(pollPeriod, periods[i]);
+    }
+}
+
+/**
+ * @brief 在随机时刻产生 count 次单齿旋转，返回输入延迟统计
+ * @param interval HID 端点轮询间隔（毫秒）
+ */
+static RadialLatencyStats measure_latency(uint8_t interval, uint16_t count) {
+    RadialLatencyStats stats;
+
+    usb_sim_reset();
+    Radial_SetPollInterval(interval);
+    usb_enumerate();
+    srand(interval);
+
+    for (uint16_t n = 0; n < count; n++) {
+        usb_frames(rand() % 20);
+        Radial_SetInputTime((uint16_t)host_millis);
+        CHECK(Radial_SendData(0, 0, 10));
+        usb_drain_reports(100);
+    }
+
+    Radial_TakeLatencyStats(&stats);
+    return stats;
+}
+
+static void test_latency_stats() {
+    RadialLatencyStats slow = measure_latency(HID_POLL_INTERVAL_10MS, 200);
+    RadialLatencyStats fast = measure_latency(HID_POLL_INTERVAL_1MS, 200);
+
+    // 延迟不超过一个实际轮询周期
+    CHECK_EQ(slow.count, 200);
+    CHECK(slow.max <= 8);
+    CHECK(slow.min <= slow.average && slow.average <= slow.max);
+    CHECK_EQ(fast.count, 200);
+    CHECK(fast.max <= 1);
+    CHECK(fast.average < slow.average);
+
+    // 读取后清零
+    Radial_TakeLatencyStats(&fast);
+    CHECK_EQ(fast.count, 0);
+    CHECK_EQ(fast.min, 0);
+    CHECK_EQ(fast.max, 0);
+}
+
+static void test_latency_keeps_earliest_input() {
+    RadialLatencyStats stats;
+
+    usb_sim_reset();
+    Radial_SetPollInterval(HID_POLL_INTERVAL_8MS);
+    usb_enumerate();
+
+    // 端点忙时合并的旋转按最早的输入时间统计，未设置时间戳的旋转不计入
+    CHECK(Radial_SendData(0, 0, 10));
+    usb_frame();
+    Radial_SetInputTime((uint16_t)host_millis);
+    CHECK(Radial_SendData(0, 0, 10));
+    usb_frame();
+    Radial_SetInputTime((uint16_t)host_millis);
+    CHECK(Radial_SendData(0, 0, 10));
+    usb_drain_reports(100);
+
+    Radial_TakeLatencyStats(&stats);
+    CHECK_EQ(stats.count, 1);
+    CHECK(stats.max >= 1);
+}
+
+/**
+ * @brief 发送一个报告并运行到主机取走，使设备测得轮询相位
+ */
+static void learn_poll_phase() {
+    CHECK(Radial_SendData(0, 0, 10));
+    usb_drain_reports(100);
+    CHECK(pollPhaseValid);
+    CHECK_EQ(pollPhase, sim_poll_phase);
+}
+
+static void test_arm_before_poll() {
+    usb_sim_reset();
+    usb_enumerate();
+    learn_poll_phase();
+
+    // 之后的报告在主机轮询前一帧才装入端点3
+    for (uint16_t frame = 0; frame < 64; frame++) {
+        bool arm_frame =
+            ((sim_frame + 1) & (sim_poll_period - 1)) == sim_poll_phase;
+
+        CHECK(Radial_SendData(0, 0, 10));
+        CHECK_EQ(usb_in_armed(UEP3_CTRL), arm_frame);
+        usb_frame();
+    }
+    usb_drain_reports(100);
+
+    // 每个报告都在预期相位被取走，并包含之前一个周期内的全部旋转
+    for (uint16_t i = 1; i < sim_report_count; i++) {
+        CHECK_EQ(sim_report_frame[i] & (sim_poll_period - 1), sim_poll_phase);
+    }
+    CHECK_EQ(sim_dial_total[0], 65 * 100);
+    CHECK(sim_report_count <= 64 / 8 + 2);
+}
+
+static void test_fresh_data_merged() {
+    usb_sim_reset();
+    usb_enumerate();
+    learn_poll_phase();
+
+    // 距下次轮询 3 帧与 2 帧时的旋转合并为同一个报告
+    while (((sim_frame + 3) & (sim_poll_period - 1)) != sim_poll_phase) {
+        usb_frame();
+    }
+    uint16_t before = sim_report_count;
+
+    CHECK(Radial_SendData(0, 0, 10));
+    usb_frame();
+    CHECK(!usb_in_armed(UEP3_CTRL));
+    CHECK(Radial_SendData(0, 0, 20));
+    usb_frame();
+    CHECK(usb_in_armed(UEP3_CTRL));
+    usb_frame();
+
+    CHECK_EQ(sim_report_count, before + 1);
+    CHECK_EQ(sim_report_value[before], 300);
+}
+
+static void test_poll_stats() {
+    RadialPollStats stats;
+
+    usb_sim_reset();
+    usb_enumerate();
+    learn_poll_phase();
+
+    for (uint8_t n = 0; n < 20; n++) {
+        usb_frames(sim_poll_period);
+        Radial_SetInputTime((uint16_t)host_millis);
+        CHECK(Radial_SendData(0, 0, 10));
+    }
+    usb_drain_reports(100);
+
+    Radial_TakePollStats(&stats);
+    CHECK_EQ(stats.period, sim_poll_period);
+    CHECK_EQ(stats.phase, sim_poll_phase);
+    CHECK_EQ(stats.hits, 20);
+    CHECK_EQ(stats.misses, 1); // 测得相位前的第一个报告
+
+    // 输入时刻与轮询相位固定，全部落在同一时效档
+    uint16_t total = 0;
+    uint8_t used = 0;
+    for (uint8_t i = 0; i < RADIAL_AGE_BINS; i++) {
+        total += stats.ageHistogram[i];
+        used += stats.ageHistogram[i] != 0;
+    }
+    CHECK_EQ(total, 20);
+    CHECK_EQ(used, 1);
+
+    Radial_TakePollStats(&stats);
+    CHECK_EQ(stats.hits, 0);
+    CHECK_EQ(stats.ageHistogram[0] + stats.ageHistogram[7], 0);
+}
+
+static void test_period_latched_on_configuration() {
+    usb_sim_reset();
+    usb_enumerate();
+    learn_poll_phase();
+
+    // 修改间隔不影响主机当前的轮询，相位保持有效
+    Radial_SetPollInterval(HID_POLL_INTERVAL_1MS);
+    CHECK_EQ(pollPeriod, 8);
+    CHECK(pollPhaseValid);
+
+    // 未读取配置描述符就设置配置时沿用上次发送的间隔
+    usb_configure();
+    CHECK_EQ(pollPeriod, 8);
+    CHECK(!pollPhaseValid);
+
+    // 重新枚举后按新间隔轮询，总线复位清除相位
+    usb_bus_reset();
+    CHECK_EQ(usb_enumerate(), HID_POLL_INTERVAL_1MS);
+    CHECK_EQ(pollPeriod, 1);
+    learn_poll_phase();
+    usb_bus_reset();
+    CHECK(!pollPhaseValid);
+}
+
+int main() {
+    RUN(test_not_configured);
+    RUN(test_burst_coalesced);
+    RUN(test_degree_clamped);
+    RUN(test_random_spin_no_loss);
+    RUN(test_button_edges_ordered);
+    RUN(test_clicks_in_one_window);
+    RUN(test_full_queue_compacted);
+    RUN(test_full_queue_overflow);
+    RUN(test_poll_interval_option);
+    RUN(test_descriptor_interval);
+    RUN(test_latency_stats);
+    RUN(test_latency_keeps_earliest_input);
+    RUN(test_arm_before_poll);
+    RUN(test_fresh_data_merged);
+    RUN(test_poll_stats);
+    RUN(test_period_latched_on_configuration);
+    return TEST_RESULT();
+}
@@ -0,0 +1,568 @@
+/*
+  主程序串口命令主机测试
+
+  在主机上编译 Radial-Controller.ino，检查按字节推进的命令接收状态机与
+  命令表：命令表中的每条命令都能按名称找到，文本命令以换行符或回车符
+  结束，save_settings= 之后按定长接收可含换行符的二进制数据，过长的
+  命令丢弃至换行符，未知命令不作应答；set_/get_ 单项参数命令只应用受影响
+  的模块，EEPROM 在无新修改一段时间后才写入；一次主循环在时间预算内执行
+  接收 FIFO 中的全部完整命令；配置模式在主机关闭串口、拔出或挂起时立即
+  退出，未设置 DTR 的主机按心跳超时退出；修改、保存配置与命令失败时经
+  端点1 通知主机；配置模式下转动编码器的每一齿都以 HID 报告发送；
+  预览模式只能在配置模式下进入，主机离开时恢复已保存的配置；commit 报告
+  本次调节实际写入的字节数，revert 恢复已保存的配置
+*/
+#include "sketch_sim.h"
+#include "ec11_sim.h"
+#include "test.h"
+
+/**
+ * @brief 逐字节送入接收状态机
+ * @return 收到的完整命令数量
+ */
+static uint8_t feed(const uint8_t *data, uint16_t len) {
+    uint8_t commands = 0;
+
+    for (uint16_t i = 0; i < len; i++) {
+        if (receive_byte(data[i])) {
+            commands++;
+            receive_ptr = 0;
+        }
+    }
+    return commands;
+}
+
+static uint8_t feed_text(const char *text) {
+    return feed((const uint8_t *)text, strlen(text));
+}
+
+/**
+ * @brief 生成 save_settings= 命令，配置数据取自当前配置
+ * @return 命令长度
+ */
+static uint8_t make_save_command(uint8_t *buf) {
+    uint8_t prefix = sizeof(CMD_CONFIG_SAVE_SETTINGS_PREFIX) - 1;
+
+    memcpy(buf, CMD_CONFIG_SAVE_SETTINGS_PREFIX, prefix);
+    memcpy(buf + prefix, (uint8_t *)EEPROM_GetConfigData() + 2,
+           CMD_CONFIG_SAVE_SETTINGS_PAYLOAD);
+    buf[prefix + CMD_CONFIG_SAVE_SETTINGS_PAYLOAD] = '\n';
+    return prefix + CMD_CONFIG_SAVE_SETTINGS_PAYLOAD + 1;
+}
+
+static void open_port() {
+    sketch_reset();
+    usb_enumerate();
+    usb_cdc_line_state(CDC_LINE_STATE_DTR);
+    USBSerial_takeHostLost();
+}
+
+static void test_every_command_found() {
+    sketch_reset();
+
+    for (uint8_t i = 0; i < COMMAND_COUNT; i++) {
+        __code command_entry_t *entry = &command_table[i];
+        uint8_t length = entry->length;
+
+        CHECK_EQ(length, strlen(entry->name));
+        memcpy(receive_buf, entry->name, length);
+
+        // 前缀命令需要前缀之后还有内容
+        if (entry->payload == COMMAND_PREFIX) {
+            CHECK(find_command(length) == NULL);
+            receive_buf[length++] = 'x';
+        }
+        CHECK(find_command(length) == entry);
+    }
+
+    // 名称相同前缀的较长或较短名称不会误匹配
+    memcpy(receive_buf, "heartbeats", 10);
+    CHECK(find_command(10) == NULL);
+    CHECK(find_command(8) == NULL);
+    memcpy(receive_buf, "rotate_lef", 10);
+    CHECK(find_command(10) == NULL);
+}
+
+static void test_text_command_per_byte() {
+    const char *text = "latency\n";
+
+    sketch_reset();
+
+    // 只有结束符完成命令，命令表条目在此时确定
+    for (uint8_t i = 0; text[i] != '\0'; i++) {
+        CHECK_EQ(receive_byte(text[i]), text[i] == '\n');
+    }
+    CHECK(receive_command != NULL);
+    CHECK_EQ(strcmp(receive_command->name, CMD_TEST_LATENCY), 0);
+
+    // 回车换行与空行不产生空命令
+    receive_ptr = 0;
+    CHECK_EQ(feed_text("heartbeat\r\n\n\rload_settings\r\n"), 2);
+    CHECK_EQ(strcmp(receive_command->name, CMD_CONFIG_LOAD_SETTINGS), 0);
+
+    // 未知命令同样完成接收，但没有对应的命令表条目
+    CHECK_EQ(feed_text("unknown\n"), 1);
+    CHECK(receive_command == NULL);
+}
+
+static void test_payload_may_contain_newlines() {
+    uint8_t command[64];
+    uint8_t prefix = sizeof(CMD_CONFIG_SAVE_SETTINGS_PREFIX) - 1;
+
+    sketch_reset();
+
+    // 二进制数据中的换行符、回车符与 0x00 都按数据接收
+    uint8_t len = make_save_command(command);
+    command[prefix] = '\n';
+    command[prefix + 1] = '\r';
+    command[prefix + 2] = 0x00;
+    command[len - 1] = 'x'; // 结束符内容不限
+
+    for (uint8_t i = 0; i < len - 1; i++) {
+        CHECK(!receive_byte(command[i]));
+    }
+    CHECK(receive_byte(command[len - 1]));
+    CHECK_EQ(strcmp(receive_command->name, CMD_CONFIG_SAVE_SETTINGS), 0);
+    CHECK_EQ(receive_ptr, prefix + CMD_CONFIG_SAVE_SETTINGS_PAYLOAD);
+    CHECK_EQ(memcmp(receive_buf, command, receive_ptr), 0);
+
+    // 状态机回到文本命令接收
+    receive_ptr = 0;
+    CHECK_EQ(feed_text("heartbeat\n"), 1);
+    CHECK_EQ(strcmp(receive_command->name, CMD_CONFIG_HEARTBEAT), 0);
+}
+
+static void test_payload_command_without_payload() {
+    sketch_reset();
+
+    // 缺少 "=" 与数据的 save_settings 按未知命令处理
+    CHECK_EQ(feed_text("save_settings\n"), 1);
+    CHECK(receive_command == NULL);
+
+    // 其他命令名称之后的 "=" 按普通字符接收
+    CHECK_EQ(feed_text("heartbeat=1\n"), 1);
+    CHECK(receive_command == NULL);
+}
+
+static void test_overlong_command_discarded() {
+    char text[80];
+
+    sketch_reset();
+    memset(text, 'a', sizeof(receive_buf) + 10);
+    strcpy(text + sizeof(receive_buf) + 10, "\nheartbeat\n");
+
+    // 超出接收缓冲区的命令丢弃至换行符，之后的命令不受影响
+    CHECK_EQ(feed_text(text), 1);
+    CHECK_EQ(strcmp(receive_command->name, CMD_CONFIG_HEARTBEAT), 0);
+}
+
+static void test_commands_through_usb() {
+    uint8_t command[64];
+
+    open_port();
+
+    // 文本命令、前缀命令与二进制数据命令经由 CDC 端点到达主程序
+    sketch_send("config_mode_enabled\r\nget_brightness\nnot_a_command\n");
+    sketch_replies();
+    CHECK_EQ(strcmp((char *)sim_cdc_rx,
+                    "config_mode_enabled_success\r\nbrightness=3\r\n"),
+             0);
+
+    // fade_duration 为 266 时数据中含 0x0A，不会提前结束命令
+    EEPROM_SetFadeEffectDuration(266);
+    uint8_t len = make_save_command(command);
+    EEPROM_Reset();
+    CHECK(memchr(command, '\n', len - 1) != NULL);
+
+    sketch_send_data(command, len);
+    sketch_replies();
+    CHECK_EQ(strcmp((char *)sim_cdc_rx, "save_settings_success\r\n"), 0);
+    CHECK_EQ(EEPROM_GetFadeEffectDuration(), 266);
+}
+
+/**
+ * @brief 发送一条命令并读取应答
+ * @return 应答与 expected 一致返回 true
+ */
+static bool command_reply(const char *command, const char *expected) {
+    sketch_send(command);
+    sketch_replies();
+    if (strcmp((char *)sim_cdc_rx, expected) != 0) {
+        printf("     %s-> %s", command, sim_cdc_rx);
+        return false;
+    }
+    return true;
+}
+
+static void test_set_applies_only_affected_module() {
+    open_port();
+    uint16_t inits = sim_led_inits;
+    uint16_t written = EEPROM_GetBytesWritten();
+
+    // 亮度只调用 WS2812_SetBrightness，不重新初始化 LED，暂不写入 EEPROM
+    CHECK(command_reply("set_brightness=1\n", "brightness=1\r\n"));
+    CHECK_EQ(ws2812.brightness, 1);
+    CHECK_EQ(EEPROM_GetBrightness(), 1);
+    CHECK_EQ(sim_led_inits, inits);
+    CHECK(command_reply("set_fade_duration=200\n", "fade_duration=200\r\n"));
+    CHECK_EQ(ws2812.fade_duration, 200);
+    CHECK(command_reply("set_rotate_cw=30\n", "rotate_cw=30\r\n"));
+    CHECK_EQ(sim_led_inits, inits);
+    CHECK_EQ(EEPROM_GetBytesWritten(), written);
+
+    // LED 数量与颜色顺序需要重新初始化 LED
+    CHECK(command_reply("set_led_count=6\n", "led_count=6\r\n"));
+    CHECK_EQ(sim_led_inits, inits + 1);
+    CHECK_EQ(ws2812.led_count, 6);
+    CHECK_EQ(ws2812.brightness, 1); // 重新初始化后保留当前亮度
+
+    CHECK(command_reply("get_rotate_cw\n", "rotate_cw=30\r\n"));
+}
+
+static void test_set_saved_after_delay() {
+    open_port();
+    uint16_t written = EEPROM_GetBytesWritten();
+
+    // 连续修改只在最后一次修改 SETTINGS_SAVE_DELAY 之后写入一次
+    for (uint8_t level = 0; level <= BRIGHTNESS_MAX; level++) {
+        char command[24];
+
+        snprintf(command, sizeof(command), "set_brightness=%u\n", level);
+        sketch_send(command);
+        sketch_run(SETTINGS_SAVE_DELAY / 4);
+    }
+    sketch_send("set_brightness=2\n");
+    CHECK(settings_dirty);
+    sketch_run(SETTINGS_SAVE_DELAY - 1);
+    CHECK_EQ(EEPROM_GetBytesWritten(), written);
+    sketch_run(1);
+    CHECK(!settings_dirty);
+    CHECK_EQ(EEPROM_GetBytesWritten(), written + 1);
+    CHECK_EQ(host_eeprom[offsetof(eeprom_config_t, brightness)], 2);
+
+    // 读取全部配置前写入尚未保存的修改
+    sketch_send("set_brightness=4\n");
+    sketch_send("load_settings\n");
+    CHECK(!settings_dirty);
+    CHECK_EQ(host_eeprom[offsetof(eeprom_config_t, brightness)], 4);
+}
+
+static void test_set_rejects_invalid_values() {
+    open_port();
+
+    // 超出范围、无法转换为参数类型、格式错误或未知参数均回复失败
+    CHECK(command_reply("set_brightness=9\n", "set_brightness_failed\r\n"));
+    CHECK(command_reply("set_led_count=-1\n", "set_led_count_failed\r\n"));
+    CHECK(command_reply("set_led_count=262\n", "set_led_count_failed\r\n"));
+    CHECK(command_reply("set_fade_duration=2x\n",
+                        "set_fade_duration_failed\r\n"));
+    CHECK(command_reply("set_rotate_cw=40000\n", "set_rotate_cw_failed\r\n"));
+    CHECK(command_reply("set_brightness=\n", "set_brightness_failed\r\n"));
+    CHECK(command_reply("set_brightness\n", "set_brightness_failed\r\n"));
+    CHECK(command_reply("set_unknown=1\n", "set_unknown_failed\r\n"));
+    CHECK(command_reply("get_unknown\n", "get_unknown_failed\r\n"));
+
+    // 失败的修改不改变配置，也不等待保存
+    CHECK_EQ(EEPROM_GetBrightness(), BRIGHTNESS_DEFAULT);
+    CHECK_EQ(EEPROM_GetLedCount(), LED_COUNT_DEFAULT);
+    CHECK(!settings_dirty);
+}
+
+/**
+ * @brief 主机发送数据，不运行主循环
+ */
+static void host_write(const char *text) {
+    CHECK(usb_cdc_out((const uint8_t *)text, strlen(text)));
+}
+
+static void test_burst_in_one_loop() {
+    open_port();
+
+    // 一个数据包中的全部命令在同一次主循环中执行，应答合并发送
+    host_write("config_mode_enabled\nget_brightness\nget_led_count\n"
+               "heartbeat\nget_phase\n");
+    loop();
+    sketch_replies();
+    CHECK_EQ(strcmp((char *)sim_cdc_rx,
+                    "config_mode_enabled_success\r\nbrightness=3\r\n"
+                    "led_count=4\r\nphase=0\r\n"),
+             0);
+    CHECK(is_config_mode);
+    CHECK_EQ(USBSerial_available(), 0);
+
+    // 不完整的命令留在接收状态机中，与下一个数据包拼接
+    host_write("get_bri");
+    loop();
+    CHECK_EQ(sketch_replies(), 0);
+    host_write("ghtness\n");
+    loop();
+    sketch_replies();
+    CHECK_EQ(strcmp((char *)sim_cdc_rx, "brightness=3\r\n"), 0);
+}
+
+static void test_budget_bounds_commands() {
+    open_port();
+
+    // 每条命令耗时 600 微秒，预算 2000 微秒内执行 4 条，其余留到下一次循环
+    sim_micros_step = 600;
+    host_write("get_phase\nget_phase\nget_phase\nget_phase\n"
+               "get_phase\nget_phase\n");
+    loop();
+    sketch_replies();
+    CHECK_EQ(strlen((char *)sim_cdc_rx), 4 * strlen("phase=0\r\n"));
+    CHECK(USBSerial_available() > 0);
+
+    loop();
+    sketch_replies();
+    CHECK_EQ(strlen((char *)sim_cdc_rx), 2 * strlen("phase=0\r\n"));
+    CHECK_EQ(USBSerial_available(), 0);
+
+    // 单条命令超出预算时仍至少执行一条
+    sim_micros_step = COMMAND_TIME_BUDGET * 2;
+    host_write("get_phase\nget_phase\n");
+    loop();
+    sketch_replies();
+    CHECK_EQ(strcmp((char *)sim_cdc_rx, "phase=0\r\n"), 0);
+}
+
+static void test_config_mode_follows_dtr() {
+    open_port();
+
+    // 打开串口后进入配置模式，没有心跳也保持配置模式
+    sketch_send("config_mode_enabled\n");
+    CHECK(is_config_mode);
+    CHECK(config_by_dtr);
+    sketch_run(HEARTBEAT_TIMEOUT * 3);
+    CHECK(is_config_mode);
+    sketch_replies();
+
+    // 关闭串口：下一次主循环退出，不发送超时应答
+    usb_cdc_line_state(0);
+    loop();
+    CHECK(!is_config_mode);
+    CHECK_EQ(sketch_replies(), 0);
+
+    // 拔出：总线复位后立即退出
+    usb_cdc_line_state(CDC_LINE_STATE_DTR);
+    sketch_send("config_mode_enabled\n");
+    CHECK(is_config_mode);
+    usb_bus_reset();
+    loop();
+    CHECK(!is_config_mode);
+
+    // 挂起同样退出
+    usb_enumerate();
+    usb_cdc_line_state(CDC_LINE_STATE_DTR);
+    sketch_send("config_mode_enabled\n");
+    CHECK(is_config_mode);
+    usb_suspend();
+    loop();
+    CHECK(!is_config_mode);
+}
+
+static void test_heartbeat_fallback() {
+    sketch_reset();
+    usb_enumerate();
+    usb_cdc_line_state(CDC_LINE_STATE_RTS); // 不设置 DTR 的主机
+
+    // 心跳在超时前到达时保持配置模式
+    sketch_send("config_mode_enabled\n");
+    CHECK(is_config_mode);
+    CHECK(!config_by_dtr);
+    sketch_run(HEARTBEAT_TIMEOUT - 1);
+    sketch_send("heartbeat\n");
+    sketch_run(HEARTBEAT_TIMEOUT - 1);
+    CHECK(is_config_mode);
+
+    // 心跳停止后超时退出并发送超时应答
+    sketch_replies();
+    sketch_run(1);
+    CHECK(!is_config_mode);
+    sketch_replies();
+    CHECK_EQ(strcmp((char *)sim_cdc_rx, CMD_CONFIG_MODE_TIMEOUT "\r\n"), 0);
+}
+
+/**
+ * @brief 主机读取一个端点1 通知
+ * @return (事件 << 8) | 参数，没有通知时返回 0
+ */
+static uint16_t take_event() {
+    uint8_t buf[CDC_NOTIFICATION_EPSIZE];
+
+    if (!usb_notify_in(buf) || buf[1] != CDC_NOTIFY_DEVICE_EVENT) {
+        return 0;
+    }
+    return buf[2] << 8 | buf[3];
+}
+
+static void test_events_notified() {
+    open_port();
+    CHECK_EQ(take_event(), 0);
+
+    // 修改立即通知，延迟保存后通知写入的字节数
+    sketch_send("set_brightness=1\n");
+    CHECK_EQ(take_event(), CDC_EVENT_CONFIG_CHANGED << 8);
+    CHECK_EQ(take_event(), 0);
+    sketch_run(SETTINGS_SAVE_DELAY);
+    CHECK_EQ(take_event(), CDC_EVENT_SAVE_COMPLETE << 8 | 1);
+
+    // 无效的修改通知错误
+    sketch_send("set_brightness=9\n");
+    CHECK_EQ(take_event(), CDC_EVENT_ERROR << 8 | CDC_ERROR_INVALID_CONFIG);
+
+    // 恢复默认配置依次通知保存完成与配置已修改
+    sketch_send("reset_settings\n");
+    CHECK_EQ(take_event() >> 8, CDC_EVENT_SAVE_COMPLETE);
+    CHECK_EQ(take_event(), CDC_EVENT_CONFIG_CHANGED << 8);
+    CHECK_EQ(take_event(), 0);
+}
+
+/**
+ * @brief 转动编码器一齿，每个状态跳变运行 2 帧
+ */
+static void turn_detent(const uint8_t *detent) {
+    for (uint8_t i = 0; i < 4; i++) {
+        sim_set_ab(0, detent[i]);
+        sketch_run(2);
+    }
+}
+
+static void test_rotation_reported_in_config_mode() {
+    uint8_t command[64];
+    // 每齿的旋转量，HID 报告的单位为 0.1 度
+    int16_t cw = STEP_PER_TEETH_DEFAULT * ROTATE_CW_DEFAULT * 10;
+    int16_t ccw = STEP_PER_TEETH_DEFAULT * ROTATE_CCW_DEFAULT * 10;
+
+    open_port();
+    sketch_send("config_mode_enabled\n");
+    CHECK(is_config_mode);
+
+    // 转动期间配置工具持续发送心跳、读取与修改参数
+    for (uint8_t n = 0; n < 20; n++) {
+        char text[24];
+
+        snprintf(text, sizeof(text), n % 2 ? "heartbeat\n" : "get_phase\n");
+        sketch_send(text);
+        if (n % 5 == 4) {
+            snprintf(text, sizeof(text), "set_brightness=%u\n", n % 4);
+            sketch_send(text);
+        }
+        turn_detent(CW_DETENT);
+        sketch_replies();
+    }
+    sketch_run(HID_POLL_INTERVAL_DEFAULT * 2);
+    CHECK_EQ(sim_dial_total[0], 20 * cw);
+
+    // 保存全部配置写入 EEPROM 前取出积压的旋转事件，之后的转动照常发送
+    sim_set_ab(0, CCW_DETENT[0]);
+    sketch_run(1);
+    sim_set_ab(0, CCW_DETENT[1]);
+    sketch_send_data(command, make_save_command(command));
+    sim_set_ab(0, CCW_DETENT[2]);
+    sketch_run(1);
+    sim_set_ab(0, CCW_DETENT[3]);
+    sketch_run(1);
+    for (uint8_t n = 1; n < 10; n++) {
+        turn_detent(CCW_DETENT);
+    }
+    sketch_run(SETTINGS_SAVE_DELAY + INPUT_IDLE_TIME);
+    CHECK_EQ(sim_dial_total[0], 20 * cw + 10 * ccw);
+
+    CHECK(is_config_mode);
+    CHECK(!settings_dirty);
+    CHECK_EQ(EC11_GetDroppedEvents(), 0);
+    CHECK_EQ(EC11_GetInvalidTransitions(0), 0);
+}
+
+static void test_preview_requires_config_mode() {
+    open_port();
+
+    // 配置模式之外不能进入预览模式，修改照常保存
+    CHECK(command_reply("preview\n", "preview_failed\r\n"));
+    CHECK(!is_preview_mode);
+    CHECK(command_reply("set_brightness=1\n", "brightness=1\r\n"));
+    CHECK(settings_dirty);
+
+    // 预览期间主机关闭串口，退出配置模式并恢复已保存的配置
+    CHECK(command_reply("config_mode_enabled\n",
+                        "config_mode_enabled_success\r\n"));
+    CHECK(command_reply("preview\n", "preview_success\r\n"));
+    CHECK_EQ(host_eeprom[offsetof(eeprom_config_t, brightness)], 1);
+    sketch_send("set_brightness=4\n");
+    CHECK_EQ(ws2812.brightness, 4);
+
+    usb_cdc_line_state(0);
+    loop();
+    CHECK(!is_config_mode);
+    CHECK(!is_preview_mode);
+    CHECK_EQ(EEPROM_GetBrightness(), 1);
+    CHECK_EQ(ws2812.brightness, 1);
+    sketch_run(SETTINGS_SAVE_DELAY + INPUT_IDLE_TIME);
+    CHECK_EQ(host_eeprom[offsetof(eeprom_config_t, brightness)], 1);
+}
+
+static void test_preview_commit_and_revert() {
+    open_port();
+    CHECK(command_reply("config_mode_enabled\n",
+                        "config_mode_enabled_success\r\n"));
+    uint16_t written = EEPROM_GetBytesWritten();
+
+    // 未修改时 commit 不写入任何字节
+    CHECK(command_reply("preview\n", "preview_success\r\n"));
+    CHECK(command_reply("commit\n", "commit_success\r\nbytes_written=0\r\n"));
+    CHECK_EQ(EEPROM_GetBytesWritten(), written);
+
+    // 同一项改多次再改回原值，同样不写入
+    CHECK(command_reply("preview\n", "preview_success\r\n"));
+    sketch_send("set_brightness=1\nset_brightness=3\n");
+    sketch_replies();
+    CHECK(command_reply("commit\n", "commit_success\r\nbytes_written=0\r\n"));
+
+    // 修改一项只写入该项的 1 个字节
+    CHECK(command_reply("preview\n", "preview_success\r\n"));
+    CHECK(command_reply("set_brightness=1\n", "brightness=1\r\n"));
+    CHECK_EQ(host_eeprom[offsetof(eeprom_config_t, brightness)], 3);
+    CHECK(command_reply("commit\n", "commit_success\r\nbytes_written=1\r\n"));
+    CHECK(!is_preview_mode);
+    CHECK_EQ(host_eeprom[offsetof(eeprom_config_t, brightness)], 1);
+    CHECK_EQ(EEPROM_GetBytesWritten(), written + 1);
+
+    // revert 丢弃预览中的修改，恢复并应用已保存的配置
+    eeprom_config_t saved;
+    memcpy(&saved, host_eeprom, sizeof(saved));
+    CHECK(command_reply("preview\n", "preview_success\r\n"));
+    sketch_send("set_brightness=4\nset_led_count=2\n");
+    sketch_replies();
+    CHECK_EQ(ws2812.brightness, 4);
+    CHECK(command_reply("revert\n", "revert_success\r\n"));
+    CHECK(!is_preview_mode);
+    CHECK_EQ(memcmp(&config, &saved, sizeof(saved)), 0);
+    CHECK_EQ(ws2812.brightness, 1);
+    CHECK_EQ(memcmp(host_eeprom, &saved, sizeof(saved)), 0);
+    CHECK_EQ(EEPROM_GetBytesWritten(), written + 1);
+
+    // revert 之后没有待保存的修改
+    sketch_run(SETTINGS_SAVE_DELAY + INPUT_IDLE_TIME);
+    CHECK_EQ(EEPROM_GetBytesWritten(), written + 1);
+}
+
+int main() {
+    RUN(test_every_command_found);
+    RUN(test_text_command_per_byte);
+    RUN(test_payload_may_contain_newlines);
+    RUN(test_payload_command_without_payload);
+    RUN(test_overlong_command_discarded);
+    RUN(test_commands_through_usb);
+    RUN(test_set_applies_only_affected_module);
+    RUN(test_set_saved_after_delay);
+    RUN(test_set_rejects_invalid_values);
+    RUN(test_burst_in_one_loop);
+    RUN(test_budget_bounds_commands);
+    RUN(test_config_mode_follows_dtr);
+    RUN(test_heartbeat_fallback);
+    RUN(test_events_notified);
+    RUN(test_rotation_reported_in_config_mode);
+    RUN(test_preview_requires_config_mode);
+    RUN(test_preview_commit_and_revert);
+    return TEST_RESULT();
+}
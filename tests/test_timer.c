@@ -0,0 +1,108 @@
+/*
+  定时器定频采样主机测试
+
+  以定时器采样方式编译驱动，直接调用定时器中断处理函数模拟定时器 2 溢出，
+  检查定时器配置、主循环阻塞期间不漏采、时间戳时钟由定时器推进，
+  以及主循环同步时钟时的中断屏蔽
+*/
+#include "../src/Drivers/EC11.c"
+#include "ec11_sim.h"
+#include "test.h"
+
+// 每毫秒的定时器中断次数
+#define TICKS_PER_MS (EC11_SAMPLE_RATE_HZ / 1000)
+
+static void tick(uint16_t ticks) {
+    for (uint16_t n = 0; n < ticks; n++) {
+        TF2 = 1;
+        EC11_TimerInterrupt();
+        CHECK_EQ(TF2, 0);
+    }
+}
+
+static void test_timer_setup() {
+    sim_reset();
+
+    uint16_t reload = ((uint16_t)RCAP2H << 8) | RCAP2L;
+    CHECK_EQ(65536 - reload, F_CPU / 12 / EC11_SAMPLE_RATE_HZ);
+    CHECK_EQ(TL2, RCAP2L);
+    CHECK_EQ(TH2, RCAP2H);
+    CHECK_EQ(TR2, 1);
+    CHECK_EQ(ET2, 1);
+    CHECK_EQ(T2MOD & (bTMR_CLK | bT2_CLK), 0);
+}
+
+static void test_stalled_loop_loses_no_steps() {
+    uint8_t cw, ccw;
+
+    sim_reset();
+    EC11_SetStepPerTeeth(STEP_PER_TEETH_4X);
+
+    // 主循环阻塞 10 毫秒，期间每次定时器中断都发生一个状态跳变
+    for (uint8_t n = 0; n < 5; n++) {
+        for (uint8_t i = 0; i < 4; i++) {
+            sim_set_ab(0, CW_DETENT[i]);
+            tick(1);
+        }
+    }
+
+    sim_drain(0, &cw, &ccw);
+    CHECK_EQ(cw, 20);
+    CHECK_EQ(ccw, 0);
+    CHECK_EQ(EC11_GetInvalidTransitions(0), 0);
+}
+
+static void test_timer_advances_event_clock() {
+    uint8_t index;
+
+    sim_reset();
+    EC11_SetStepPerTeeth(STEP_PER_TEETH_1X);
+
+    host_millis = 500;
+    EC11_UpdateStatus();
+
+    // 不调用主循环，每 3 毫秒一个状态跳变，一齿 12 毫秒
+    uint32_t calls = millis_calls;
+    for (uint8_t n = 0; n < 2; n++) {
+        for (uint8_t i = 0; i < 4; i++) {
+            tick(3 * TICKS_PER_MS - 1);
+            sim_set_ab(0, CW_DETENT[i]);
+            tick(1);
+        }
+    }
+    CHECK_EQ(millis_calls, calls);
+
+    CHECK_EQ(EC11_GetDirection(&index), EC11_DIR_CW);
+    CHECK_EQ(EC11_GetEventTime(0), 512);
+    CHECK_EQ(EC11_GetDirection(&index), EC11_DIR_CW);
+    CHECK_EQ(EC11_GetEventTime(0), 524);
+    CHECK_EQ(EC11_GetEventInterval(0), 12);
+}
+
+static void test_loop_resyncs_clock() {
+    uint8_t index;
+
+    sim_reset();
+    EC11_SetStepPerTeeth(STEP_PER_TEETH_4X);
+
+    // 定时器时钟漂移后由主循环同步到 millis()，同步期间屏蔽定时器中断
+    tick(1);
+    host_millis = 2000;
+    EC11_UpdateStatus();
+    CHECK_EQ(ET2, 1);
+
+    tick(TICKS_PER_MS - 1);
+    sim_set_ab(0, CW_DETENT[0]);
+    tick(1);
+
+    CHECK_EQ(EC11_GetDirection(&index), EC11_DIR_CW);
+    CHECK_EQ(EC11_GetEventTime(0), 2001);
+}
+
+int main() {
+    RUN(test_timer_setup);
+    RUN(test_stalled_loop_loses_no_steps);
+    RUN(test_timer_advances_event_clock);
+    RUN(test_loop_resyncs_clock);
+    return TEST_RESULT();
+}
@@ -0,0 +1,240 @@
+/*
+  厂商配置请求主机测试
+
+  经由 USB 设备模拟重放完整的控制传输（SETUP、数据阶段与状态阶段），
+  检查 VENDOR_GET_CONFIG 读出 32 字节配置结构体，VENDOR_SET_CONFIG
+  接收完整结构体后交由主循环保存，保存完成前的新写入、长度或方向
+  错误的请求回复 STALL；HID 接口的配置特征报告经 GET_REPORT/SET_REPORT
+  以同样方式读写带报告 ID 的配置数据
+*/
+#include "usb_sim.h"
+#include "test.h"
+
+#define VENDOR_REQ (USB_REQ_TYP_VENDOR | USB_REQ_RECIP_DEVICE)
+#define HID_REQ (USB_REQ_TYP_CLASS | USB_REQ_RECIP_INTERF)
+
+// 特征报告的 wValue：高字节为报告类型（3 = 特征报告），低字节为报告 ID
+#define FEATURE_REPORT(id) (0x0300 | (id))
+#define REPORT_SIZE (CONFIG_REPORT_LENGTH + 1) // 含报告 ID
+
+static void open_device() {
+    usb_sim_reset();
+    EEPROM_Reset();
+    usb_enumerate();
+}
+
+/**
+ * @brief 生成与当前配置逐字节不同的配置数据
+ */
+static void make_config(uint8_t *data) {
+    const uint8_t *config = (const uint8_t *)EEPROM_GetConfigData();
+
+    for (uint8_t i = 0; i < CONFIG_STRUCT_SIZE; i++) {
+        data[i] = config[i] ^ (0x5A + i);
+    }
+}
+
+static void test_get_config() {
+    uint8_t buf[CONFIG_STRUCT_SIZE];
+
+    open_device();
+
+    // 32 字节分 4 个数据包读出，与 EEPROM 中的配置一致
+    memset(buf, 0, sizeof(buf));
+    CHECK_EQ(usb_control_in(VENDOR_REQ, VENDOR_GET_CONFIG, 0, 0, sizeof(buf),
+                            buf),
+             CONFIG_STRUCT_SIZE);
+    CHECK_EQ(memcmp(buf, EEPROM_GetConfigData(), CONFIG_STRUCT_SIZE), 0);
+
+    // 主机请求的长度较短时按请求长度截断
+    CHECK_EQ(usb_control_in(VENDOR_REQ, VENDOR_GET_CONFIG, 0, 0, 5, buf), 5);
+    CHECK_EQ(usb_control_in(VENDOR_REQ, VENDOR_GET_CONFIG, 0, 0, 255, NULL),
+             CONFIG_STRUCT_SIZE);
+    CHECK_EQ(sim_stalls, 0);
+}
+
+static void test_set_config() {
+    uint8_t data[CONFIG_STRUCT_SIZE];
+    uint8_t status = 0xFF;
+
+    open_device();
+    make_config(data);
+    CHECK(Vendor_TakeConfig() == NULL);
+
+    // 完整接收后状态为等待保存，主循环取出的数据与主机写入的一致
+    CHECK_EQ(usb_control_out(VENDOR_REQ, VENDOR_SET_CONFIG, 0, 0,
+                             sizeof(data), data),
+             0);
+    CHECK_EQ(usb_control_in(VENDOR_REQ, VENDOR_GET_STATUS, 0, 0, 1, &status),
+             1);
+    CHECK_EQ(status, VENDOR_STATUS_PENDING);
+
+    const __xdata uint8_t *config = Vendor_TakeConfig();
+    CHECK(config != NULL);
+    CHECK_EQ(memcmp(config, data, sizeof(data)), 0);
+    CHECK(Vendor_TakeConfig() == NULL);
+
+    // 保存完成前的新写入回复 STALL，报告结果后恢复接收
+    CHECK_EQ(usb_control_out(VENDOR_REQ, VENDOR_SET_CONFIG, 0, 0,
+                             sizeof(data), data),
+             SIM_STALL);
+    Vendor_SetStatus(VENDOR_STATUS_INVALID);
+    CHECK_EQ(usb_control_in(VENDOR_REQ, VENDOR_GET_STATUS, 0, 0, 1, &status),
+             1);
+    CHECK_EQ(status, VENDOR_STATUS_INVALID);
+    CHECK_EQ(usb_control_out(VENDOR_REQ, VENDOR_SET_CONFIG, 0, 0,
+                             sizeof(data), data),
+             0);
+    CHECK(Vendor_TakeConfig() != NULL);
+}
+
+static void test_bad_requests_stall() {
+    uint8_t data[CONFIG_STRUCT_SIZE + 1] = {0};
+
+    open_device();
+
+    // 只接收完整的结构体
+    CHECK_EQ(usb_control_out(VENDOR_REQ, VENDOR_SET_CONFIG, 0, 0,
+                             CONFIG_STRUCT_SIZE - 1, data),
+             SIM_STALL);
+    CHECK_EQ(usb_control_out(VENDOR_REQ, VENDOR_SET_CONFIG, 0, 0,
+                             CONFIG_STRUCT_SIZE + 1, data),
+             SIM_STALL);
+
+    // 方向错误与未定义的请求代码
+    CHECK_EQ(usb_setup(VENDOR_REQ | USB_REQ_TYP_OUT, VENDOR_GET_CONFIG, 0, 0,
+                       CONFIG_STRUCT_SIZE),
+             SIM_STALL);
+    CHECK_EQ(usb_setup(VENDOR_REQ | USB_REQ_TYP_IN, VENDOR_SET_CONFIG, 0, 0,
+                       CONFIG_STRUCT_SIZE),
+             SIM_STALL);
+    CHECK_EQ(usb_setup(VENDOR_REQ | USB_REQ_TYP_OUT, VENDOR_GET_STATUS, 0, 0,
+                       1),
+             SIM_STALL);
+    CHECK_EQ(usb_control_in(VENDOR_REQ, 0x33, 0, 0, 1, NULL), SIM_STALL);
+    CHECK_EQ(sim_stalls, 6);
+
+    // 被拒绝的请求不影响之后的传输
+    CHECK(Vendor_TakeConfig() == NULL);
+    CHECK_EQ(usb_control_in(VENDOR_REQ, VENDOR_GET_CONFIG, 0, 0,
+                            CONFIG_STRUCT_SIZE, data),
+             CONFIG_STRUCT_SIZE);
+    CHECK_EQ(memcmp(data, EEPROM_GetConfigData(), CONFIG_STRUCT_SIZE), 0);
+}
+
+static void test_report_descriptor_has_feature() {
+    static const uint8_t feature[] = {
+        0x85, CONFIG_REPORT_ID,     // REPORT_ID
+        0x09, 0x02,                 // USAGE
+        0x15, 0x00,                 // LOGICAL_MINIMUM (0)
+        0x26, 0xff, 0x00,           // LOGICAL_MAXIMUM (255)
+        0x75, 0x08,                 // REPORT_SIZE (8)
+        0x95, CONFIG_REPORT_LENGTH, // REPORT_COUNT
+        0xb1, 0x02,                 // FEATURE (Data,Var,Abs)
+    };
+    uint8_t buf[sizeof(ReportDescriptor)];
+    bool found = false;
+
+    open_device();
+    CHECK_EQ(CONFIG_REPORT_LENGTH, CONFIG_STRUCT_SIZE);
+
+    // 主机读出的报告描述符中包含 32 字节的配置特征报告
+    CHECK_EQ(usb_control_in(USB_REQ_TYP_STANDARD | USB_REQ_RECIP_INTERF,
+                            USB_GET_DESCRIPTOR, 0x2200, INTERFACE_ID_HID,
+                            sizeof(buf), buf),
+             sizeof(buf));
+    for (uint16_t i = 0; i + sizeof(feature) <= sizeof(buf); i++) {
+        found |= memcmp(buf + i, feature, sizeof(feature)) == 0;
+    }
+    CHECK(found);
+}
+
+static void test_get_feature_report() {
+    uint8_t buf[REPORT_SIZE];
+
+    open_device();
+
+    // 报告 ID 在前，其后为完整的配置结构体，共 5 个数据包
+    CHECK_EQ(usb_control_in(HID_REQ, HID_GET_REPORT,
+                            FEATURE_REPORT(CONFIG_REPORT_ID),
+                            INTERFACE_ID_HID, sizeof(buf), buf),
+             REPORT_SIZE);
+    CHECK_EQ(buf[0], CONFIG_REPORT_ID);
+    CHECK_EQ(memcmp(buf + 1, EEPROM_GetConfigData(), CONFIG_STRUCT_SIZE), 0);
+    CHECK_EQ(sim_stalls, 0);
+}
+
+static void test_set_feature_report() {
+    uint8_t report[REPORT_SIZE];
+    uint8_t status = 0xFF;
+
+    open_device();
+    report[0] = CONFIG_REPORT_ID;
+    make_config(report + 1);
+
+    // 报告 ID 不写入配置数据，结果与厂商请求共用同一状态
+    CHECK_EQ(usb_control_out(HID_REQ, HID_SET_REPORT,
+                             FEATURE_REPORT(CONFIG_REPORT_ID),
+                             INTERFACE_ID_HID, sizeof(report), report),
+             0);
+    CHECK_EQ(usb_control_in(VENDOR_REQ, VENDOR_GET_STATUS, 0, 0, 1, &status),
+             1);
+    CHECK_EQ(status, VENDOR_STATUS_PENDING);
+
+    const __xdata uint8_t *config = Vendor_TakeConfig();
+    CHECK(config != NULL);
+    CHECK_EQ(memcmp(config, report + 1, CONFIG_STRUCT_SIZE), 0);
+
+    // 保存完成前经任一通道的新写入都回复 STALL
+    CHECK_EQ(usb_control_out(HID_REQ, HID_SET_REPORT,
+                             FEATURE_REPORT(CONFIG_REPORT_ID),
+                             INTERFACE_ID_HID, sizeof(report), report),
+             SIM_STALL);
+    CHECK_EQ(usb_control_out(VENDOR_REQ, VENDOR_SET_CONFIG, 0, 0,
+                             CONFIG_STRUCT_SIZE, report + 1),
+             SIM_STALL);
+    Vendor_SetStatus(VENDOR_STATUS_OK);
+    CHECK_EQ(usb_control_out(HID_REQ, HID_SET_REPORT,
+                             FEATURE_REPORT(CONFIG_REPORT_ID),
+                             INTERFACE_ID_HID, sizeof(report), report),
+             0);
+}
+
+static void test_other_reports_stall() {
+    uint8_t report[REPORT_SIZE] = {CONFIG_REPORT_ID};
+
+    open_device();
+
+    // 只支持配置特征报告，输入报告与其他报告 ID 回复 STALL
+    CHECK_EQ(usb_control_in(HID_REQ, HID_GET_REPORT,
+                            FEATURE_REPORT(CONFIG_REPORT_ID + 1),
+                            INTERFACE_ID_HID, REPORT_SIZE, NULL),
+             SIM_STALL);
+    CHECK_EQ(usb_control_in(HID_REQ, HID_GET_REPORT,
+                            0x0100 | RADIAL_REPORT_ID, INTERFACE_ID_HID, 3,
+                            NULL),
+             SIM_STALL);
+    CHECK_EQ(usb_control_out(HID_REQ, HID_SET_REPORT,
+                             FEATURE_REPORT(RADIAL_REPORT_ID),
+                             INTERFACE_ID_HID, sizeof(report), report),
+             SIM_STALL);
+
+    // 长度不是完整报告的写入回复 STALL
+    CHECK_EQ(usb_control_out(HID_REQ, HID_SET_REPORT,
+                             FEATURE_REPORT(CONFIG_REPORT_ID),
+                             INTERFACE_ID_HID, CONFIG_STRUCT_SIZE, report),
+             SIM_STALL);
+    CHECK_EQ(sim_stalls, 4);
+    CHECK(Vendor_TakeConfig() == NULL);
+}
+
+int main() {
+    RUN(test_get_config);
+    RUN(test_set_config);
+    RUN(test_bad_requests_stall);
+    RUN(test_report_descriptor_has_feature);
+    RUN(test_get_feature_report);
+    RUN(test_set_feature_report);
+    RUN(test_other_reports_stall);
+    return TEST_RESULT();
+}
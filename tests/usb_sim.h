@@ -0,0 +1,369 @@
+/*
+  USB 设备与主机模拟
+
+  编译 USBhandler.c 及其依赖的 CDC、径向控制器、厂商请求与 EEPROM 源文件，
+  经由 USBInterrupt() 注入 SETUP/IN/OUT/SOF 令牌、总线复位与挂起，
+  模拟主机的控制传输、按固定周期与相位轮询端点3，读取端点1 通知与
+  端点2 批量数据，以及向端点1 发送批量数据
+*/
+#ifndef __USB_SIM_H__
+#define __USB_SIM_H__
+
+#include <stdint.h>
+#include <string.h>
+
+#include <Arduino.h>
+
+// CH552 开发板菜单中的 USB 内存设置
+#ifndef USER_USB_RAM
+#define USER_USB_RAM 266
+#endif
+
+// SDCC 不对齐结构体成员，报告结构体须按字节紧凑排列
+#pragma pack(push, 1)
+#include "../src/CdcRadial/USBhandler.c"
+#include "../src/CdcRadial/USBconstant.c"
+#include "../src/CdcRadial/USBCDC.c"
+#include "../src/CdcRadial/USBRadial.c"
+#include "../src/CdcRadial/USBVendor.c"
+#include "../src/Drivers/EEPROM.c"
+#pragma pack(pop)
+
+#define SIM_STALL 0xFFFF   // 控制传输被 STALL
+#define SIM_REPORTS_MAX 4096 // 记录的端点3 报告数量上限
+
+// 主机轮询端点3的周期与相位（帧），由测试按描述符中的间隔设置
+static uint8_t sim_poll_period;
+static uint8_t sim_poll_phase;
+static uint16_t sim_frame; // 主机帧号，每个 SOF 加 1
+static uint16_t sim_stalls; // 控制传输 STALL 次数
+
+// 主机收到的端点3 报告，以及按报告 ID 累计的旋转量与最新按钮状态
+static uint8_t sim_report_id[SIM_REPORTS_MAX];
+static uint16_t sim_report_value[SIM_REPORTS_MAX];
+static uint16_t sim_report_frame[SIM_REPORTS_MAX];
+static uint16_t sim_report_count;
+static int32_t sim_dial_total[RADIAL_DIAL_COUNT];
+static uint8_t sim_button[RADIAL_DIAL_COUNT];
+
+// 主机从端点2 收到的 CDC 数据、数据包数量与其中的零长度包数量
+static uint8_t sim_cdc_rx[8192];
+static uint16_t sim_cdc_rx_len;
+static uint16_t sim_cdc_packets;
+static uint16_t sim_cdc_zlps;
+
+static void usb_token(uint8_t token, uint8_t ep) {
+    USB_INT_ST = token | ep;
+    UIF_TRANSFER = 1;
+    USBInterrupt();
+}
+
+static bool usb_in_armed(uint8_t ctrl) {
+    return (ctrl & MASK_UEP_T_RES) == UEP_T_RES_ACK;
+}
+
+/**
+ * @brief 发送 SETUP 包
+ * @return 首个 IN 数据包长度，被 STALL 时返回 SIM_STALL
+ */
+static uint16_t usb_setup(uint8_t type, uint8_t request, uint16_t value,
+                          uint16_t index, uint16_t length) {
+    Ep0Buffer[0] = type;
+    Ep0Buffer[1] = request;
+    Ep0Buffer[2] = value & 0xFF;
+    Ep0Buffer[3] = value >> 8;
+    Ep0Buffer[4] = index & 0xFF;
+    Ep0Buffer[5] = index >> 8;
+    Ep0Buffer[6] = length & 0xFF;
+    Ep0Buffer[7] = length >> 8;
+    USB_RX_LEN = sizeof(USB_SETUP_REQ);
+    usb_token(UIS_TOKEN_SETUP, 0);
+
+    if ((UEP0_CTRL & MASK_UEP_T_RES) == UEP_T_RES_STALL) {
+        sim_stalls++;
+        return SIM_STALL;
+    }
+    return UEP0_T_LEN;
+}
+
+/**
+ * @brief 读取型控制传输：SETUP、IN 数据阶段与 OUT 状态阶段
+ * @param buf 接收数据，可为 NULL
+ * @return 收到的字节数，被 STALL 时返回 SIM_STALL
+ */
+static uint16_t usb_control_in(uint8_t type, uint8_t request, uint16_t value,
+                               uint16_t index, uint16_t length,
+                               uint8_t *buf) {
+    uint16_t got = 0;
+
+    if (usb_setup(type | USB_REQ_TYP_IN, request, value, index, length) ==
+        SIM_STALL) {
+        return SIM_STALL;
+    }
+
+    while (got < length) {
+        uint8_t len = UEP0_T_LEN;
+
+        if (buf != NULL) {
+            memcpy(buf + got, Ep0Buffer, len);
+        }
+        got += len;
+        usb_token(UIS_TOKEN_IN, 0);
+        if (len < DEFAULT_ENDP0_SIZE) {
+            break;
+        }
+    }
+
+    U_TOG_OK = 1;
+    USB_RX_LEN = 0;
+    usb_token(UIS_TOKEN_OUT, 0);
+    return got;
+}
+
+/**
+ * @brief 写入型控制传输：SETUP、OUT 数据阶段与 IN 状态阶段
+ * @return 被 STALL 时返回 SIM_STALL，否则返回 0
+ */
+static uint16_t usb_control_out(uint8_t type, uint8_t request, uint16_t value,
+                                uint16_t index, uint16_t length,
+                                const uint8_t *data) {
+    if (usb_setup(type | USB_REQ_TYP_OUT, request, value, index, length) ==
+        SIM_STALL) {
+        return SIM_STALL;
+    }
+
+    for (uint16_t sent = 0; sent < length;) {
+        uint8_t len = length - sent > DEFAULT_ENDP0_SIZE ? DEFAULT_ENDP0_SIZE
+                                                         : length - sent;
+
+        memcpy(Ep0Buffer, data + sent, len);
+        U_TOG_OK = 1;
+        USB_RX_LEN = len;
+        usb_token(UIS_TOKEN_OUT, 0);
+        sent += len;
+    }
+
+    usb_token(UIS_TOKEN_IN, 0);
+    return 0;
+}
+
+static void usb_bus_reset() {
+    UIF_BUS_RST = 1;
+    USBInterrupt();
+}
+
+static void usb_suspend() {
+    UIF_SUSPEND = 1;
+    USB_MIS_ST = bUMS_SUSPEND;
+    USBInterrupt();
+    USB_MIS_ST = 0;
+}
+
+/**
+ * @brief 主机取走端点3 的报告并按报告 ID 累计旋转量
+ */
+static void usb_take_report() {
+    uint8_t id = Ep3Buffer[0];
+    uint16_t value = Ep3Buffer[1] | (uint16_t)Ep3Buffer[2] << 8;
+    uint8_t dial = id - RADIAL_REPORT_ID;
+
+    if (sim_report_count < SIM_REPORTS_MAX) {
+        sim_report_id[sim_report_count] = id;
+        sim_report_value[sim_report_count] = value;
+        sim_report_frame[sim_report_count] = sim_frame;
+        sim_report_count++;
+    }
+    if (dial < RADIAL_DIAL_COUNT) {
+        sim_dial_total[dial] += (int16_t)(value & RADIAL_DIAL_MASK);
+        sim_button[dial] = value & RADIAL_BUTTON_MASK;
+    }
+
+    usb_token(UIS_TOKEN_IN, 3);
+}
+
+/**
+ * @brief 设置 CDC 控制线状态（SET_CONTROL_LINE_STATE）
+ * @param state CDC_LINE_STATE_DTR 与 CDC_LINE_STATE_RTS 的组合
+ */
+static void usb_cdc_line_state(uint8_t state) {
+    usb_control_out(USB_REQ_TYP_CLASS | USB_REQ_RECIP_INTERF,
+                    SET_CONTROL_LINE_STATE, state, INTERFACE_ID_CDC_CCI, 0,
+                    NULL);
+}
+
+/**
+ * @brief 主机向端点2 发出一次 IN 令牌
+ * @details 硬件按 bUEP_T_TOG 选择乒乓缓冲区，发送成功后自动翻转
+ * @return 收到的字节数，端点回复 NAK 时返回 -1
+ */
+static int16_t usb_cdc_in() {
+    if (!usb_in_armed(UEP2_CTRL)) {
+        return -1;
+    }
+
+    uint8_t len = UEP2_T_LEN;
+    uint8_t offset = (UEP2_CTRL & bUEP_T_TOG) ? MAX_PACKET_SIZE : 0;
+
+    if (sim_cdc_rx_len + len <= sizeof(sim_cdc_rx)) {
+        memcpy(sim_cdc_rx + sim_cdc_rx_len, Ep2Buffer + offset, len);
+        sim_cdc_rx_len += len;
+    }
+    sim_cdc_packets++;
+    if (len == 0) {
+        sim_cdc_zlps++;
+    }
+
+    UEP2_CTRL ^= bUEP_T_TOG;
+    usb_token(UIS_TOKEN_IN, 2);
+    return len;
+}
+
+/**
+ * @brief 主机在一帧内连续读取端点2，直到端点回复 NAK
+ * @param limit 一帧内最多的数据包数量
+ * @return 收到的字节数
+ */
+static uint16_t usb_cdc_in_frame(uint8_t limit) {
+    uint16_t total = 0;
+    int16_t len;
+
+    while (limit-- > 0 && (len = usb_cdc_in()) >= 0) {
+        total += len;
+    }
+    return total;
+}
+
+/**
+ * @brief 主机向端点1 发送一个 OUT 数据包
+ * @return 端点接收返回 true，回复 NAK 返回 false
+ */
+static bool usb_cdc_out(const uint8_t *data, uint8_t len) {
+    if ((UEP1_CTRL & MASK_UEP_R_RES) != UEP_R_RES_ACK) {
+        return false;
+    }
+
+    memcpy(Ep1Buffer, data, len);
+    USB_RX_LEN = len;
+    U_TOG_OK = 1;
+    usb_token(UIS_TOKEN_OUT, 1);
+    return true;
+}
+
+/**
+ * @brief 主机读取端点1 的通知
+ * @param buf 接收 8 字节通知
+ * @return 收到通知返回 true，端点回复 NAK 返回 false
+ */
+static bool usb_notify_in(uint8_t *buf) {
+    if (!usb_in_armed(UEP1_CTRL)) {
+        return false;
+    }
+
+    memcpy(buf, Ep1Buffer + MAX_PACKET_SIZE, UEP1_T_LEN);
+    usb_token(UIS_TOKEN_IN, 1);
+    return true;
+}
+
+/**
+ * @brief 运行一帧（1 毫秒）：SOF，并在主机轮询相位取走端点3 的报告
+ */
+static void usb_frame() {
+    host_millis++;
+    sim_frame++;
+    usb_token(UIS_TOKEN_SOF, 0);
+
+    if ((sim_frame & (sim_poll_period - 1)) == sim_poll_phase &&
+        usb_in_armed(UEP3_CTRL)) {
+        usb_take_report();
+    }
+}
+
+static void usb_frames(uint16_t count) {
+    while (count-- > 0) {
+        usb_frame();
+    }
+}
+
+/**
+ * @brief 运行帧直到端点3 的报告队列清空且没有待取走的报告
+ * @param limit 最多运行的帧数
+ */
+static void usb_drain_reports(uint16_t limit) {
+    while (limit-- > 0 && (queueCount > 0 || UpPoint3_Busy)) {
+        usb_frame();
+    }
+}
+
+/**
+ * @brief 上电复位设备与主机模型
+ * @details 清除各模块的统计与缓冲区，主机按描述符默认间隔轮询端点3
+ */
+static void usb_sim_reset() {
+    sim_poll_period = 8;
+    sim_poll_phase = 0;
+    sim_frame = 0;
+    sim_stalls = 0;
+    sim_report_count = 0;
+    memset(sim_dial_total, 0, sizeof(sim_dial_total));
+    memset(sim_button, 0, sizeof(sim_button));
+    sim_cdc_rx_len = 0;
+    sim_cdc_packets = 0;
+    sim_cdc_zlps = 0;
+    host_millis = 0;
+
+    USBInit();
+    usb_bus_reset();
+    Radial_ResetReport();
+
+    // 主机按描述符中的默认间隔轮询
+    radialPollInterval = HID_POLL_INTERVAL_DEFAULT;
+    radialSentInterval = HID_POLL_INTERVAL_DEFAULT;
+    latchRadialPollInterval();
+    sofFrame = 0;
+    queueMaxDepth = 0;
+    queueOverflow = 0;
+    txOverflow = 0;
+    inputTimeValid = false;
+
+    RadialLatencyStats latency;
+    RadialPollStats poll;
+    Radial_TakeLatencyStats(&latency);
+    Radial_TakePollStats(&poll);
+
+    vendorStatus = VENDOR_STATUS_OK;
+    vendorReceived = 0;
+    hostLost = 0;
+}
+
+/**
+ * @brief 设置配置 1，设备开始收发数据
+ */
+static void usb_configure() {
+    usb_control_out(USB_REQ_TYP_STANDARD, USB_SET_CONFIGURATION, 1, 0, 0,
+                    NULL);
+}
+
+/**
+ * @brief 读取配置描述符中 HID 端点的 bInterval 并设置配置 1
+ * @details 主机按不大于 bInterval 的 2 的幂帧轮询端点3
+ * @return 描述符中的 bInterval
+ */
+static uint8_t usb_enumerate() {
+    USB_Descriptor_Configuration_t config;
+    uint8_t interval;
+
+    usb_control_in(USB_REQ_TYP_STANDARD, USB_GET_DESCRIPTOR, 0x0200, 0,
+                   sizeof(config), (uint8_t *)&config);
+    interval = config.HID_ReportINEndpoint.PollingIntervalMS;
+
+    sim_poll_period = 1;
+    while ((uint8_t)(sim_poll_period << 1) <= interval) {
+        sim_poll_period <<= 1;
+    }
+    sim_poll_phase = (sim_frame + 3) & (sim_poll_period - 1);
+
+    usb_configure();
+    return interval;
+}
+
+#endif
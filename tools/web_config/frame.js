@@ -0,0 +1,223 @@
+/*
+  Radial Controller 二进制帧协议（COBS + CRC-16）主机端实现
+
+  帧格式见 README 的「二进制帧协议」一节，与固件 src/CdcRadial/USBFrame.c
+  的编解码一致。浏览器中以 <script src="frame.js"></script> 引入后使用全局
+  的 RadialFrame，Node.js 脚本中通过 require('./frame.js') 引入
+*/
+class RadialFrame {
+    static DELIMITER = 0x00;
+    static HEADER_SIZE = 2; // 序号 + 操作码
+    static CRC_SIZE = 2;
+    static PAYLOAD_MAX = 33; // 状态码 + 32 字节配置数据
+
+    // 操作码
+    static OP = {
+        PING: 0x01,
+        CONFIG_MODE: 0x02,
+        HEARTBEAT: 0x03,
+        LOAD_SETTINGS: 0x04,
+        SAVE_SETTINGS: 0x05,
+        RESET_SETTINGS: 0x06,
+        PREVIEW: 0x07,
+        COMMIT: 0x08,
+        REVERT: 0x09,
+        RESPONSE: 0x80,
+    };
+
+    // 应答状态码
+    static STATUS = {
+        OK: 0,
+        FAILED: 1,
+        BAD_OPCODE: 2,
+        BAD_LENGTH: 3,
+    };
+
+    /**
+     * 计算 CRC-16/CCITT-FALSE（多项式 0x1021，初值 0xFFFF）
+     * @param {Uint8Array|number[]} data 数据
+     * @returns {number} CRC 值
+     */
+    static crc16(data) {
+        let crc = 0xFFFF;
+
+        for (const byte of data) {
+            crc ^= byte << 8;
+
+            for (let bit = 0; bit < 8; bit++) {
+                crc = (crc & 0x8000) ? ((crc << 1) ^ 0x1021) : (crc << 1);
+                crc &= 0xFFFF;
+            }
+        }
+
+        return crc;
+    }
+
+    /**
+     * COBS 编码，结果不含分隔符
+     * @param {Uint8Array} data 原始数据
+     * @returns {Uint8Array} 编码数据
+     */
+    static cobs_encode(data) {
+        const out = new Uint8Array(data.length + Math.floor(data.length / 254) + 1);
+        let code_pos = 0;
+        let code = 1;
+        let n = 1;
+
+        for (const byte of data) {
+            if (byte === 0) {
+                out[code_pos] = code;
+                code_pos = n++;
+                code = 1;
+            } else {
+                out[n++] = byte;
+                code++;
+
+                // 254 字节不含 0x00 的数据块以 0xFF 结束，其后没有隐含的 0x00
+                if (code === 0xFF) {
+                    out[code_pos] = code;
+                    code_pos = n++;
+                    code = 1;
+                }
+            }
+        }
+
+        out[code_pos] = code;
+        return out.slice(0, n);
+    }
+
+    /**
+     * COBS 解码
+     * @param {Uint8Array} encoded 不含分隔符的编码数据
+     * @returns {Uint8Array|null} 原始数据，编码错误返回 null
+     */
+    static cobs_decode(encoded) {
+        const out = new Uint8Array(encoded.length);
+        let read = 0;
+        let write = 0;
+
+        while (read < encoded.length) {
+            const code = encoded[read++];
+
+            if (code === 0 || read + code - 1 > encoded.length) {
+                return null;
+            }
+
+            for (let i = 1; i < code; i++) {
+                out[write++] = encoded[read++];
+            }
+
+            if (code < 0xFF && read < encoded.length) {
+                out[write++] = 0;
+            }
+        }
+
+        return out.slice(0, write);
+    }
+
+    /**
+     * 编码一个请求帧
+     * @param {number} seq 序号（0-255），应答帧携带相同的序号
+     * @param {number} opcode 操作码
+     * @param {Uint8Array|number[]} data 数据
+     * @returns {Uint8Array} 含首尾分隔符的帧
+     */
+    static encode(seq, opcode, data = []) {
+        const frame = new Uint8Array(RadialFrame.HEADER_SIZE + data.length +
+                                     RadialFrame.CRC_SIZE);
+
+        frame[0] = seq & 0xFF;
+        frame[1] = opcode & 0xFF;
+        frame.set(data, RadialFrame.HEADER_SIZE);
+
+        const crc_pos = frame.length - RadialFrame.CRC_SIZE;
+        const crc = RadialFrame.crc16(frame.subarray(0, crc_pos));
+        frame[crc_pos] = crc & 0xFF;
+        frame[crc_pos + 1] = crc >> 8;
+
+        const encoded = RadialFrame.cobs_encode(frame);
+        const out = new Uint8Array(encoded.length + 2);
+        out[0] = RadialFrame.DELIMITER;
+        out.set(encoded, 1);
+        out[out.length - 1] = RadialFrame.DELIMITER;
+        return out;
+    }
+
+    /**
+     * 解码一帧并校验 CRC
+     * @param {Uint8Array} encoded 不含分隔符的编码数据
+     * @returns {{seq: number, opcode: number, data: Uint8Array}|null}
+     *          应答帧的 data 以状态码开头，编码或校验错误返回 null
+     */
+    static decode(encoded) {
+        const frame = RadialFrame.cobs_decode(encoded);
+
+        if (frame === null ||
+            frame.length < RadialFrame.HEADER_SIZE + RadialFrame.CRC_SIZE) {
+            return null;
+        }
+
+        const crc_pos = frame.length - RadialFrame.CRC_SIZE;
+        const crc = frame[crc_pos] | (frame[crc_pos + 1] << 8);
+        if (RadialFrame.crc16(frame.subarray(0, crc_pos)) !== crc) {
+            return null;
+        }
+
+        return {
+            seq: frame[0],
+            opcode: frame[1],
+            data: frame.slice(RadialFrame.HEADER_SIZE, crc_pos),
+        };
+    }
+}
+
+/**
+ * 从串口数据流中分离 ASCII 文本行与二进制帧
+ * @details 设备的 ASCII 应答与帧应答可能交错到达，同一帧也可能跨越多次读取；
+ *          帧以 0x00 开始和结束，分隔符之外的字节按换行符切分为文本行
+ */
+RadialFrame.Reader = class {
+    constructor() {
+        this.in_frame = false;
+        this.frame_bytes = [];
+        this.line_bytes = [];
+    }
+
+    /**
+     * 追加读取到的数据
+     * @param {Uint8Array} chunk 串口数据
+     * @returns {Array<{type: string}>} 依次为 {type: 'line', text} 或
+     *          {type: 'frame', frame}，CRC 错误的帧为 {type: 'error'}
+     */
+    push(chunk) {
+        const results = [];
+
+        for (const byte of chunk) {
+            if (byte === RadialFrame.DELIMITER) {
+                // 与固件相同，连续的分隔符视为空帧，继续等待帧数据
+                if (!this.in_frame) {
+                    this.in_frame = true;
+                } else if (this.frame_bytes.length > 0) {
+                    const frame = RadialFrame.decode(Uint8Array.from(this.frame_bytes));
+                    results.push(frame ? { type: 'frame', frame } : { type: 'error' });
+                    this.in_frame = false;
+                    this.frame_bytes = [];
+                }
+            } else if (this.in_frame) {
+                this.frame_bytes.push(byte);
+            } else if (byte === 0x0A) {
+                const text = String.fromCharCode(...this.line_bytes).replace(/\r$/, '');
+                results.push({ type: 'line', text });
+                this.line_bytes = [];
+            } else {
+                this.line_bytes.push(byte);
+            }
+        }
+
+        return results;
+    }
+};
+
+if (typeof module !== 'undefined' && module.exports) {
+    module.exports = RadialFrame;
+}
@@ -12,7 +12,6 @@ class SerialAssistant {
             CLICK: 'click',
             ROTATE_LEFT: 'rotate_left',
             ROTATE_RIGHT: 'rotate_right',
-            HEARTBEAT: 'heartbeat',
         };
 
         // 命令响应常量
@@ -36,10 +35,11 @@ class SerialAssistant {
         this.received_buffer = new Uint8Array(0);
         this.data_received_resolver = null;
 
-        // 心跳包相关设置
-        this.HEARTBEAT_INTERVAL = 2000; // 心跳发送间隔（2秒）
-        this.heartbeat_timer = null; // 心跳定时器
-        this.last_heartbeat_time = Date.now();
+        // 设备命令依次执行，前一条命令收到应答或超时后才发送下一条
+        this.command_lock = Promise.resolve();
+
+        // 参数设置中暂不由本工具编辑的字段（16-31字节），保存时原样写回
+        this.config_reserved = new Uint8Array(16);
 
         // 参数设置常量
         this.CONFIG_PARAM_CONSTANTS = {
@@ -75,7 +75,11 @@ class SerialAssistant {
             // 旋转触发次数配置
             STEP_PER_TEETH_1X: 1,
             STEP_PER_TEETH_2X: 2,
+            STEP_PER_TEETH_4X: 4,
             STEP_PER_TEETH_DEFAULT: 2,
+
+            // HID 端点轮询间隔配置
+            HID_POLL_INTERVAL_DEFAULT: 10,
         };
 
         // 设置参数
@@ -132,7 +136,8 @@ class SerialAssistant {
                 label: '每转动一齿触发动作次数', type: 'select',
                 options: [
                     { value: this.CONFIG_PARAM_CONSTANTS.STEP_PER_TEETH_1X, label: '1' },
-                    { value: this.CONFIG_PARAM_CONSTANTS.STEP_PER_TEETH_2X, label: '2 (默认)' }],
+                    { value: this.CONFIG_PARAM_CONSTANTS.STEP_PER_TEETH_2X, label: '2 (默认)' },
+                    { value: this.CONFIG_PARAM_CONSTANTS.STEP_PER_TEETH_4X, label: '4' }],
                 value: this.CONFIG_PARAM_CONSTANTS.STEP_PER_TEETH_DEFAULT
             },
             phase: {
@@ -142,6 +147,16 @@ class SerialAssistant {
                     { value: 1, label: '反向脉冲' }],
                 value: 0
             },
+            hid_poll_interval: {
+                label: 'USB 轮询间隔 (毫秒，重新连接后生效)', type: 'select',
+                options: [
+                    { value: 1, label: '1' },
+                    { value: 2, label: '2' },
+                    { value: 4, label: '4' },
+                    { value: 8, label: '8' },
+                    { value: 10, label: '10 (默认)' }],
+                value: this.CONFIG_PARAM_CONSTANTS.HID_POLL_INTERVAL_DEFAULT
+            },
         };
 
         this.init_static_elements();
@@ -152,7 +167,7 @@ class SerialAssistant {
 
     /**
      * 清除定时器
-     * 用于清除连接检查定时器、等待数据定时器和心跳定时器
+     * 用于清除连接检查定时器和等待数据定时器
      */
     clear_timer() {
         if (this.connection_check_timer) {
@@ -164,11 +179,6 @@ class SerialAssistant {
             clearTimeout(this.wait_for_data_timer);
             this.wait_for_data_timer = null;
         }
-
-        if (this.heartbeat_timer) {
-            clearInterval(this.heartbeat_timer);
-            this.heartbeat_timer = null;
-        }
     }
 
 
@@ -296,12 +306,18 @@ class SerialAssistant {
                 // 更新参数值
                 this.config_params[paramKey].value = value;
             });
+
+            // 松开滑块后发送到设备实时预览
+            input.addEventListener('change', () => {
+                this.config_set_parameter(paramKey, this.config_params[paramKey].value);
+            });
         }
 
         // Select下拉框实时更新
         if (param.type === 'select') {
             input.addEventListener('change', (e) => {
                 this.config_params[paramKey].value = parseInt(e.target.value);
+                this.config_set_parameter(paramKey, this.config_params[paramKey].value);
             });
         }
 
@@ -329,6 +345,7 @@ class SerialAssistant {
 
                 // 更新参数值
                 this.config_params[paramKey].value = value;
+                this.config_set_parameter(paramKey, value);
             }
         });
 
@@ -347,7 +364,7 @@ class SerialAssistant {
 
         // 分组定义参数
         const ledParams = ['led_count', 'brightness', 'color_order', 'effect_mode', 'rotate_interval', 'fade_duration'];
-        const encoderParams = ['rotate_cw', 'rotate_ccw', 'step_per_teeth', 'phase'];
+        const encoderParams = ['rotate_cw', 'rotate_ccw', 'step_per_teeth', 'phase', 'hid_poll_interval'];
 
         // 创建LED相关参数容器
         const ledContainer = document.createElement('div');
@@ -417,6 +434,9 @@ class SerialAssistant {
             await port.open(serial_config);
             this.port = port;
 
+            // 设备以 DTR 判断配置工具是否在线，关闭串口后立即退出参数设置模式，无需心跳
+            await port.setSignals({ dataTerminalReady: true });
+
             this.show_status(`串口连接成功 (${serial_config.baudRate} bps, ${serial_config.dataBits}N${serial_config.stopBits}, ${serial_config.parity})`, 'success');
 
             // 开始接收数据
@@ -508,19 +528,40 @@ class SerialAssistant {
         return this.writer;
     }
 
+    /**
+     * 获取设备命令锁，避免并发的命令取走彼此的应答
+     * @returns {Promise<Function>} 释放锁的函数，命令完成后必须调用
+     */
+    async serial_acquire_command_lock() {
+        const previous = this.command_lock;
+        let release;
+
+        this.command_lock = new Promise((resolve) => release = resolve);
+        await previous;
+
+        return release;
+    }
+
     /**
      * 等待接收数据
      * @param {number} timeout - 超时时间（毫秒）
-     * @param {Array<string>} allowed_responses - 允许的响应类型数组，如果未提供则接收所有响应
+     * @param {Array<string>|Function} allowed_responses - 允许的响应类型数组或判断函数，如果未提供则接收所有响应
      * @returns {Promise<string>} 接收到的数据
      */
     serial_wait_for_data(timeout = 500, allowed_responses = null) {
         return new Promise((resolve, reject) => {
             const original_resolver = this.data_received_resolver;
+            const is_allowed = (data) => {
+                if (!allowed_responses) return true;
+                if (typeof allowed_responses === 'function') return allowed_responses(data);
+                return allowed_responses.includes(data);
+            };
 
             this.data_received_resolver = (data) => {
                 // 如果没有指定允许的响应类型，或者接收到的响应在允许列表中，则返回该响应
-                if (!allowed_responses || allowed_responses.includes(data)) {
+                if (is_allowed(data)) {
+                    clearTimeout(this.wait_for_data_timer);
+                    this.wait_for_data_timer = null;
                     this.data_received_resolver = original_resolver;
                     resolve(data);
                 } else {
@@ -706,8 +747,11 @@ class SerialAssistant {
             rotate_ccw: view.getInt16(12, true),
             step_per_teeth: view.getUint8(14),
             phase: view.getUint8(15),
-            // reserved字段从16-31，共16字节，暂不处理
+            // 旧版本固件中该字节为 0，表示使用固件默认值
+            hid_poll_interval: view.getUint8(20) || this.CONFIG_PARAM_CONSTANTS.HID_POLL_INTERVAL_DEFAULT,
+            // 16-31字节中的其余字段（加速度曲线等）暂不处理，保存时原样写回
         };
+        this.config_reserved = data.slice(16, 32);
 
         // 更新参数设置
         for (const key in config) {
@@ -740,6 +784,7 @@ class SerialAssistant {
         this.update_config_controls('rotate_ccw', this.config_params.rotate_ccw.value);
         this.update_config_controls('step_per_teeth', this.config_params.step_per_teeth.value);
         this.update_config_controls('phase', this.config_params.phase.value);
+        this.update_config_controls('hid_poll_interval', this.config_params.hid_poll_interval.value);
 
         // 显示固件版本
         if (this.firmware_version) {
@@ -836,6 +881,8 @@ class SerialAssistant {
      * 启用参数设置模式
      */
     async config_enable_config_mode() {
+        const release = await this.serial_acquire_command_lock();
+
         try {
             this.show_status('正在启用参数设置模式...');
 
@@ -849,12 +896,6 @@ class SerialAssistant {
             if (response === this.RESPONSES.CONFIG_MODE_ENABLED_SUCCESS) {
                 this.is_connected = true;
                 this.show_status('参数设置模式已成功启用', 'success');
-
-                // 启动心跳定时器，每2秒发送一次心跳包
-                this.heartbeat_timer = setInterval(() => this.config_send_heartbeat(), this.HEARTBEAT_INTERVAL);
-
-                // 立即发送第一个心跳包
-                await this.config_send_heartbeat();
             } else {
                 throw new Error(`意外响应: ${response}`);
             }
@@ -862,6 +903,7 @@ class SerialAssistant {
             this.show_status(`启用参数设置模式失败: ${error.message}`, 'error');
         } finally {
             this.writer = this.serial_release_resource(this.writer);
+            release();
         }
     }
 
@@ -869,6 +911,8 @@ class SerialAssistant {
      * 加载参数设置
      */
     async config_load_settings() {
+        const release = await this.serial_acquire_command_lock();
+
         try {
             this.show_status('正在加载参数设置...');
 
@@ -888,6 +932,7 @@ class SerialAssistant {
             this.show_status(`加载参数设置失败: ${error.message}`, 'error');
         } finally {
             this.writer = this.serial_release_resource(this.writer);
+            release();
         }
     }
 
@@ -924,12 +969,14 @@ class SerialAssistant {
      * 保存参数设置
      */
     async config_save_settings() {
-        try {
-            // 保存前先验证所有参数
-            if (!this.__config_validate_all_params()) {
-                return; // 参数无效，不执行保存操作
-            }
+        // 保存前先验证所有参数
+        if (!this.__config_validate_all_params()) {
+            return; // 参数无效，不执行保存操作
+        }
 
+        const release = await this.serial_acquire_command_lock();
+
+        try {
             const writer = this.serial_get_writer();
 
             // 创建参数设置数据缓冲区（共30字节，不含version和revision）
@@ -973,12 +1020,15 @@ class SerialAssistant {
             // phase (1字节)
             view.setUint8(offset++, this.config_params.phase.value);
 
-            // reserved字段：使用缓冲区剩余的大小填充
+            // 16-31字节：原样写回设备中读取的数据
             const reserved_size = buffer.byteLength - offset;
             for (let i = 0; i < reserved_size; i++) {
-                view.setUint8(offset + i, 0);
+                view.setUint8(offset + i, this.config_reserved[i] || 0);
             }
 
+            // hid_poll_interval (第20字节，位于缓冲区偏移 18)
+            view.setUint8(20 - 2, this.config_params.hid_poll_interval.value);
+
             // 构建完整命令："save_settings=" + 30字节二进制数据 + "\n"
             const command_prefix = this.COMMANDS.SAVE_SETTINGS + '=';
             const newline_buffer = new TextEncoder().encode('\n');
@@ -1009,6 +1059,7 @@ class SerialAssistant {
             this.show_status(`保存设置失败: ${error.message}`, 'error');
         } finally {
             this.writer = this.serial_release_resource(this.writer);
+            release();
         }
     }
 
@@ -1016,6 +1067,9 @@ class SerialAssistant {
      * 恢复默认参数设置
      */
     async config_reset_settings() {
+        const release = await this.serial_acquire_command_lock();
+        let reload = false;
+
         try {
             this.show_status('正在重置参数设置...');
 
@@ -1029,9 +1083,7 @@ class SerialAssistant {
             if (response === this.RESPONSES.RESET_SETTINGS_SUCCESS) {
                 this.show_status('参数设置已重置为默认值', 'success');
                 this.show_custom_alert('重置设置成功', "参数设置已重置为默认值");
-
-                // 加载参数设置
-                await this.config_load_settings();
+                reload = true;
             } else {
                 throw new Error(`意外响应: ${response}`);
             }
@@ -1039,30 +1091,48 @@ class SerialAssistant {
             this.show_status(`重置参数设置失败: ${error.message}`, 'error');
         } finally {
             this.writer = this.serial_release_resource(this.writer);
+            release();
+        }
+
+        // 释放命令锁后再加载参数设置
+        if (reload) {
+            await this.config_load_settings();
         }
     }
 
     /**
-     * 发送心跳请求
+     * 设置单项参数，设备立即应用并在无新修改一段时间后自动保存
+     * 设备以 "<参数名>=<当前值>" 应答，由数据处理流程更新对应控件；
+     * 等待该应答后才释放命令锁，避免应答被其他命令的等待流程取走
+     * @param {string} key - 参数键名
+     * @param {number} value - 参数值
      */
-    async config_send_heartbeat() {
-        try {
-            if (!this.is_connected) return;
+    async config_set_parameter(key, value) {
+        if (!this.is_connected) return;
 
-            // 发送心跳请求
+        const release = await this.serial_acquire_command_lock();
+        const failed_response = `${this.COMMANDS.SET_PREFIX}${key}_failed`;
+
+        try {
             const writer = this.serial_get_writer();
-            const command = this.COMMANDS.HEARTBEAT + '\n';
+            const command = `${this.COMMANDS.SET_PREFIX}${key}=${value}\n`;
             const buffer = new TextEncoder().encode(command);
             await writer.write(buffer);
 
-            // 更新心跳状态
-            this.last_heartbeat_time = Date.now();
+            const response = await this.serial_wait_for_data(500,
+                (data) => data.startsWith(`${key}=`) || data === failed_response);
+
+            if (response === failed_response) {
+                throw new Error(`设备拒绝参数 ${key}=${value}`);
+            }
         } catch (error) {
-            this.show_status(`发送心跳请求失败: ${error.message}`, 'error');
+            this.show_status(`设置参数失败: ${error.message}`, 'error');
         } finally {
             this.writer = this.serial_release_resource(this.writer);
+            release();
         }
     }
+
     // #endregion 设备参数设置相关方法
 
 